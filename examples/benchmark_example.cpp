@@ -15,6 +15,10 @@
  *
  * All leaf nodes perform trivial work (increment counter) to measure
  * pure framework overhead. Results in nanoseconds per tick.
+ *
+ * Built three times to compare callback modes: bt_benchmark
+ * (std::function), bt_benchmark_inplace (bt::InplaceFunction) and
+ * bt_benchmark_fnptr (raw function pointers).
  */
 
 #include <bt/behavior_tree.hpp>
@@ -30,6 +34,14 @@
 // Context and helpers
 // ============================================================================
 
+#if defined(BT_USE_STD_FUNCTION)
+static const char* const kCallbackMode = "std::function";
+#elif defined(BT_USE_INPLACE_FUNCTION)
+static const char* const kCallbackMode = "bt::InplaceFunction";
+#else
+static const char* const kCallbackMode = "function pointer";
+#endif
+
 struct BenchContext {
   uint32_t counter = 0;
   bool condition_result = true;
@@ -320,6 +332,7 @@ int main() {
   std::printf("============================================================\n");
   std::printf("  Iterations: 100,000 per benchmark (+ 1,000 warmup)\n");
   std::printf("  Leaf work: trivial (counter increment)\n");
+  std::printf("  Callback mode: %s\n", kCallbackMode);
   std::printf("  Purpose: isolate BT framework cost from application logic\n");
   std::printf("------------------------------------------------------------\n");
 
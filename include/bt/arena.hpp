@@ -0,0 +1,127 @@
+/**
+ * @file arena.hpp
+ * @brief Fixed-buffer node arena for data-driven tree construction.
+ *
+ * Nodes are non-copyable and non-movable, so trees built at runtime need
+ * stable storage. NodeArena placement-constructs nodes into one caller
+ * supplied buffer with no heap allocation:
+ *
+ *   [ Node 0 | Node 1 | ... | Node n-1 ->      free      <- strings ]
+ *
+ * Nodes grow from the front as one contiguous array (construction order,
+ * i.e. pre-order for the loaders), and node names grow from the back. The
+ * arena owns the nodes: Clear() and the destructor run ~Node() for every
+ * node, which matters when callbacks are std::function.
+ */
+
+#ifndef BT_ARENA_HPP_
+#define BT_ARENA_HPP_
+
+#include "behavior_tree.hpp"
+
+namespace bt {
+
+/**
+ * @brief Bump arena of Node<Context> plus a string pool.
+ * @tparam Context User-defined context type.
+ * @tparam Observer Observer policy of the nodes.
+ */
+template <typename Context, typename Observer = NullObserver>
+class NodeArena final {
+ public:
+  using NodeT = Node<Context, Observer>;
+
+  /**
+   * @brief Construct an arena over a caller-owned buffer.
+   * @param buffer Storage (must outlive the arena and every node in it).
+   * @param bytes Buffer size in bytes.
+   */
+  NodeArena(void* buffer, size_t bytes) noexcept
+      : begin_(nullptr), end_(nullptr), node_end_(nullptr),
+        string_top_(nullptr), node_count_(0) {
+    unsigned char* raw = static_cast<unsigned char*>(buffer);
+    end_ = raw + bytes;
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t mask = static_cast<uintptr_t>(alignof(NodeT) - 1U);
+    const uintptr_t aligned = (addr + mask) & ~mask;
+    begin_ = (aligned <= reinterpret_cast<uintptr_t>(end_))
+                 ? reinterpret_cast<unsigned char*>(aligned)
+                 : end_;
+    node_end_ = begin_;
+    string_top_ = end_;
+  }
+
+  ~NodeArena() { Clear(); }
+
+  NodeArena(const NodeArena&) = delete;
+  NodeArena& operator=(const NodeArena&) = delete;
+  NodeArena(NodeArena&&) = delete;
+  NodeArena& operator=(NodeArena&&) = delete;
+
+  /**
+   * @brief Construct a node in the arena.
+   * @param name Node name (must outlive the node; see StoreString()).
+   * @return New node, or nullptr if the arena is exhausted.
+   */
+  NodeT* Create(const char* name = "") noexcept {
+    if (free_bytes() < sizeof(NodeT)) {
+      return nullptr;
+    }
+    NodeT* node = ::new (static_cast<void*>(node_end_)) NodeT(name);
+    node_end_ += sizeof(NodeT);
+    ++node_count_;
+    return node;
+  }
+
+  /**
+   * @brief Copy a string into the arena's string pool (NUL-terminated).
+   * @param text Characters to copy (need not be NUL-terminated).
+   * @param length Number of characters.
+   * @return Pooled copy, or nullptr if the arena is exhausted.
+   */
+  const char* StoreString(const char* text, size_t length) noexcept {
+    if (free_bytes() < length + 1U) {
+      return nullptr;
+    }
+    string_top_ -= length + 1U;
+    char* out = reinterpret_cast<char*>(string_top_);
+    std::memcpy(out, text, length);
+    out[length] = '\0';
+    return out;
+  }
+
+  /** @brief Destroy all nodes and release all strings. */
+  void Clear() noexcept {
+    for (uint32_t i = node_count_; i > 0U; --i) {
+      node(i - 1U).~NodeT();
+    }
+    node_end_ = begin_;
+    string_top_ = end_;
+    node_count_ = 0;
+  }
+
+  /** @brief Node at construction index (0 = first created). */
+  NodeT& node(uint32_t index) noexcept {
+    assert(index < node_count_);
+    return reinterpret_cast<NodeT*>(begin_)[index];
+  }
+
+  /** @brief Number of live nodes. */
+  uint32_t node_count() const noexcept { return node_count_; }
+
+  /** @brief Bytes still available for nodes and strings. */
+  size_t free_bytes() const noexcept {
+    return static_cast<size_t>(string_top_ - node_end_);
+  }
+
+ private:
+  unsigned char* begin_;       // first node (aligned)
+  unsigned char* end_;         // one past the buffer
+  unsigned char* node_end_;    // one past the last node
+  unsigned char* string_top_;  // lowest pooled string
+  uint32_t node_count_;
+};
+
+}  // namespace bt
+
+#endif  // BT_ARENA_HPP_
@@ -0,0 +1,438 @@
+/**
+ * @file batch_condition.hpp
+ * @brief Declarative comparison conditions evaluated across agents with SIMD.
+ *
+ * Guard leaves such as `health < threshold` or `ammo == 0` are mostly a
+ * single comparison of one blackboard column against a constant. Written as
+ * a BatchCondition (field, op, constant) they can be evaluated for a whole
+ * 64-agent block at once instead of once per agent through a callback:
+ *
+ * - AVX2:  8 lanes per compare, 16 per loop iteration (-mavx2)
+ * - SSE2:  4 lanes per compare, 16 per loop iteration (x86-64 baseline)
+ * - NEON:  4 lanes per compare, 16 per loop iteration (AArch64)
+ * - Scalar fallback everywhere else, or with BT_BATCH_FORCE_SCALAR
+ *
+ * Each block yields a 64-bit success mask (bit i = agent i passed). Masks
+ * are stored in LaneMask columns of the SoA board, and per-agent trees
+ * consume them through the capture-free MaskCondition<> leaf.
+ *
+ * Floating-point semantics match the scalar C++ operators: every comparison
+ * with NaN is false except kNotEqual, which is true.
+ */
+
+#ifndef BT_BATCH_CONDITION_HPP_
+#define BT_BATCH_CONDITION_HPP_
+
+#include "blackboard.hpp"
+
+#if !defined(BT_BATCH_FORCE_SCALAR)
+#if defined(__AVX2__)
+#define BT_BATCH_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define BT_BATCH_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define BT_BATCH_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace bt {
+
+// ============================================================================
+// Condition descriptor
+// ============================================================================
+
+/** @brief Comparison operator of a BatchCondition (field OP constant). */
+enum class CompareOp : uint8_t {
+  kLess = 0,
+  kLessEqual,
+  kGreater,
+  kGreaterEqual,
+  kEqual,
+  kNotEqual
+};
+
+/** @brief Convert CompareOp to human-readable string. */
+inline constexpr const char* CompareOpToString(CompareOp op) noexcept {
+  return (op == CompareOp::kLess)         ? "<"
+       : (op == CompareOp::kLessEqual)    ? "<="
+       : (op == CompareOp::kGreater)      ? ">"
+       : (op == CompareOp::kGreaterEqual) ? ">="
+       : (op == CompareOp::kEqual)        ? "=="
+       : (op == CompareOp::kNotEqual)     ? "!="
+       : "?";
+}
+
+/** @brief Element type of the compared column. */
+enum class FieldType : uint8_t {
+  kFloat32 = 0,
+  kInt32
+};
+
+/**
+ * @brief Declarative guard: one column compared against a constant.
+ *
+ * `field` points at Column::data() and must stay valid while the condition
+ * is evaluated. Build with Compare().
+ */
+struct BatchCondition {
+  const void* field;  ///< Column data, padded to whole 64-agent blocks
+  FieldType type;     ///< Element type of field
+  CompareOp op;       ///< Comparison operator
+  float f32;          ///< Constant for kFloat32 fields
+  int32_t i32;        ///< Constant for kInt32 fields
+};
+
+/** @brief Build a float column condition: column OP value. */
+template <uint32_t N>
+BatchCondition Compare(const Column<float, N>& column, CompareOp op,
+                       float value) noexcept {
+  return BatchCondition{column.data(), FieldType::kFloat32, op, value, 0};
+}
+
+/** @brief Build an int32 column condition: column OP value. */
+template <uint32_t N>
+BatchCondition Compare(const Column<int32_t, N>& column, CompareOp op,
+                       int32_t value) noexcept {
+  return BatchCondition{column.data(), FieldType::kInt32, op, 0.0F, value};
+}
+
+/** @brief Name of the kernel family selected at compile time. */
+inline constexpr const char* BatchKernelName() noexcept {
+#if defined(BT_BATCH_AVX2)
+  return "AVX2";
+#elif defined(BT_BATCH_SSE2)
+  return "SSE2";
+#elif defined(BT_BATCH_NEON)
+  return "NEON";
+#else
+  return "scalar";
+#endif
+}
+
+// ============================================================================
+// Kernels (one 64-agent block -> 64-bit mask)
+// ============================================================================
+
+namespace detail {
+
+template <CompareOp kOp, typename T>
+BT_FORCE_INLINE bool CompareScalar(T a, T b) noexcept {
+  return (kOp == CompareOp::kLess)         ? (a < b)
+       : (kOp == CompareOp::kLessEqual)    ? (a <= b)
+       : (kOp == CompareOp::kGreater)      ? (a > b)
+       : (kOp == CompareOp::kGreaterEqual) ? (a >= b)
+       : (kOp == CompareOp::kEqual)        ? (a == b)
+       : (a != b);
+}
+
+/** @brief Portable kernel: 64 scalar compares. */
+template <CompareOp kOp, typename T>
+inline uint64_t CompareBlockScalar(const T* values, T constant) noexcept {
+  uint64_t mask = 0;
+  for (uint32_t i = 0; i < kLanesPerBlock; ++i) {
+    if (CompareScalar<kOp>(values[i], constant)) {
+      mask |= static_cast<uint64_t>(1) << i;
+    }
+  }
+  return mask;
+}
+
+#if defined(BT_BATCH_AVX2)
+
+template <CompareOp kOp>
+BT_FORCE_INLINE __m256 CmpF32(__m256 a, __m256 b) noexcept {
+  return (kOp == CompareOp::kLess)         ? _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+       : (kOp == CompareOp::kLessEqual)    ? _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+       : (kOp == CompareOp::kGreater)      ? _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+       : (kOp == CompareOp::kGreaterEqual) ? _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+       : (kOp == CompareOp::kEqual)        ? _mm256_cmp_ps(a, b, _CMP_EQ_OQ)
+       : _mm256_cmp_ps(a, b, _CMP_NEQ_UQ);
+}
+
+template <CompareOp kOp>
+BT_FORCE_INLINE uint32_t CmpI32Bits(__m256i a, __m256i b) noexcept {
+  // AVX2 has only GT and EQ; derive the rest (LE = !GT, GE = !LT, NE = !EQ)
+  const __m256i m = (kOp == CompareOp::kLess || kOp == CompareOp::kGreaterEqual)
+                        ? _mm256_cmpgt_epi32(b, a)
+                    : (kOp == CompareOp::kGreater || kOp == CompareOp::kLessEqual)
+                        ? _mm256_cmpgt_epi32(a, b)
+                        : _mm256_cmpeq_epi32(a, b);
+  const uint32_t bits = static_cast<uint32_t>(
+      _mm256_movemask_ps(_mm256_castsi256_ps(m)));
+  const bool negate = (kOp == CompareOp::kLessEqual) ||
+                      (kOp == CompareOp::kGreaterEqual) ||
+                      (kOp == CompareOp::kNotEqual);
+  return negate ? (~bits & 0xFFU) : bits;
+}
+
+template <CompareOp kOp>
+inline uint64_t CompareBlock(const float* values, float constant) noexcept {
+  const __m256 c = _mm256_set1_ps(constant);
+  uint64_t mask = 0;
+  for (uint32_t i = 0; i < kLanesPerBlock; i += 16U) {
+    const __m256 lo = CmpF32<kOp>(_mm256_load_ps(values + i), c);
+    const __m256 hi = CmpF32<kOp>(_mm256_load_ps(values + i + 8U), c);
+    const uint64_t bits =
+        static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_ps(lo))) |
+        (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_ps(hi)))
+         << 8U);
+    mask |= bits << i;
+  }
+  return mask;
+}
+
+template <CompareOp kOp>
+inline uint64_t CompareBlock(const int32_t* values, int32_t constant) noexcept {
+  const __m256i c = _mm256_set1_epi32(constant);
+  uint64_t mask = 0;
+  for (uint32_t i = 0; i < kLanesPerBlock; i += 16U) {
+    const __m256i lo = _mm256_load_si256(
+        reinterpret_cast<const __m256i*>(values + i));
+    const __m256i hi = _mm256_load_si256(
+        reinterpret_cast<const __m256i*>(values + i + 8U));
+    const uint64_t bits = static_cast<uint64_t>(CmpI32Bits<kOp>(lo, c)) |
+                          (static_cast<uint64_t>(CmpI32Bits<kOp>(hi, c)) << 8U);
+    mask |= bits << i;
+  }
+  return mask;
+}
+
+#elif defined(BT_BATCH_SSE2)
+
+template <CompareOp kOp>
+BT_FORCE_INLINE uint32_t CmpF32Bits(__m128 a, __m128 b) noexcept {
+  const __m128 m = (kOp == CompareOp::kLess)         ? _mm_cmplt_ps(a, b)
+                 : (kOp == CompareOp::kLessEqual)    ? _mm_cmple_ps(a, b)
+                 : (kOp == CompareOp::kGreater)      ? _mm_cmpgt_ps(a, b)
+                 : (kOp == CompareOp::kGreaterEqual) ? _mm_cmpge_ps(a, b)
+                 : (kOp == CompareOp::kEqual)        ? _mm_cmpeq_ps(a, b)
+                 : _mm_cmpneq_ps(a, b);
+  return static_cast<uint32_t>(_mm_movemask_ps(m));
+}
+
+template <CompareOp kOp>
+BT_FORCE_INLINE uint32_t CmpI32Bits(__m128i a, __m128i b) noexcept {
+  const __m128i m = (kOp == CompareOp::kLess || kOp == CompareOp::kGreaterEqual)
+                        ? _mm_cmplt_epi32(a, b)
+                    : (kOp == CompareOp::kGreater || kOp == CompareOp::kLessEqual)
+                        ? _mm_cmpgt_epi32(a, b)
+                        : _mm_cmpeq_epi32(a, b);
+  const uint32_t bits =
+      static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(m)));
+  const bool negate = (kOp == CompareOp::kLessEqual) ||
+                      (kOp == CompareOp::kGreaterEqual) ||
+                      (kOp == CompareOp::kNotEqual);
+  return negate ? (~bits & 0xFU) : bits;
+}
+
+template <CompareOp kOp>
+inline uint64_t CompareBlock(const float* values, float constant) noexcept {
+  const __m128 c = _mm_set1_ps(constant);
+  uint64_t mask = 0;
+  for (uint32_t i = 0; i < kLanesPerBlock; i += 16U) {
+    const uint64_t bits =
+        static_cast<uint64_t>(CmpF32Bits<kOp>(_mm_load_ps(values + i), c)) |
+        (static_cast<uint64_t>(CmpF32Bits<kOp>(_mm_load_ps(values + i + 4U), c))
+         << 4U) |
+        (static_cast<uint64_t>(CmpF32Bits<kOp>(_mm_load_ps(values + i + 8U), c))
+         << 8U) |
+        (static_cast<uint64_t>(CmpF32Bits<kOp>(_mm_load_ps(values + i + 12U), c))
+         << 12U);
+    mask |= bits << i;
+  }
+  return mask;
+}
+
+template <CompareOp kOp>
+inline uint64_t CompareBlock(const int32_t* values, int32_t constant) noexcept {
+  const __m128i c = _mm_set1_epi32(constant);
+  const __m128i* v = reinterpret_cast<const __m128i*>(values);
+  uint64_t mask = 0;
+  for (uint32_t i = 0; i < kLanesPerBlock; i += 16U, v += 4) {
+    const uint64_t bits =
+        static_cast<uint64_t>(CmpI32Bits<kOp>(_mm_load_si128(v), c)) |
+        (static_cast<uint64_t>(CmpI32Bits<kOp>(_mm_load_si128(v + 1), c))
+         << 4U) |
+        (static_cast<uint64_t>(CmpI32Bits<kOp>(_mm_load_si128(v + 2), c))
+         << 8U) |
+        (static_cast<uint64_t>(CmpI32Bits<kOp>(_mm_load_si128(v + 3), c))
+         << 12U);
+    mask |= bits << i;
+  }
+  return mask;
+}
+
+#elif defined(BT_BATCH_NEON)
+
+BT_FORCE_INLINE uint32_t MoveMask(uint32x4_t m) noexcept {
+  static const uint32_t kWeights[4] = {1U, 2U, 4U, 8U};
+  return vaddvq_u32(vandq_u32(m, vld1q_u32(kWeights)));
+}
+
+template <CompareOp kOp>
+BT_FORCE_INLINE uint32_t CmpF32Bits(float32x4_t a, float32x4_t b) noexcept {
+  const uint32x4_t m = (kOp == CompareOp::kLess)         ? vcltq_f32(a, b)
+                     : (kOp == CompareOp::kLessEqual)    ? vcleq_f32(a, b)
+                     : (kOp == CompareOp::kGreater)      ? vcgtq_f32(a, b)
+                     : (kOp == CompareOp::kGreaterEqual) ? vcgeq_f32(a, b)
+                     : (kOp == CompareOp::kEqual)        ? vceqq_f32(a, b)
+                     : vmvnq_u32(vceqq_f32(a, b));
+  return MoveMask(m);
+}
+
+template <CompareOp kOp>
+BT_FORCE_INLINE uint32_t CmpI32Bits(int32x4_t a, int32x4_t b) noexcept {
+  const uint32x4_t m = (kOp == CompareOp::kLess)         ? vcltq_s32(a, b)
+                     : (kOp == CompareOp::kLessEqual)    ? vcleq_s32(a, b)
+                     : (kOp == CompareOp::kGreater)      ? vcgtq_s32(a, b)
+                     : (kOp == CompareOp::kGreaterEqual) ? vcgeq_s32(a, b)
+                     : (kOp == CompareOp::kEqual)        ? vceqq_s32(a, b)
+                     : vmvnq_u32(vceqq_s32(a, b));
+  return MoveMask(m);
+}
+
+template <CompareOp kOp>
+inline uint64_t CompareBlock(const float* values, float constant) noexcept {
+  const float32x4_t c = vdupq_n_f32(constant);
+  uint64_t mask = 0;
+  for (uint32_t i = 0; i < kLanesPerBlock; i += 16U) {
+    const uint64_t bits =
+        static_cast<uint64_t>(CmpF32Bits<kOp>(vld1q_f32(values + i), c)) |
+        (static_cast<uint64_t>(CmpF32Bits<kOp>(vld1q_f32(values + i + 4U), c))
+         << 4U) |
+        (static_cast<uint64_t>(CmpF32Bits<kOp>(vld1q_f32(values + i + 8U), c))
+         << 8U) |
+        (static_cast<uint64_t>(CmpF32Bits<kOp>(vld1q_f32(values + i + 12U), c))
+         << 12U);
+    mask |= bits << i;
+  }
+  return mask;
+}
+
+template <CompareOp kOp>
+inline uint64_t CompareBlock(const int32_t* values, int32_t constant) noexcept {
+  const int32x4_t c = vdupq_n_s32(constant);
+  uint64_t mask = 0;
+  for (uint32_t i = 0; i < kLanesPerBlock; i += 16U) {
+    const uint64_t bits =
+        static_cast<uint64_t>(CmpI32Bits<kOp>(vld1q_s32(values + i), c)) |
+        (static_cast<uint64_t>(CmpI32Bits<kOp>(vld1q_s32(values + i + 4U), c))
+         << 4U) |
+        (static_cast<uint64_t>(CmpI32Bits<kOp>(vld1q_s32(values + i + 8U), c))
+         << 8U) |
+        (static_cast<uint64_t>(CmpI32Bits<kOp>(vld1q_s32(values + i + 12U), c))
+         << 12U);
+    mask |= bits << i;
+  }
+  return mask;
+}
+
+#else
+
+template <CompareOp kOp, typename T>
+inline uint64_t CompareBlock(const T* values, T constant) noexcept {
+  return CompareBlockScalar<kOp>(values, constant);
+}
+
+#endif
+
+/** @brief Dispatch on op once per block, then run the typed kernel. */
+template <typename T>
+inline uint64_t CompareBlockAny(const T* values, CompareOp op,
+                                T constant) noexcept {
+  switch (op) {
+    case CompareOp::kLess:
+      return CompareBlock<CompareOp::kLess>(values, constant);
+    case CompareOp::kLessEqual:
+      return CompareBlock<CompareOp::kLessEqual>(values, constant);
+    case CompareOp::kGreater:
+      return CompareBlock<CompareOp::kGreater>(values, constant);
+    case CompareOp::kGreaterEqual:
+      return CompareBlock<CompareOp::kGreaterEqual>(values, constant);
+    case CompareOp::kEqual:
+      return CompareBlock<CompareOp::kEqual>(values, constant);
+    case CompareOp::kNotEqual:
+      return CompareBlock<CompareOp::kNotEqual>(values, constant);
+    default:
+      return 0U;
+  }
+}
+
+}  // namespace detail
+
+// ============================================================================
+// Evaluation API
+// ============================================================================
+
+/**
+ * @brief Evaluate a condition for one 64-agent block.
+ * @param cond Condition descriptor.
+ * @param block Block index (agents [block*64, block*64+64)).
+ * @return Success mask; bit i belongs to agent block*64+i.
+ *
+ * Padding lanes past the column capacity compare the zero padding and
+ * must be masked by the caller (EvaluateBatch() does this).
+ */
+inline uint64_t EvaluateBlock(const BatchCondition& cond,
+                              uint32_t block) noexcept {
+  const uint32_t offset = block * kLanesPerBlock;
+  if (cond.type == FieldType::kFloat32) {
+    return detail::CompareBlockAny(
+        static_cast<const float*>(cond.field) + offset, cond.op, cond.f32);
+  }
+  return detail::CompareBlockAny(
+      static_cast<const int32_t*>(cond.field) + offset, cond.op, cond.i32);
+}
+
+/**
+ * @brief Evaluate a condition for agents [0, agent_count).
+ * @param cond Condition descriptor.
+ * @param agent_count Number of agents (<= column and mask capacity).
+ * @param out Receives one success bit per agent; lanes >= agent_count are 0.
+ * @return Number of agents that passed.
+ */
+template <uint32_t N>
+uint32_t EvaluateBatch(const BatchCondition& cond, uint32_t agent_count,
+                       LaneMask<N>& out) noexcept {
+  assert(agent_count <= N);
+  for (uint32_t w = 0; w < LaneWords(agent_count); ++w) {
+    out.words()[w] = EvaluateBlock(cond, w) & ValidLanes(agent_count, w);
+  }
+  return out.Count(agent_count);
+}
+
+// ============================================================================
+// Per-agent consumption
+// ============================================================================
+
+/** @brief Map one agent's mask bit to SUCCESS/FAILURE. */
+template <uint32_t N>
+BT_FORCE_INLINE Status LaneStatus(const LaneMask<N>& mask,
+                                  uint32_t agent) noexcept {
+  return mask.Test(agent) ? Status::kSuccess : Status::kFailure;
+}
+
+/**
+ * @brief Condition leaf reading a precomputed mask column of the board.
+ * @tparam Board SoA board type.
+ * @tparam N Mask capacity.
+ * @tparam kMask Board member holding the mask (e.g. &Crowd::low_health).
+ *
+ * A plain function, usable as TickFn in every callback mode:
+ * @code
+ *   bt::factory::MakeCondition(
+ *       node, bt::MaskCondition<Crowd, 1024, &Crowd::low_health>);
+ * @endcode
+ */
+template <typename Board, uint32_t N, LaneMask<N> Board::*kMask>
+Status MaskCondition(AgentContext<Board>& ctx) noexcept {
+  return LaneStatus(ctx.board->*kMask, ctx.agent);
+}
+
+}  // namespace bt
+
+#endif  // BT_BATCH_CONDITION_HPP_
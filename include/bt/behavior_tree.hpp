@@ -15,13 +15,42 @@
  * - BT_MAX_CHILDREN: Max children per node (default 8)
  * - BT_USE_STD_FUNCTION: Use std::function for callbacks (allows lambda
  *   captures). Default: raw function pointers (zero heap, deterministic
- *   latency). When using function pointers, put per-node state in Context.
+ *   latency). When using function pointers, put per-node state in the
+ *   node's inline NodeState block (see set_state_tick()) or in Context.
+ * - BT_USE_INPLACE_FUNCTION: Use bt::InplaceFunction for callbacks (allows
+ *   trivially copyable lambda captures up to BT_INPLACE_FUNCTION_SIZE
+ *   bytes, never allocates, single indirect call). Mutually exclusive with
+ *   BT_USE_STD_FUNCTION.
+ * - BT_INPLACE_FUNCTION_SIZE: Inline capture capacity of InplaceFunction
+ *   in bytes (default 32).
+ * - BT_NODE_STATE_SIZE: Bytes of inline per-node user state (default 0:
+ *   no NodeState and no stateful ticks). Any non-zero size is paid by
+ *   every node, composites included: 16 grows Node from 120 B / align 8
+ *   to 144 B / align 16 with function pointers (192 -> 240 B with
+ *   std::function).
+ * - BT_NODE_IDS: Give every node a 16-bit id (see AssignNodeIds()).
+ * - BT_TRACE: Compile in the per-tree TickTracer (implies BT_NODE_IDS).
+ *   Without it Node::Tick() carries no tracing code at all.
+ * - BT_PROFILE: Compile in the per-node TickProfiler (implies
+ *   BT_NODE_IDS). Without it Node::Tick() carries no profiling code.
+ * - BT_PROFILE_MAX_DEPTH: Nesting depth the profiler tracks exclusive
+ *   time for (default 32).
+ * - BT_STATS: Collect per-tree TickStats (depth, nodes and leaves per
+ *   tick, root results) in BehaviorTree::Tick().
+ * - BT_DEADLINE: Compile in the per-tree TickWatchdog (implies
+ *   BT_NODE_IDS): a tick budget checked at node boundaries, with an
+ *   overrun log, a callback and optional yield of the rest of the tick.
+ * - BT_COUNTERS: Compile in per-node result counters (NodeCounterBlock,
+ *   implies BT_NODE_IDS) readable from other threads.
+ * - BT_STATUS_STREAM: Compile in the per-tree StatusStream (implies
+ *   BT_NODE_IDS): status changes only, delta-encoded into a byte ring.
  *
  * C++14 features used:
  * - enum class for type-safe enumerations
  * - constexpr for compile-time constants and utility functions
  * - static_assert for compile-time validation
  * - Template parameter for type-safe context
+ * - Observer policy with static hooks (NullObserver compiles to nothing)
  * - decltype(auto), relaxed constexpr
  *
  * MISRA C++ Compliance:
@@ -41,7 +70,9 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -49,6 +80,38 @@
 #include <functional>
 #endif
 
+#if defined(BT_TRACE)
+#include <atomic>
+#include <chrono>
+#endif
+
+#if defined(BT_DEADLINE)
+#include <chrono>
+#endif
+
+#if defined(BT_COUNTERS) || defined(BT_STATUS_STREAM)
+#include <atomic>
+#endif
+
+#if defined(BT_PROFILE)
+#include <chrono>
+#if defined(__linux__)
+#include <time.h>
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define BT_PROFILE_HAS_TSC
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BT_PROFILE_HAS_TSC
+#endif
+#endif
+
+#if defined(BT_USE_STD_FUNCTION) && defined(BT_USE_INPLACE_FUNCTION)
+#error "BT_USE_STD_FUNCTION and BT_USE_INPLACE_FUNCTION are mutually exclusive"
+#endif
+
 // ============================================================================
 // Configuration
 // ============================================================================
@@ -58,6 +121,28 @@
 #define BT_MAX_CHILDREN 8
 #endif
 
+/** @brief Inline capture capacity of InplaceFunction in bytes. */
+#ifndef BT_INPLACE_FUNCTION_SIZE
+#define BT_INPLACE_FUNCTION_SIZE 32
+#endif
+
+/** @brief Inline per-node user state size in bytes (0 disables). */
+#ifndef BT_NODE_STATE_SIZE
+#define BT_NODE_STATE_SIZE 0
+#endif
+
+/** @brief Per-node ids, required by the tracing and counting modes. */
+#if (defined(BT_TRACE) || defined(BT_PROFILE) || defined(BT_DEADLINE) || \
+     defined(BT_COUNTERS) || defined(BT_STATUS_STREAM)) &&               \
+    !defined(BT_NODE_IDS)
+#define BT_NODE_IDS
+#endif
+
+/** @brief Nesting depth tracked by TickProfiler for exclusive time. */
+#ifndef BT_PROFILE_MAX_DEPTH
+#define BT_PROFILE_MAX_DEPTH 32
+#endif
+
 // ============================================================================
 // Compiler hints
 // ============================================================================
@@ -117,6 +202,8 @@ inline constexpr const char* StatusToString(Status s) noexcept {
  * - SELECTOR:  Composite: first successful child wins (OR logic)
  * - PARALLEL:  Composite: tick all children each frame (cooperative multitask)
  * - INVERTER:  Decorator: inverts child result (SUCCESS <-> FAILURE)
+ * - SUBTREE:   Decorator: child built on first entry by a SubtreeSource
+ *              (see lazy_subtree.hpp), result passed through
  */
 enum class NodeType : uint8_t {
   kAction = 0,
@@ -124,7 +211,8 @@ enum class NodeType : uint8_t {
   kSequence,
   kSelector,
   kParallel,
-  kInverter
+  kInverter,
+  kSubtree
 };
 
 /**
@@ -137,6 +225,7 @@ inline constexpr const char* NodeTypeToString(NodeType t) noexcept {
        : (t == NodeType::kSelector)  ? "SELECTOR"
        : (t == NodeType::kParallel)  ? "PARALLEL"
        : (t == NodeType::kInverter)  ? "INVERTER"
+       : (t == NodeType::kSubtree)   ? "SUBTREE"
        : "UNKNOWN";
 }
 
@@ -180,7 +269,8 @@ enum class ValidateError : uint8_t {
   kInverterNotOneChild,         ///< Inverter must have exactly 1 child
   kParallelExceedsBitmap,       ///< Parallel children > 32 (bitmap width)
   kChildrenExceedMax,           ///< Children count exceeds BT_MAX_CHILDREN
-  kNullChild                    ///< Null pointer in children array
+  kNullChild,                   ///< Null pointer in children array
+  kInvalidSubtree               ///< Subtree without source or with > 1 child
 };
 
 /** @brief Convert ValidateError to human-readable string. */
@@ -191,65 +281,1779 @@ inline constexpr const char* ValidateErrorToString(ValidateError e) noexcept {
        : (e == ValidateError::kParallelExceedsBitmap) ? "PARALLEL_EXCEEDS_BITMAP"
        : (e == ValidateError::kChildrenExceedMax)     ? "CHILDREN_EXCEED_MAX"
        : (e == ValidateError::kNullChild)             ? "NULL_CHILD"
+       : (e == ValidateError::kInvalidSubtree)       ? "INVALID_SUBTREE"
        : "UNKNOWN";
 }
 
 // ============================================================================
-// Forward declaration
+// InplaceFunction
 // ============================================================================
 
-template <typename Context>
-class BehaviorTree;
+template <typename Signature,
+          size_t Capacity = static_cast<size_t>(BT_INPLACE_FUNCTION_SIZE)>
+class InplaceFunction;
+
+/**
+ * @brief Fixed-capacity inline callable (allocation-free std::function).
+ * @tparam R Return type.
+ * @tparam Args Argument types.
+ * @tparam Capacity Inline storage for the callable's captures, in bytes.
+ *
+ * The callable is stored in an inline buffer; oversized captures are a
+ * compile error instead of a heap allocation. Only trivially copyable,
+ * trivially destructible callables are accepted, so the wrapper itself is
+ * trivially copyable (relocation is a memcpy) and needs no manager
+ * function: a call is exactly one indirect jump through invoke_.
+ *
+ * Capturing by reference or by value of trivial types satisfies these
+ * requirements; capturing std::string, std::shared_ptr etc. does not.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> final {
+  static_assert(Capacity >= sizeof(void*),
+                "InplaceFunction capacity must hold at least a pointer");
+
+ public:
+  /// Inline storage capacity in bytes.
+  static constexpr size_t kCapacity = Capacity;
+
+  InplaceFunction() noexcept : invoke_(nullptr), storage_{} {}
+
+  // NOLINTNEXTLINE(google-explicit-constructor): mirrors std::function
+  InplaceFunction(std::nullptr_t) noexcept : invoke_(nullptr), storage_{} {}
+
+  /**
+   * @brief Store a callable inline.
+   *
+   * Null function pointers produce an empty InplaceFunction.
+   */
+  template <typename F,
+            typename Fn = typename std::decay<F>::type,
+            typename = typename std::enable_if<
+                !std::is_same<Fn, InplaceFunction>::value>::type>
+  // NOLINTNEXTLINE(google-explicit-constructor): mirrors std::function
+  InplaceFunction(F&& fn) noexcept : invoke_(nullptr), storage_{} {
+    static_assert(sizeof(Fn) <= Capacity,
+                  "Callable captures exceed InplaceFunction capacity "
+                  "(raise BT_INPLACE_FUNCTION_SIZE)");
+    static_assert(alignof(Fn) <= alignof(Storage),
+                  "Callable alignment exceeds InplaceFunction storage");
+    static_assert(std::is_trivially_copyable<Fn>::value &&
+                      std::is_trivially_destructible<Fn>::value,
+                  "InplaceFunction requires a trivially copyable callable "
+                  "(capture by reference or trivial values only)");
+    if (IsNull(fn)) {
+      return;
+    }
+    ::new (static_cast<void*>(&storage_)) Fn(std::forward<F>(fn));
+    invoke_ = &Invoke<Fn>;
+  }
+
+  InplaceFunction(const InplaceFunction&) noexcept = default;
+  InplaceFunction& operator=(const InplaceFunction&) noexcept = default;
+
+  InplaceFunction& operator=(std::nullptr_t) noexcept {
+    invoke_ = nullptr;
+    return *this;
+  }
+
+  /** @brief Invoke the stored callable (must not be empty). */
+  R operator()(Args... args) const {
+    return invoke_(&storage_, std::forward<Args>(args)...);
+  }
+
+  /** @brief Check if a callable is stored. */
+  explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+  /** @brief Stored callable if it has type T, else nullptr (as std::function). */
+  template <typename T>
+  const T* target() const noexcept {
+    return (invoke_ == &Invoke<T>) ? reinterpret_cast<const T*>(&storage_)
+                                   : nullptr;
+  }
+
+  friend bool operator==(const InplaceFunction& f, std::nullptr_t) noexcept {
+    return f.invoke_ == nullptr;
+  }
+  friend bool operator==(std::nullptr_t, const InplaceFunction& f) noexcept {
+    return f.invoke_ == nullptr;
+  }
+  friend bool operator!=(const InplaceFunction& f, std::nullptr_t) noexcept {
+    return f.invoke_ != nullptr;
+  }
+  friend bool operator!=(std::nullptr_t, const InplaceFunction& f) noexcept {
+    return f.invoke_ != nullptr;
+  }
+
+ private:
+  /// Inline buffer aligned for any pointer or scalar capture.
+  union Storage {
+    void* ptr;
+    void (*fn)();
+    double d;
+    long long ll;
+    unsigned char bytes[Capacity];
+  };
+  using InvokeFn = R (*)(Storage*, Args&&...);
+
+  template <typename Fn>
+  static R Invoke(Storage* storage, Args&&... args) {
+    return (*reinterpret_cast<Fn*>(storage))(std::forward<Args>(args)...);
+  }
+
+  template <typename Fn>
+  static constexpr bool IsNull(const Fn& /*fn*/) noexcept {
+    return false;
+  }
+
+  template <typename Ret, typename... Params>
+  static constexpr bool IsNull(Ret (*fn)(Params...)) noexcept {
+    return fn == nullptr;
+  }
+
+  InvokeFn invoke_;
+  mutable Storage storage_;
+};
+
+// Out-of-line definition for ODR-uses under C++14 (redundant in C++17)
+template <typename R, typename... Args, size_t Capacity>
+constexpr size_t InplaceFunction<R(Args...), Capacity>::kCapacity;
 
 // ============================================================================
-// Node
+// NodeState
 // ============================================================================
 
+#if (BT_NODE_STATE_SIZE > 0)
+
 /**
- * @brief Behavior tree node template.
- * @tparam Context User-defined context type for type-safe shared data.
+ * @brief Fixed-size, aligned user-state block stored inline in each node.
  *
- * Nodes are configured using a fluent builder API. Each node has a type
- * that determines its tick behavior.
+ * Passed to stateful tick callbacks alongside Context&, giving leaves
+ * allocation-free private state that shares the node's cache lines instead
+ * of a side table in Context. The block is zero-filled on construction and
+ * on Node::Reset(); it otherwise persists across ticks.
  *
- * Children are stored in a fixed-capacity inline array (BT_MAX_CHILDREN).
- * This eliminates external array lifetime dependencies and prevents
- * out-of-bounds access.
+ * Stored types must be trivial (no constructor/destructor is ever run) and
+ * must fit the block; both are checked at compile time by as<T>().
+ */
+class NodeState final {
+ public:
+  /// Block capacity in bytes (compile-time configurable).
+  static constexpr size_t kSize = static_cast<size_t>(BT_NODE_STATE_SIZE);
+  /// Block alignment (suitable for any scalar type).
+  static constexpr size_t kAlign = alignof(std::max_align_t);
+
+  constexpr NodeState() noexcept : bytes_{} {}
+
+  NodeState(const NodeState&) = delete;
+  NodeState& operator=(const NodeState&) = delete;
+
+  /** @brief Typed view of the block. */
+  template <typename T>
+  T& as() noexcept {
+    static_assert(sizeof(T) <= kSize, "Type exceeds BT_NODE_STATE_SIZE");
+    static_assert(alignof(T) <= kAlign, "Type alignment exceeds NodeState");
+    static_assert(std::is_trivial<T>::value,
+                  "NodeState holds trivial types only (no ctor/dtor run)");
+    return *reinterpret_cast<T*>(bytes_);
+  }
+
+  /** @brief Typed const view of the block. */
+  template <typename T>
+  const T& as() const noexcept {
+    return const_cast<NodeState*>(this)->as<T>();
+  }
+
+  /** @brief Raw block address. */
+  void* data() noexcept { return bytes_; }
+
+  /** @brief Raw block address (const). */
+  const void* data() const noexcept { return bytes_; }
+
+  /** @brief Zero-fill the block. */
+  void Clear() noexcept { std::memset(bytes_, 0, kSize); }
+
+ private:
+  alignas(std::max_align_t) unsigned char bytes_[kSize];
+};
+
+#endif  // BT_NODE_STATE_SIZE > 0
+
+// ============================================================================
+// Tick Tracer
+// ============================================================================
+
+#if defined(BT_TRACE)
+
+/**
+ * @brief One Node::Tick() call (16 bytes).
  *
- * Callback type is configurable:
- * - Default: raw function pointers (zero heap, deterministic latency).
- *   Per-node state should be placed in Context.
- * - BT_USE_STD_FUNCTION: std::function (allows lambda captures at the
- *   cost of potential heap allocation).
+ * Events are recorded when a node's tick returns, so children precede
+ * their parent and the root's event closes each tree tick.
+ */
+struct TraceEvent {
+  uint64_t start_ns;     ///< Clock value when the tick was entered
+  uint32_t duration_ns;  ///< Inclusive tick time (saturates at ~4.29 s)
+  uint16_t node_id;      ///< Node::id() of the ticked node
+  Status from;           ///< Status before the tick
+  Status to;             ///< Status returned by the tick
+};
+
+static_assert(sizeof(TraceEvent) == 16U, "TraceEvent must stay 16 bytes");
+
+/**
+ * @brief Fixed-size single-producer / single-consumer ring of TraceEvents.
  *
- * Memory layout is optimized for cache efficiency:
- * hot data fields (type, status, child index) are placed first.
+ * The tick thread is the only producer: every Node::Tick() on a thread
+ * with an active tracer (see Scope, BehaviorTree::set_tracer()) appends
+ * one event. Another thread drains it with Drain(). Neither side locks or
+ * allocates. When the ring is full, new events are dropped and counted
+ * rather than overwriting events the consumer may be copying.
+ *
+ * Recording costs two clock reads and one 16-byte store per node.
  */
-template <typename Context>
-class Node final {
-  static_assert(!std::is_pointer<Context>::value,
-                "Context must not be a pointer type; use the pointed-to type");
+class TickTracer final {
+ public:
+  /// Time source in nanoseconds (monotonic).
+  using ClockFn = uint64_t (*)();
+
+  /**
+   * @brief Construct over caller-owned storage.
+   * @param buffer Event storage (must outlive the tracer).
+   * @param capacity Events in @p buffer; rounded down to a power of two.
+   * @param clock Time source (default: std::chrono::steady_clock).
+   */
+  TickTracer(TraceEvent* buffer, uint32_t capacity,
+             ClockFn clock = &SteadyClockNs) noexcept
+      : buffer_(buffer), capacity_(0), clock_(clock), head_(0),
+        cached_tail_(0), dropped_(0), pad_head_{}, tail_(0), pad_tail_{} {
+    if ((buffer != nullptr) && (capacity > 0U)) {
+      capacity_ = 1U;
+      while (capacity_ <= (capacity >> 1U)) {
+        capacity_ <<= 1U;
+      }
+    }
+  }
+
+  TickTracer(const TickTracer&) = delete;
+  TickTracer& operator=(const TickTracer&) = delete;
+  TickTracer(TickTracer&&) = delete;
+  TickTracer& operator=(TickTracer&&) = delete;
+
+  /** @brief Default clock: std::chrono::steady_clock in nanoseconds. */
+  static uint64_t SteadyClockNs() noexcept {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  /**
+   * @brief Make a tracer the calling thread's active one for a scope.
+   *
+   * Restores the previous tracer on destruction, so trees ticked from
+   * inside another tree's leaves trace into their own rings.
+   */
+  class Scope final {
+   public:
+    explicit Scope(TickTracer* tracer) noexcept : previous_(Active()) {
+      Active() = tracer;
+    }
+    ~Scope() { Active() = previous_; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    TickTracer* previous_;
+  };
+
+  /** @brief Tracer recording on the calling thread (nullptr if none). */
+  static TickTracer*& Active() noexcept {
+    static thread_local TickTracer* active = nullptr;
+    return active;
+  }
+
+  // --- Producer (tick thread) ---
+
+  /** @brief Current clock value. */
+  BT_FORCE_INLINE uint64_t Now() const noexcept { return clock_(); }
+
+  /** @brief Append an event for a tick that started at @p start_ns. */
+  BT_FORCE_INLINE void Record(uint16_t node_id, Status from, Status to,
+                              uint64_t start_ns) noexcept {
+    const uint64_t elapsed = clock_() - start_ns;
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    if (BT_UNLIKELY(head - cached_tail_ >= capacity_)) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head - cached_tail_ >= capacity_) {
+        dropped_.fetch_add(1U, std::memory_order_relaxed);
+        return;
+      }
+    }
+    TraceEvent& e = buffer_[head & (capacity_ - 1U)];
+    e.start_ns = start_ns;
+    e.duration_ns = (elapsed > UINT32_MAX) ? UINT32_MAX
+                                           : static_cast<uint32_t>(elapsed);
+    e.node_id = node_id;
+    e.from = from;
+    e.to = to;
+    head_.store(head + 1U, std::memory_order_release);
+  }
+
+  // --- Consumer (any one thread) ---
+
+  /**
+   * @brief Move up to @p max oldest events into @p out.
+   * @return Number of events copied.
+   */
+  uint32_t Drain(TraceEvent* out, uint32_t max) noexcept {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    const uint32_t count = (head - tail < max) ? head - tail : max;
+    for (uint32_t i = 0; i < count; ++i) {
+      out[i] = buffer_[(tail + i) & (capacity_ - 1U)];
+    }
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  /** @brief Events waiting to be drained. */
+  uint32_t size() const noexcept {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+  /** @brief Ring capacity in events (0 if the buffer was unusable). */
+  uint32_t capacity() const noexcept { return capacity_; }
+
+  /** @brief Events lost because the ring was full. */
+  uint32_t dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kCacheLine = 64U;
+
+  // Producer line (consumer reads head_ and dropped_ only)
+  TraceEvent* buffer_;
+  uint32_t capacity_;  // power of two, or 0
+  ClockFn clock_;
+  std::atomic<uint32_t> head_;
+  uint32_t cached_tail_;
+  std::atomic<uint32_t> dropped_;
+  char pad_head_[kCacheLine];
+
+  // Consumer line
+  std::atomic<uint32_t> tail_;
+  char pad_tail_[kCacheLine - sizeof(std::atomic<uint32_t>)];
+};
+
+#endif  // BT_TRACE
+
+// ============================================================================
+// Tick Statistics
+// ============================================================================
 
+#if defined(BT_STATS)
+
+/**
+ * @brief Execution statistics of one BehaviorTree (see BT_STATS).
+ *
+ * Depth counts the root as 1. Per-tick figures are summed over all ticks
+ * for the averages; last_* describe the most recent tick.
+ */
+struct TickStats {
+  uint64_t ticks;
+  uint64_t results[4];     ///< Root results, indexed by Status value
+  uint64_t depth_sum;      ///< Sum of each tick's deepest node
+  uint64_t nodes_visited;  ///< Node::Tick() calls over all ticks
+  uint64_t leaves_ticked;  ///< Action/condition ticks over all ticks
+  uint32_t max_depth;
+  uint32_t max_nodes_per_tick;
+  uint32_t max_leaves_per_tick;
+  uint32_t last_depth;
+  uint32_t last_nodes;
+  uint32_t last_leaves;
+
+  /** @brief Ticks that returned @p s at the root. */
+  uint64_t count(Status s) const noexcept {
+    const uint8_t i = static_cast<uint8_t>(s);
+    return (i < 4U) ? results[i] : 0U;
+  }
+
+  /** @brief Mean deepest node per tick (0 before the first tick). */
+  double AverageDepth() const noexcept { return Average(depth_sum); }
+
+  /** @brief Mean Node::Tick() calls per tick. */
+  double AverageNodesPerTick() const noexcept { return Average(nodes_visited); }
+
+  /** @brief Mean leaf ticks per tick. */
+  double AverageLeavesPerTick() const noexcept {
+    return Average(leaves_ticked);
+  }
+
+ private:
+  double Average(uint64_t sum) const noexcept {
+    return (ticks == 0U)
+               ? 0.0
+               : static_cast<double>(sum) / static_cast<double>(ticks);
+  }
+};
+
+/**
+ * @brief Per-tick depth and visit counter.
+ *
+ * BehaviorTree::Tick() makes one the calling thread's active counter for
+ * the duration of the tick; every Node::Tick() then updates it.
+ */
+class TickCounter final {
  public:
-  /// Maximum children per node (compile-time configurable).
-  static constexpr uint16_t kMaxChildren =
-      static_cast<uint16_t>(BT_MAX_CHILDREN);
+  TickCounter() noexcept
+      : depth_(0), max_depth_(0), nodes_(0), leaves_(0), previous_(Active()) {
+    Active() = this;
+  }
+  ~TickCounter() { Active() = previous_; }
 
-  /// Maximum children for parallel node bitmap tracking.
-  static constexpr uint16_t kMaxParallelChildren = 32U;
+  TickCounter(const TickCounter&) = delete;
+  TickCounter& operator=(const TickCounter&) = delete;
 
-  static_assert(kMaxChildren <= 256U, "BT_MAX_CHILDREN too large (max 256)");
+  /** @brief Counter of the tick running on this thread (nullptr if none). */
+  static TickCounter*& Active() noexcept {
+    static thread_local TickCounter* active = nullptr;
+    return active;
+  }
 
-#if defined(BT_USE_STD_FUNCTION)
-  /// Tick callback: returns execution status. Called every tick.
-  using TickFn = std::function<Status(Context&)>;
-  /// Lifecycle callback: called on enter/exit transitions.
-  using CallbackFn = std::function<void(Context&)>;
-#else
-  /// Tick callback: raw function pointer (deterministic, no heap).
-  using TickFn = Status (*)(Context&);
-  /// Lifecycle callback: raw function pointer.
-  using CallbackFn = void (*)(Context&);
+  /** @brief A node of type @p type starts its tick. */
+  BT_FORCE_INLINE void Enter(NodeType type) noexcept {
+    ++depth_;
+    ++nodes_;
+    if (IsLeafType(type)) {
+      ++leaves_;
+    }
+    if (depth_ > max_depth_) {
+      max_depth_ = depth_;
+    }
+  }
+
+  /** @brief The innermost node finished its tick. */
+  BT_FORCE_INLINE void Exit() noexcept { --depth_; }
+
+  /** @brief Fold this tick into @p stats. */
+  void Commit(TickStats& stats, Status result) noexcept {
+    ++stats.ticks;
+    const uint8_t i = static_cast<uint8_t>(result);
+    if (i < 4U) {
+      ++stats.results[i];
+    }
+    stats.depth_sum += max_depth_;
+    stats.nodes_visited += nodes_;
+    stats.leaves_ticked += leaves_;
+    stats.max_depth = (max_depth_ > stats.max_depth) ? max_depth_
+                                                     : stats.max_depth;
+    stats.max_nodes_per_tick =
+        (nodes_ > stats.max_nodes_per_tick) ? nodes_ : stats.max_nodes_per_tick;
+    stats.max_leaves_per_tick = (leaves_ > stats.max_leaves_per_tick)
+                                    ? leaves_
+                                    : stats.max_leaves_per_tick;
+    stats.last_depth = max_depth_;
+    stats.last_nodes = nodes_;
+    stats.last_leaves = leaves_;
+  }
+
+ private:
+  uint32_t depth_;
+  uint32_t max_depth_;
+  uint32_t nodes_;
+  uint32_t leaves_;
+  TickCounter* previous_;
+};
+
+#endif  // BT_STATS
+
+// ============================================================================
+// Tick Watchdog
+// ============================================================================
+
+#if defined(BT_DEADLINE)
+
+/** @brief Path entries kept per overrun record (root first). */
+constexpr uint32_t kOverrunPathDepth = 16U;
+
+/** @brief One tick that exceeded its budget (see TickWatchdog). */
+struct OverrunRecord {
+  uint64_t tick;        ///< Watchdog tick index (0-based)
+  uint64_t elapsed;     ///< Tick time when the overrun was detected
+  uint16_t node_id;     ///< Node at the boundary that detected it
+  uint8_t depth;        ///< Full depth of node_id (root = 1)
+  bool aborted;         ///< Rest of the tick was yielded
+  uint16_t path[kOverrunPathDepth];  ///< Ids root-first, min(depth, 16)
+};
+
+/**
+ * @brief Per-tick deadline checked at node boundaries.
+ *
+ * BehaviorTree::Tick() starts the clock (see BehaviorTree::set_watchdog()).
+ * Each Node::Tick() checks the elapsed time on entry and on return. Set a
+ * stride to check only every n-th boundary. The first boundary past the
+ * budget in a tick records an OverrunRecord and calls the overrun
+ * callback. A check on return names the node that just finished,
+ * usually the slow leaf itself.
+ *
+ * With set_abort(true), every node not yet entered in that tick returns
+ * RUNNING without being ticked. Sequences and selectors then resume at
+ * that child on the next tick, so the traversal continues where it
+ * stopped.
+ *
+ * The log keeps the most recent records; read it between ticks.
+ */
+class TickWatchdog final {
+ public:
+  /// Time source (monotonic; budget uses the same unit).
+  using ClockFn = uint64_t (*)();
+  /// Overrun notification, called on the tick thread.
+  using OverrunFn = void (*)(const OverrunRecord& record, void* user);
+
+  /**
+   * @brief Construct over a caller-owned overrun log.
+   * @param log Record storage (must outlive the watchdog; may be nullptr).
+   * @param capacity Records in @p log; older records are overwritten.
+   * @param clock Time source (default: steady_clock nanoseconds).
+   */
+  TickWatchdog(OverrunRecord* log, uint32_t capacity,
+               ClockFn clock = &SteadyClockNs) noexcept
+      : log_(log), capacity_((log != nullptr) ? capacity : 0U),
+        clock_(clock), on_overrun_(nullptr), user_(nullptr), budget_(0),
+        start_(0), ticks_(0), overruns_(0), stride_(1), countdown_(1),
+        depth_(0), overrun_(false), abort_(false), aborting_(false),
+        path_{} {}
+
+  TickWatchdog(const TickWatchdog&) = delete;
+  TickWatchdog& operator=(const TickWatchdog&) = delete;
+
+  /** @brief Default clock: std::chrono::steady_clock in nanoseconds. */
+  static uint64_t SteadyClockNs() noexcept {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  // --- Configuration ---
+
+  /** @brief Tick budget in clock units (0 disables the checks). */
+  TickWatchdog& set_budget(uint64_t budget) noexcept {
+    budget_ = budget;
+    return *this;
+  }
+
+  /** @brief Check every @p n-th node boundary only (default 1). */
+  TickWatchdog& set_stride(uint32_t n) noexcept {
+    stride_ = (n > 0U) ? n : 1U;
+    return *this;
+  }
+
+  /** @brief Yield the rest of an overrunning tick (default false). */
+  TickWatchdog& set_abort(bool abort) noexcept {
+    abort_ = abort;
+    return *this;
+  }
+
+  /** @brief Callback fired once per overrunning tick (nullptr: none). */
+  TickWatchdog& set_on_overrun(OverrunFn fn, void* user = nullptr) noexcept {
+    on_overrun_ = fn;
+    user_ = user;
+    return *this;
+  }
+
+  /** @brief Make a watchdog the calling thread's active one for a scope. */
+  class Scope final {
+   public:
+    explicit Scope(TickWatchdog* watchdog) noexcept : previous_(Active()) {
+      Active() = watchdog;
+      if (watchdog != nullptr) {
+        watchdog->BeginTick();
+      }
+    }
+    ~Scope() { Active() = previous_; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    TickWatchdog* previous_;
+  };
+
+  /** @brief Watchdog of the tick running on this thread (nullptr if none). */
+  static TickWatchdog*& Active() noexcept {
+    static thread_local TickWatchdog* active = nullptr;
+    return active;
+  }
+
+  // --- Node boundaries (tick thread) ---
+
+  /** @brief Start timing a tree tick. */
+  void BeginTick() noexcept {
+    ++ticks_;
+    depth_ = 0;
+    overrun_ = false;
+    aborting_ = false;
+    countdown_ = stride_;
+    start_ = clock_();
+  }
+
+  /**
+   * @brief Node @p node_id is about to tick.
+   * @return true if the tick is being aborted and the node must yield.
+   */
+  BT_FORCE_INLINE bool Enter(uint16_t node_id) noexcept {
+    if (BT_UNLIKELY(aborting_)) {
+      return true;
+    }
+    if (depth_ < kOverrunPathDepth) {
+      path_[depth_] = node_id;
+    }
+    ++depth_;
+    Check(node_id);
+    return false;
+  }
+
+  /** @brief Node @p node_id returned from its tick. */
+  BT_FORCE_INLINE void Exit(uint16_t node_id) noexcept {
+    Check(node_id);
+    --depth_;
+  }
+
+  // --- Log (between ticks) ---
+
+  /** @brief Overrunning ticks since construction or ClearLog(). */
+  uint64_t overruns() const noexcept { return overruns_; }
+
+  /** @brief Records currently held (at most the log capacity). */
+  uint32_t size() const noexcept {
+    return (overruns_ < capacity_) ? static_cast<uint32_t>(overruns_)
+                                   : capacity_;
+  }
+
+  /** @brief @p i-th held record, oldest first (i < size()). */
+  const OverrunRecord& record(uint32_t i) const noexcept {
+    const uint64_t first = overruns_ - size();
+    return log_[(first + i) % capacity_];
+  }
+
+  /** @brief Drop all records. */
+  void ClearLog() noexcept { overruns_ = 0; }
+
+  /** @brief Tree ticks started. */
+  uint64_t ticks() const noexcept { return ticks_; }
+
+ private:
+  BT_FORCE_INLINE void Check(uint16_t node_id) noexcept {
+    if (BT_LIKELY(overrun_ || (budget_ == 0U) || (--countdown_ != 0U))) {
+      return;
+    }
+    countdown_ = stride_;
+    const uint64_t elapsed = clock_() - start_;
+    if (BT_UNLIKELY(elapsed > budget_)) {
+      Overrun(node_id, elapsed);
+    }
+  }
+
+  void Overrun(uint16_t node_id, uint64_t elapsed) noexcept {
+    overrun_ = true;
+    aborting_ = abort_;
+    OverrunRecord scratch;
+    OverrunRecord& r =
+        (capacity_ > 0U) ? log_[overruns_ % capacity_] : scratch;
+    ++overruns_;
+    r.tick = ticks_ - 1U;
+    r.elapsed = elapsed;
+    r.node_id = node_id;
+    r.depth = static_cast<uint8_t>((depth_ < 255U) ? depth_ : 255U);
+    r.aborted = abort_;
+    const uint32_t kept = (depth_ < kOverrunPathDepth) ? depth_
+                                                       : kOverrunPathDepth;
+    for (uint32_t i = 0; i < kOverrunPathDepth; ++i) {
+      r.path[i] = (i < kept) ? path_[i] : 0U;
+    }
+    if (on_overrun_ != nullptr) {
+      on_overrun_(r, user_);
+    }
+  }
+
+  OverrunRecord* log_;
+  uint32_t capacity_;
+  ClockFn clock_;
+  OverrunFn on_overrun_;
+  void* user_;
+  uint64_t budget_;
+  uint64_t start_;
+  uint64_t ticks_;
+  uint64_t overruns_;
+  uint32_t stride_;
+  uint32_t countdown_;
+  uint32_t depth_;
+  bool overrun_;
+  bool abort_;
+  bool aborting_;
+  uint16_t path_[kOverrunPathDepth];
+};
+
+#endif  // BT_DEADLINE
+
+// ============================================================================
+// Node Counters
+// ============================================================================
+
+#if defined(BT_COUNTERS)
+
+/**
+ * @brief Counter columns; the first four are indexed by Status value.
+ *
+ * A tick is counted once under its result, so RUNNING results add up to
+ * the number of ticks a node spent RUNNING. Ticks that start a node from
+ * idle (previous status not RUNNING) are also counted as entries. A halt
+ * of a RUNNING node counts as a failure.
+ */
+enum class CounterColumn : uint8_t {
+  kSuccesses = 0,
+  kFailures = 1,
+  kRunningTicks = 2,
+  kErrors = 3,
+  kEntries = 4
+};
+
+/** @brief Number of CounterColumn values. */
+constexpr uint32_t kCounterColumns = 5U;
+
+/**
+ * @brief Plain copy of per-node counters (see NodeCounterBlock).
+ * @tparam kNodes Node id capacity.
+ */
+template <uint16_t kNodes>
+struct NodeCountSnapshot {
+  uint64_t columns[kCounterColumns][kNodes];
+  uint64_t tree_ticks;  ///< BehaviorTree ticks covered by the counts
+
+  /** @brief Counter @p c of node @p id. */
+  uint64_t get(CounterColumn c, uint16_t id) const noexcept {
+    return columns[static_cast<uint8_t>(c)][id];
+  }
+
+  /** @brief All Node::Tick() calls of node @p id. */
+  uint64_t ticks(uint16_t id) const noexcept {
+    return columns[0][id] + columns[1][id] + columns[2][id] + columns[3][id];
+  }
+
+  /** @brief Counts accumulated since @p earlier (counters never wrap). */
+  NodeCountSnapshot Delta(const NodeCountSnapshot& earlier) const noexcept {
+    NodeCountSnapshot d;
+    for (uint32_t c = 0; c < kCounterColumns; ++c) {
+      for (uint32_t i = 0; i < kNodes; ++i) {
+        d.columns[c][i] = columns[c][i] - earlier.columns[c][i];
+      }
+    }
+    d.tree_ticks = tree_ticks - earlier.tree_ticks;
+    return d;
+  }
+};
+
+/**
+ * @brief Tick-thread side of per-node counters (see NodeCounterBlock).
+ *
+ * One column per CounterColumn, each an array indexed by node id, so a
+ * tick touches one word in each of two small arrays. The tick thread is
+ * the only writer. Each BehaviorTree tick is a seqlock write section, so
+ * readers on other threads copy a consistent set of counts between
+ * ticks.
+ */
+class NodeCounters {
+ public:
+  NodeCounters(const NodeCounters&) = delete;
+  NodeCounters& operator=(const NodeCounters&) = delete;
+
+  /**
+   * @brief Make counters the calling thread's active ones for a tick
+   *        (@p tree_tick false: a halt between ticks, not counted as one).
+   */
+  class Scope final {
+   public:
+    explicit Scope(NodeCounters* counters, bool tree_tick = true) noexcept
+        : counters_(counters), previous_(Active()), tree_tick_(tree_tick) {
+      Active() = counters;
+      if (counters != nullptr) {
+        counters->BeginWrite();
+      }
+    }
+    ~Scope() {
+      Active() = previous_;
+      if (counters_ != nullptr) {
+        if (tree_tick_) {
+          Bump(counters_->tree_ticks_);
+        }
+        counters_->EndWrite();
+      }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    NodeCounters* counters_;
+    NodeCounters* previous_;
+    bool tree_tick_;
+  };
+
+  /** @brief Counters of the tick running on this thread (nullptr if none). */
+  static NodeCounters*& Active() noexcept {
+    static thread_local NodeCounters* active = nullptr;
+    return active;
+  }
+
+  /** @brief Count one tick of @p node_id that went from @p from to @p to. */
+  BT_FORCE_INLINE void Count(uint16_t node_id, Status from,
+                             Status to) noexcept {
+    if (BT_UNLIKELY(node_id >= capacity_)) {
+      return;
+    }
+    const uint8_t column = static_cast<uint8_t>(to);
+    if (BT_LIKELY(column < 4U)) {
+      Bump(cells_[(static_cast<uint32_t>(column) * capacity_) + node_id]);
+    }
+    if (from != Status::kRunning) {
+      Bump(cells_[(4U * capacity_) + node_id]);
+    }
+  }
+
+  /** @brief Node id capacity. */
+  uint16_t capacity() const noexcept { return capacity_; }
+
+ protected:
+  NodeCounters(std::atomic<uint64_t>* cells, uint16_t capacity,
+               std::atomic<uint64_t>& tree_ticks) noexcept
+      : cells_(cells), capacity_(capacity), tree_ticks_(tree_ticks),
+        writers_(0), seq_(0) {}
+  ~NodeCounters() = default;
+
+  /**
+   * @brief Seqlock read of all columns into @p out (column-major) and
+   *        the tree tick count into @p ticks. Spins while a tick runs.
+   */
+  void Read(uint64_t* out, uint64_t& ticks) const noexcept {
+    const uint32_t cells = kCounterColumns * capacity_;
+    for (;;) {
+      const uint32_t before = seq_.load(std::memory_order_acquire);
+      if ((before & 1U) != 0U) {
+        continue;
+      }
+      for (uint32_t i = 0; i < cells; ++i) {
+        out[i] = cells_[i].load(std::memory_order_relaxed);
+      }
+      ticks = tree_ticks_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq_.load(std::memory_order_relaxed) == before) {
+        return;
+      }
+    }
+  }
+
+  /** @brief Zero all counters (tick thread, between ticks). */
+  void Clear() noexcept {
+    const uint32_t cells = kCounterColumns * capacity_;
+    BeginWrite();
+    for (uint32_t i = 0; i < cells; ++i) {
+      cells_[i].store(0U, std::memory_order_relaxed);
+    }
+    tree_ticks_.store(0U, std::memory_order_relaxed);
+    EndWrite();
+  }
+
+ private:
+  /* Make seq_ odd; nested trees sharing the counters stay in one section. */
+  void BeginWrite() noexcept {
+    if (writers_++ == 0U) {
+      seq_.store(seq_.load(std::memory_order_relaxed) + 1U,
+                 std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+  }
+
+  void EndWrite() noexcept {
+    if (--writers_ == 0U) {
+      seq_.store(seq_.load(std::memory_order_relaxed) + 1U,
+                 std::memory_order_release);
+    }
+  }
+
+  /* Single writer: a plain load/store pair, no locked RMW. */
+  static BT_FORCE_INLINE void Bump(std::atomic<uint64_t>& cell) noexcept {
+    cell.store(cell.load(std::memory_order_relaxed) + 1U,
+               std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t>* cells_;
+  uint16_t capacity_;
+  std::atomic<uint64_t>& tree_ticks_;
+  uint32_t writers_;  // tick thread only
+  std::atomic<uint32_t> seq_;
+};
+
+/**
+ * @brief Per-node counters for node ids below @p kNodes.
+ *
+ * @code
+ *   static bt::NodeCounterBlock<256> counters;
+ *   tree.set_counters(&counters);
+ *
+ *   // monitoring thread
+ *   bt::NodeCountSnapshot<256> now;
+ *   counters.Snapshot(now);
+ *   auto d = now.Delta(last);   // per-node counts since the last poll
+ * @endcode
+ */
+template <uint16_t kNodes>
+class NodeCounterBlock final : public NodeCounters {
+ public:
+  NodeCounterBlock() noexcept
+      : NodeCounters(cells_, kNodes, tree_ticks_), cells_{}, tree_ticks_(0) {}
+
+  /** @brief Consistent copy of all counters (any thread). */
+  void Snapshot(NodeCountSnapshot<kNodes>& out) const noexcept {
+    Read(&out.columns[0][0], out.tree_ticks);
+  }
+
+  /** @brief Zero all counters (tick thread, between ticks). */
+  void Reset() noexcept { Clear(); }
+
+ private:
+  std::atomic<uint64_t> cells_[kCounterColumns * kNodes];
+  std::atomic<uint64_t> tree_ticks_;
+};
+
+#endif  // BT_COUNTERS
+
+// ============================================================================
+// Status Stream
+// ============================================================================
+
+#if defined(BT_STATUS_STREAM)
+
+/** @brief One decoded StatusStream event. */
+struct StatusEvent {
+  uint64_t tick;     ///< Stream tick (see StatusStream)
+  uint16_t node_id;  ///< Node::id() of the node
+  Status from;       ///< Status before the change
+  Status to;         ///< Status after the change
+};
+
+/**
+ * @brief Compact byte stream of status changes (single producer / single
+ *        consumer ring).
+ *
+ * A node tick is recorded unless it goes RUNNING -> RUNNING, so a node
+ * shows up when it is entered, when it changes status and when it
+ * finishes; a halt is recorded as RUNNING -> FAILURE. Events are
+ * written when the tick returns, children before parents.
+ *
+ * The stream counts its own ticks: one per BehaviorTree::Tick() that
+ * records into it (a tree ticked from inside another one sharing the
+ * stream does not add a tick). BehaviorTree::Halt() between ticks is
+ * stamped with the preceding tick. Each event is a header byte followed by
+ * LEB128 varints:
+ *
+ *   header  bits 0-1 from, bits 2-3 to, bit 4 tick delta follows,
+ *           bit 5 sync (absolute tick and id), bits 6-7 zero
+ *   sync:   tick, node_id
+ *   else:   [tick - previous tick], zigzag(node_id - previous node_id)
+ *
+ * An event in the same tick as its predecessor with a nearby node id
+ * takes two bytes. The first event and the first one after a drop are
+ * sync events, so a reader never mixes deltas across a gap. Decode the
+ * drained bytes with StatusStreamReader.
+ */
+class StatusStream final {
+ public:
+  /// Longest encoded event in bytes.
+  static constexpr uint32_t kMaxEventSize = 14U;
+
+  /**
+   * @brief Construct over caller-owned storage.
+   * @param buffer Byte storage (must outlive the stream).
+   * @param capacity Bytes in @p buffer; rounded down to a power of two.
+   */
+  StatusStream(uint8_t* buffer, uint32_t capacity) noexcept
+      : buffer_(buffer), capacity_(0), head_(0), cached_tail_(0), tick_(0),
+        last_tick_(0), last_id_(0), writers_(0), sync_(true), events_(0),
+        dropped_(0), pad_head_{}, tail_(0), pad_tail_{} {
+    if ((buffer != nullptr) && (capacity >= kMaxEventSize)) {
+      capacity_ = 1U;
+      while (capacity_ <= (capacity >> 1U)) {
+        capacity_ <<= 1U;
+      }
+    }
+  }
+
+  StatusStream(const StatusStream&) = delete;
+  StatusStream& operator=(const StatusStream&) = delete;
+
+  /**
+   * @brief Make a stream the calling thread's active one for one tree
+   *        tick; the outermost scope on a stream advances its tick unless
+   *        @p tree_tick is false (a halt between ticks).
+   */
+  class Scope final {
+   public:
+    explicit Scope(StatusStream* stream, bool tree_tick = true) noexcept
+        : stream_(stream), previous_(Active()) {
+      Active() = stream;
+      if ((stream != nullptr) && (stream->writers_++ == 0U) && tree_tick) {
+        ++stream->tick_;
+      }
+    }
+    ~Scope() {
+      Active() = previous_;
+      if (stream_ != nullptr) {
+        --stream_->writers_;
+      }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    StatusStream* stream_;
+    StatusStream* previous_;
+  };
+
+  /** @brief Stream recording on the calling thread (nullptr if none). */
+  static StatusStream*& Active() noexcept {
+    static thread_local StatusStream* active = nullptr;
+    return active;
+  }
+
+  // --- Producer (tick thread) ---
+
+  /** @brief Record a tick or halt of @p node_id unless it stays RUNNING. */
+  BT_FORCE_INLINE void Record(uint16_t node_id, Status from,
+                              Status to) noexcept {
+    if ((from == Status::kRunning) && (to == Status::kRunning)) {
+      return;
+    }
+    Append(node_id, from, to);
+  }
+
+  /** @brief Current stream tick. */
+  uint64_t tick() const noexcept { return tick_; }
+
+  /** @brief Events written (tick thread). */
+  uint64_t events() const noexcept { return events_; }
+
+  // --- Consumer (any one thread) ---
+
+  /**
+   * @brief Move up to @p max oldest bytes into @p out.
+   * @return Number of bytes copied. Events may be split across calls.
+   */
+  uint32_t Drain(uint8_t* out, uint32_t max) noexcept {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    const uint32_t count = (head - tail < max) ? head - tail : max;
+    for (uint32_t i = 0; i < count; ++i) {
+      out[i] = buffer_[(tail + i) & (capacity_ - 1U)];
+    }
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  /** @brief Bytes waiting to be drained. */
+  uint32_t size() const noexcept {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+  /** @brief Ring capacity in bytes (0 if the buffer was unusable). */
+  uint32_t capacity() const noexcept { return capacity_; }
+
+  /** @brief Events lost because the ring was full. */
+  uint32_t dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kCacheLine = 64U;
+
+  static uint32_t PutVarint(uint8_t* out, uint64_t v) noexcept {
+    uint32_t n = 0;
+    while (v >= 0x80U) {
+      out[n] = static_cast<uint8_t>(v | 0x80U);
+      v >>= 7U;
+      ++n;
+    }
+    out[n] = static_cast<uint8_t>(v);
+    return n + 1U;
+  }
+
+  void Append(uint16_t node_id, Status from, Status to) noexcept {
+    uint8_t event[kMaxEventSize];
+    uint32_t size = 1U;
+    uint8_t header = static_cast<uint8_t>(
+        static_cast<uint8_t>(from) | (static_cast<uint8_t>(to) << 2U));
+    if (sync_) {
+      header = static_cast<uint8_t>(header | 0x20U);
+      size += PutVarint(event + size, tick_);
+      size += PutVarint(event + size, node_id);
+    } else {
+      if (tick_ != last_tick_) {
+        header = static_cast<uint8_t>(header | 0x10U);
+        size += PutVarint(event + size, tick_ - last_tick_);
+      }
+      const int32_t delta =
+          static_cast<int32_t>(node_id) - static_cast<int32_t>(last_id_);
+      const uint32_t zigzag = (static_cast<uint32_t>(delta) << 1U) ^
+                              ((delta < 0) ? 0xFFFFFFFFU : 0U);
+      size += PutVarint(event + size, zigzag);
+    }
+    event[0] = header;
+
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    if (BT_UNLIKELY(capacity_ - (head - cached_tail_) < size)) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (capacity_ - (head - cached_tail_) < size) {
+        dropped_.fetch_add(1U, std::memory_order_relaxed);
+        sync_ = true;
+        return;
+      }
+    }
+    for (uint32_t i = 0; i < size; ++i) {
+      buffer_[(head + i) & (capacity_ - 1U)] = event[i];
+    }
+    head_.store(head + size, std::memory_order_release);
+    last_tick_ = tick_;
+    last_id_ = node_id;
+    sync_ = false;
+    ++events_;
+  }
+
+  // Producer line (consumer reads head_ and dropped_ only)
+  uint8_t* buffer_;
+  uint32_t capacity_;  // power of two, or 0
+  std::atomic<uint32_t> head_;
+  uint32_t cached_tail_;
+  uint64_t tick_;
+  uint64_t last_tick_;
+  uint16_t last_id_;
+  uint16_t writers_;  // nested Scopes on this stream
+  bool sync_;
+  uint64_t events_;
+  std::atomic<uint32_t> dropped_;
+  char pad_head_[kCacheLine];
+
+  // Consumer line
+  std::atomic<uint32_t> tail_;
+  char pad_tail_[kCacheLine - sizeof(std::atomic<uint32_t>)];
+};
+
+/**
+ * @brief Decoder of StatusStream bytes.
+ *
+ * @code
+ *   bt::StatusStreamReader reader;
+ *   bt::StatusEvent e;
+ *   uint32_t pos = 0;
+ *   uint32_t n = 0;
+ *   while ((n = reader.Decode(bytes + pos, len - pos, e)) > 0U) {
+ *     pos += n;  // use e
+ *   }
+ *   // bytes [pos, len) hold a partial event: prepend them to the next chunk
+ * @endcode
+ */
+class StatusStreamReader final {
+ public:
+  StatusStreamReader() noexcept
+      : tick_(0), last_id_(0), synced_(false), error_(false) {}
+
+  /**
+   * @brief Decode the event at the start of @p data.
+   * @return Bytes consumed, or 0 if @p data holds only part of an event
+   *         or the stream is malformed (see error()).
+   */
+  uint32_t Decode(const uint8_t* data, uint32_t size,
+                  StatusEvent& out) noexcept {
+    if ((size == 0U) || error_) {
+      return 0;
+    }
+    const uint8_t header = data[0];
+    const bool sync = (header & 0x20U) != 0U;
+    if (((header & 0xC0U) != 0U) || (!sync && !synced_)) {
+      error_ = true;
+      return 0;
+    }
+    uint32_t pos = 1U;
+    uint64_t tick = tick_;
+    uint64_t id = 0;
+    if (sync) {
+      if (!GetVarint(data, size, pos, tick) ||
+          !GetVarint(data, size, pos, id)) {
+        return 0;
+      }
+    } else {
+      uint64_t delta = 0;
+      if (((header & 0x10U) != 0U) && !GetVarint(data, size, pos, delta)) {
+        return 0;
+      }
+      uint64_t zigzag = 0;
+      if (!GetVarint(data, size, pos, zigzag)) {
+        return 0;
+      }
+      tick += delta;
+      const int64_t d = static_cast<int64_t>(zigzag >> 1U) ^
+                        -static_cast<int64_t>(zigzag & 1U);
+      id = static_cast<uint64_t>(static_cast<int64_t>(last_id_) + d);
+    }
+    if (id > 0xFFFFU) {
+      error_ = true;
+      return 0;
+    }
+    tick_ = tick;
+    last_id_ = static_cast<uint16_t>(id);
+    synced_ = true;
+    out.tick = tick_;
+    out.node_id = last_id_;
+    out.from = static_cast<Status>(header & 0x03U);
+    out.to = static_cast<Status>((header >> 2U) & 0x03U);
+    return pos;
+  }
+
+  /** @brief true once a malformed event was seen; Decode() then stops. */
+  bool error() const noexcept { return error_; }
+
+ private:
+  /* LEB128; false if the value runs past @p size (or is over-long). */
+  bool GetVarint(const uint8_t* data, uint32_t size, uint32_t& pos,
+                 uint64_t& v) noexcept {
+    v = 0;
+    for (uint32_t shift = 0; shift < 64U; shift += 7U) {
+      if (pos >= size) {
+        return false;
+      }
+      const uint8_t b = data[pos];
+      ++pos;
+      v |= static_cast<uint64_t>(b & 0x7FU) << shift;
+      if ((b & 0x80U) == 0U) {
+        return true;
+      }
+    }
+    error_ = true;
+    return false;
+  }
+
+  uint64_t tick_;
+  uint16_t last_id_;
+  bool synced_;
+  bool error_;
+};
+
+#endif  // BT_STATUS_STREAM
+
+// ============================================================================
+// Tick Profiler
+// ============================================================================
+
+#if defined(BT_PROFILE)
+
+/** @brief Latency histogram buckets: bucket b counts [2^b, 2^(b+1)). */
+constexpr uint32_t kProfileBuckets = 32U;
+
+/**
+ * @brief Accumulated cost of one node (clock units, see TickProfiler).
+ *
+ * Inclusive time covers the node's whole Tick(), exclusive time excludes
+ * ticks of its children.
+ */
+struct NodeProfile {
+  uint64_t calls;
+  uint64_t inclusive;
+  uint64_t exclusive;
+  uint64_t max;  ///< Longest single inclusive tick
+  uint32_t histogram[kProfileBuckets];  ///< Inclusive time, log2 buckets
+
+  /**
+   * @brief Upper bound of the bucket holding quantile @p q (0..1).
+   *
+   * The last bucket is open-ended and reports max instead.
+   */
+  uint64_t Percentile(double q) const noexcept {
+    if (calls == 0U) {
+      return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(calls));
+    rank = (rank < calls) ? rank : (calls - 1U);
+    uint64_t seen = 0;
+    for (uint32_t b = 0; (b + 1U) < kProfileBuckets; ++b) {
+      seen += histogram[b];
+      if (seen > rank) {
+        return (uint64_t{2} << b) - 1U;
+      }
+    }
+    return max;
+  }
+};
+
+/**
+ * @brief Cost of one root-to-node path (see TickProfiler::set_paths()).
+ *
+ * Paths are identified by a 64-bit hash of their node ids; @p parent is
+ * the key of the path one node shorter (0 at the root).
+ */
+struct PathSlot {
+  uint64_t key;        ///< 0 marks an empty slot
+  uint64_t parent;
+  uint64_t exclusive;  ///< Clock units spent in the last node of the path
+  uint64_t calls;
+  uint16_t node_id;
+};
+
+/**
+ * @brief Per-node latency profiler over caller-owned NodeProfile slots.
+ *
+ * Slot i accumulates the node with Node::id() == i (see AssignNodeIds());
+ * nodes with ids past the slot count are timed for their parent's
+ * exclusive time but not recorded. Every Node::Tick() on a thread with an
+ * active profiler (see Scope, BehaviorTree::set_profiler()) is measured.
+ *
+ * With a path table (set_paths()), exclusive time is also aggregated per
+ * root-to-node path for folded-stack flame graphs (bt/flame_graph.hpp).
+ *
+ * Not thread-safe: read and Reset() it between ticks on the tick thread.
+ */
+class TickProfiler final {
+ public:
+  /// Time source (monotonic, any unit).
+  using ClockFn = uint64_t (*)();
+
+  /**
+   * @brief Construct over caller-owned slots (cleared here).
+   * @param nodes Profile slots, one per node id (must outlive the profiler).
+   * @param count Number of slots in @p nodes.
+   * @param clock Time source (default: DefaultClock()).
+   */
+  TickProfiler(NodeProfile* nodes, uint16_t count,
+               ClockFn clock = &DefaultClock) noexcept
+      : nodes_(nodes), count_((nodes != nullptr) ? count : 0U),
+        clock_(clock), paths_(nullptr), path_mask_(0), path_overflow_(0),
+        depth_(0), child_time_{}, path_key_{} {
+    Reset();
+  }
+
+  /**
+   * @brief Also aggregate per-path cost into @p slots (cleared here).
+   * @param capacity Slots in @p slots; rounded down to a power of two.
+   *        Pass nullptr to stop path recording.
+   *
+   * Each distinct path uses one slot for the profiler's lifetime; size
+   * the table at about twice the number of nodes.
+   */
+  void set_paths(PathSlot* slots, uint32_t capacity) noexcept {
+    paths_ = ((slots != nullptr) && (capacity > 0U)) ? slots : nullptr;
+    path_mask_ = 0;
+    if (paths_ != nullptr) {
+      uint32_t size = 1U;
+      while (size <= (capacity >> 1U)) {
+        size <<= 1U;
+      }
+      path_mask_ = size - 1U;
+    }
+    ResetPaths();
+  }
+
+  TickProfiler(const TickProfiler&) = delete;
+  TickProfiler& operator=(const TickProfiler&) = delete;
+  TickProfiler(TickProfiler&&) = delete;
+  TickProfiler& operator=(TickProfiler&&) = delete;
+
+  /** @brief Monotonic nanoseconds, unaffected by NTP slewing on Linux. */
+  static uint64_t MonotonicRawNs() noexcept {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_RAW)
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000000U) +
+           static_cast<uint64_t>(ts.tv_nsec);
+#else
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+  }
+
+#if defined(BT_PROFILE_HAS_TSC)
+  /** @brief Time-stamp counter (cycles at the nominal TSC rate). */
+  static uint64_t Rdtsc() noexcept { return static_cast<uint64_t>(__rdtsc()); }
+#endif
+
+  /** @brief rdtsc where available, else MonotonicRawNs(). */
+  static uint64_t DefaultClock() noexcept {
+#if defined(BT_PROFILE_HAS_TSC)
+    return Rdtsc();
+#else
+    return MonotonicRawNs();
+#endif
+  }
+
+  /** @brief Make a profiler the calling thread's active one for a scope. */
+  class Scope final {
+   public:
+    explicit Scope(TickProfiler* profiler) noexcept : previous_(Active()) {
+      Active() = profiler;
+    }
+    ~Scope() { Active() = previous_; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    TickProfiler* previous_;
+  };
+
+  /** @brief Profiler recording on the calling thread (nullptr if none). */
+  static TickProfiler*& Active() noexcept {
+    static thread_local TickProfiler* active = nullptr;
+    return active;
+  }
+
+  // --- Recording (tick thread) ---
+
+  /** @brief Open a tick of @p node_id; returns its start time for Exit(). */
+  BT_FORCE_INLINE uint64_t Enter(uint16_t node_id) noexcept {
+    if (BT_LIKELY(depth_ < BT_PROFILE_MAX_DEPTH)) {
+      child_time_[depth_] = 0;
+      if (paths_ != nullptr) {
+        const uint64_t parent = (depth_ > 0U) ? path_key_[depth_ - 1U] : 0U;
+        path_key_[depth_] = PathKey(parent, node_id);
+      }
+    }
+    ++depth_;
+    return clock_();
+  }
+
+  /** @brief Close the innermost node tick opened at @p start. */
+  BT_FORCE_INLINE void Exit(uint16_t node_id, uint64_t start) noexcept {
+    const uint64_t elapsed = clock_() - start;
+    --depth_;
+    uint64_t children = 0;
+    if (BT_LIKELY(depth_ < BT_PROFILE_MAX_DEPTH)) {
+      children = child_time_[depth_];
+    }
+    if ((depth_ > 0U) && (depth_ <= BT_PROFILE_MAX_DEPTH)) {
+      child_time_[depth_ - 1U] += elapsed;
+    }
+    const uint64_t exclusive = (elapsed > children) ? (elapsed - children) : 0U;
+    if (paths_ != nullptr) {
+      RecordPath(node_id, exclusive);
+    }
+    if (BT_UNLIKELY(node_id >= count_)) {
+      return;
+    }
+    NodeProfile& p = nodes_[node_id];
+    ++p.calls;
+    p.inclusive += elapsed;
+    p.exclusive += exclusive;
+    if (elapsed > p.max) {
+      p.max = elapsed;
+    }
+    ++p.histogram[Bucket(elapsed)];
+  }
+
+  // --- Snapshot (between ticks) ---
+
+  /**
+   * @brief Ids of the @p max nodes with the most exclusive time.
+   * @param out Receives ids, hottest first.
+   * @return Number of ids written (nodes never ticked are skipped).
+   */
+  uint16_t TopN(uint16_t* out, uint16_t max) const noexcept {
+    uint16_t n = 0;
+    for (uint16_t id = 0; id < count_; ++id) {
+      const uint64_t cost = nodes_[id].exclusive;
+      if (nodes_[id].calls == 0U) {
+        continue;
+      }
+      uint16_t pos = n;
+      while ((pos > 0U) && (nodes_[out[pos - 1U]].exclusive < cost)) {
+        if (pos < max) {
+          out[pos] = out[pos - 1U];
+        }
+        --pos;
+      }
+      if (pos < max) {
+        out[pos] = id;
+        if (n < max) {
+          ++n;
+        }
+      }
+    }
+    return n;
+  }
+
+  /** @brief Profile of node @p node_id (nullptr if out of range). */
+  const NodeProfile* node(uint16_t node_id) const noexcept {
+    return (node_id < count_) ? &nodes_[node_id] : nullptr;
+  }
+
+  /** @brief Number of profile slots. */
+  uint16_t count() const noexcept { return count_; }
+
+  /** @brief Path table (nullptr if path recording is off). */
+  const PathSlot* paths() const noexcept { return paths_; }
+
+  /** @brief Slots in the path table (0 if off). */
+  uint32_t path_capacity() const noexcept {
+    return (paths_ != nullptr) ? (path_mask_ + 1U) : 0U;
+  }
+
+  /** @brief Path ticks not recorded: table full or deeper than
+   *         BT_PROFILE_MAX_DEPTH. */
+  uint64_t path_overflow() const noexcept { return path_overflow_; }
+
+  /** @brief Slot of path @p key (nullptr if not recorded). */
+  const PathSlot* FindPath(uint64_t key) const noexcept {
+    if ((paths_ == nullptr) || (key == 0U)) {
+      return nullptr;
+    }
+    for (uint32_t probe = 0; probe <= path_mask_; ++probe) {
+      const PathSlot& slot =
+          paths_[(static_cast<uint32_t>(key) + probe) & path_mask_];
+      if (slot.key == key) {
+        return &slot;
+      }
+      if (slot.key == 0U) {
+        return nullptr;
+      }
+    }
+    return nullptr;
+  }
+
+  /** @brief Clear every slot and the path table. */
+  void Reset() noexcept {
+    if (count_ > 0U) {
+      std::memset(nodes_, 0, sizeof(NodeProfile) * count_);
+    }
+    ResetPaths();
+  }
+
+ private:
+  /* Key of the path that extends @p parent by @p node_id (never 0). */
+  static BT_FORCE_INLINE uint64_t PathKey(uint64_t parent,
+                                          uint16_t node_id) noexcept {
+    uint64_t h = (parent ^ (static_cast<uint64_t>(node_id) + 1U)) *
+                 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 29U;
+    return (h != 0U) ? h : 1U;
+  }
+
+  void RecordPath(uint16_t node_id, uint64_t exclusive) noexcept {
+    if (BT_UNLIKELY(depth_ >= BT_PROFILE_MAX_DEPTH)) {
+      ++path_overflow_;
+      return;
+    }
+    const uint64_t key = path_key_[depth_];
+    for (uint32_t probe = 0; probe <= path_mask_; ++probe) {
+      PathSlot& slot =
+          paths_[(static_cast<uint32_t>(key) + probe) & path_mask_];
+      if (slot.key == 0U) {
+        slot.key = key;
+        slot.parent = (depth_ > 0U) ? path_key_[depth_ - 1U] : 0U;
+        slot.node_id = node_id;
+      }
+      if (slot.key == key) {
+        slot.exclusive += exclusive;
+        ++slot.calls;
+        return;
+      }
+    }
+    ++path_overflow_;
+  }
+
+  void ResetPaths() noexcept {
+    if (paths_ != nullptr) {
+      std::memset(paths_, 0, sizeof(PathSlot) * (path_mask_ + 1U));
+    }
+    path_overflow_ = 0;
+  }
+
+  static BT_FORCE_INLINE uint32_t Bucket(uint64_t elapsed) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    const uint32_t b =
+        (elapsed < 2U) ? 0U
+                       : static_cast<uint32_t>(63 - __builtin_clzll(elapsed));
+#else
+    uint32_t b = 0;
+    while ((elapsed >>= 1U) != 0U) {
+      ++b;
+    }
+#endif
+    return (b < kProfileBuckets) ? b : (kProfileBuckets - 1U);
+  }
+
+  NodeProfile* nodes_;
+  uint16_t count_;
+  ClockFn clock_;
+  PathSlot* paths_;
+  uint32_t path_mask_;
+  uint64_t path_overflow_;
+  uint32_t depth_;
+  uint64_t child_time_[BT_PROFILE_MAX_DEPTH];
+  uint64_t path_key_[BT_PROFILE_MAX_DEPTH];
+};
+
+#endif  // BT_PROFILE
+
+// ============================================================================
+// Observer
+// ============================================================================
+
+/**
+ * @brief Default observer policy: every hook is an empty inline function.
+ *
+ * An observer is a type with static hooks, passed as the Observer
+ * parameter of Node and BehaviorTree. Derive from NullObserver and hide
+ * only the hooks you need; calls are resolved at compile time, so unused
+ * hooks cost nothing and no per-node pointer is stored.
+ *
+ * @code
+ * struct Coverage : bt::NullObserver {
+ *   template <typename NodeT>
+ *   static void OnTick(const NodeT& node) noexcept { ++hits[node.id()]; }
+ * };
+ * bt::Node<Ctx, Coverage> root("Root");
+ * bt::BehaviorTree<Ctx, Coverage> tree(root, ctx);
+ * @endcode
+ */
+struct NullObserver {
+  /** @brief A node is about to be ticked. */
+  template <typename NodeT>
+  static void OnTick(const NodeT& /*node*/) noexcept {}
+
+  /**
+   * @brief A node's status changed: by its tick, or to kFailure when a
+   *        RUNNING node is halted.
+   */
+  template <typename NodeT>
+  static void OnStatusChange(const NodeT& /*node*/, Status /*from*/,
+                             Status /*to*/) noexcept {}
+
+  /** @brief A node's tick returned @p result; pairs with OnTick(). */
+  template <typename NodeT>
+  static void OnTickEnd(const NodeT& /*node*/, Status /*result*/) noexcept {}
+
+  /** @brief BehaviorTree::Tick() is about to tick the root. */
+  template <typename TreeT>
+  static void OnTreeTickBegin(const TreeT& /*tree*/) noexcept {}
+
+  /** @brief BehaviorTree::Tick() finished with @p result. */
+  template <typename TreeT>
+  static void OnTreeTickEnd(const TreeT& /*tree*/, Status /*result*/) noexcept {
+  }
+};
+
+// ============================================================================
+// Forward declaration
+// ============================================================================
+
+template <typename Context, typename Observer = NullObserver>
+class BehaviorTree;
+
+template <typename Context, typename Observer = NullObserver>
+class Node;
+
+// ============================================================================
+// Node
+// ============================================================================
+
+/**
+ * @brief Deferred child of a SUBTREE node (implemented by LazySubtree).
+ *
+ * The node calls instantiate() when it is ticked without a child and
+ * clears idle_ticks on every tick. The owner counts idle_ticks up and may
+ * detach the child again while the node is not RUNNING.
+ */
+template <typename Context, typename Observer = NullObserver>
+struct SubtreeSource {
+  /// Builds the subtree and returns its root (nullptr on failure).
+  Node<Context, Observer>* (*instantiate)(SubtreeSource& source);
+  /// Owner-maintained ticks since the node was last ticked.
+  uint32_t idle_ticks;
+};
+
+/**
+ * @brief Behavior tree node template.
+ * @tparam Context User-defined context type for type-safe shared data.
+ * @tparam Observer Static hook policy (see NullObserver).
+ *
+ * Nodes are configured using a fluent builder API. Each node has a type
+ * that determines its tick behavior.
+ *
+ * Children are stored in a fixed-capacity inline array (BT_MAX_CHILDREN).
+ * This eliminates external array lifetime dependencies and prevents
+ * out-of-bounds access.
+ *
+ * Callback type is configurable:
+ * - Default: raw function pointers (zero heap, deterministic latency).
+ *   Per-node state should be placed in Context.
+ * - BT_USE_STD_FUNCTION: std::function (allows lambda captures at the
+ *   cost of potential heap allocation).
+ * - BT_USE_INPLACE_FUNCTION: InplaceFunction (allows trivially copyable
+ *   captures up to BT_INPLACE_FUNCTION_SIZE bytes, never allocates).
+ *
+ * With BT_NODE_STATE_SIZE > 0, leaves may instead use a stateful tick
+ * (set_state_tick()) that receives the node's inline NodeState block next
+ * to Context&.
+ *
+ * Memory layout is optimized for cache efficiency:
+ * hot data fields (type, status, child index) are placed first.
+ */
+template <typename Context, typename Observer>
+class Node final {
+  static_assert(!std::is_pointer<Context>::value,
+                "Context must not be a pointer type; use the pointed-to type");
+
+ public:
+  /// Maximum children per node (compile-time configurable).
+  static constexpr uint16_t kMaxChildren =
+      static_cast<uint16_t>(BT_MAX_CHILDREN);
+
+  /// Maximum children for parallel node bitmap tracking.
+  static constexpr uint16_t kMaxParallelChildren = 32U;
+
+  static_assert(kMaxChildren <= 256U, "BT_MAX_CHILDREN too large (max 256)");
+
+#if defined(BT_USE_STD_FUNCTION)
+  /// Tick callback: returns execution status. Called every tick.
+  using TickFn = std::function<Status(Context&)>;
+  /// Lifecycle callback: called on enter/exit transitions.
+  using CallbackFn = std::function<void(Context&)>;
+#if (BT_NODE_STATE_SIZE > 0)
+  /// Stateful tick callback: also receives the node's inline state block.
+  using StateTickFn = std::function<Status(Context&, NodeState&)>;
+#endif
+#elif defined(BT_USE_INPLACE_FUNCTION)
+  /// Tick callback: inline callable (no heap, one indirect call).
+  using TickFn = InplaceFunction<Status(Context&)>;
+  /// Lifecycle callback: inline callable.
+  using CallbackFn = InplaceFunction<void(Context&)>;
+#if (BT_NODE_STATE_SIZE > 0)
+  /// Stateful tick callback: also receives the node's inline state block.
+  using StateTickFn = InplaceFunction<Status(Context&, NodeState&)>;
+#endif
+#else
+  /// Tick callback: raw function pointer (deterministic, no heap).
+  using TickFn = Status (*)(Context&);
+  /// Lifecycle callback: raw function pointer.
+  using CallbackFn = void (*)(Context&);
+#if (BT_NODE_STATE_SIZE > 0)
+  /// Stateful tick callback: also receives the node's inline state block.
+  using StateTickFn = Status (*)(Context&, NodeState&);
+#endif
 #endif
 
   /**
@@ -264,11 +2068,18 @@ class Node final {
         success_policy_(ParallelPolicy::kRequireAll),
         child_done_bits_(0),
         child_success_bits_(0),
+#if defined(BT_NODE_IDS)
+        id_(0),
+#endif
         tick_(nullptr),
+#if (BT_NODE_STATE_SIZE > 0)
+        state_tick_(nullptr),
+#endif
         on_enter_(nullptr),
         on_exit_(nullptr),
         children_{},
-        name_(name) {}
+        name_(name),
+        subtree_(nullptr) {}
 
   // Non-copyable, non-movable
   Node(const Node&) = delete;
@@ -290,6 +2101,19 @@ class Node final {
     return *this;
   }
 
+#if (BT_NODE_STATE_SIZE > 0)
+  /**
+   * @brief Set a stateful tick callback (alternative to set_tick()).
+   *
+   * The callback receives the node's inline NodeState block. If both a
+   * plain and a stateful tick are set, the plain tick takes precedence.
+   */
+  Node& set_state_tick(StateTickFn fn) noexcept {
+    state_tick_ = std::move(fn);
+    return *this;
+  }
+#endif
+
   /** @brief Set the on-enter callback (called when node starts executing). */
   Node& set_on_enter(CallbackFn fn) noexcept {
     on_enter_ = std::move(fn);
@@ -363,6 +2187,23 @@ class Node final {
     return *this;
   }
 
+  /**
+   * @brief Set the source that builds a SUBTREE node's child on demand.
+   * @param source Must outlive the node (see LazySubtree::Attach()).
+   */
+  Node& set_subtree(SubtreeSource<Context, Observer>* source) noexcept {
+    subtree_ = source;
+    return *this;
+  }
+
+#if defined(BT_NODE_IDS)
+  /** @brief Set the node id reported by tracing (see AssignNodeIds()). */
+  Node& set_id(uint16_t id) noexcept {
+    id_ = id;
+    return *this;
+  }
+#endif
+
   // --- Query API (Accessors: lowercase) ---
 
   /** @brief Get node name. */
@@ -371,17 +2212,42 @@ class Node final {
   /** @brief Get node type. */
   NodeType type() const noexcept { return type_; }
 
+#if defined(BT_NODE_IDS)
+  /** @brief Get node id. */
+  uint16_t id() const noexcept { return id_; }
+#endif
+
   /** @brief Get current execution status. */
   Status status() const noexcept { return status_; }
 
   /** @brief Get number of children. */
   uint16_t children_count() const noexcept { return children_count_; }
 
+  /** @brief Get child at index (nullptr if out of range). */
+  Node* child(uint16_t index) const noexcept { return ChildAt(index); }
+
   /** @brief Get current child index (for sequence/selector). */
   uint16_t current_child_index() const noexcept { return current_child_; }
 
-  /** @brief Check if tick callback is set. */
-  bool has_tick() const noexcept { return tick_ != nullptr; }
+  /** @brief Check if a tick callback (plain or stateful) is set. */
+  bool has_tick() const noexcept {
+#if (BT_NODE_STATE_SIZE > 0)
+    return (tick_ != nullptr) || (state_tick_ != nullptr);
+#else
+    return tick_ != nullptr;
+#endif
+  }
+
+#if (BT_NODE_STATE_SIZE > 0)
+  /** @brief Check if a stateful tick callback is set. */
+  bool has_state_tick() const noexcept { return state_tick_ != nullptr; }
+
+  /** @brief Get the inline user-state block. */
+  NodeState& state() noexcept { return state_; }
+
+  /** @brief Get the inline user-state block (const). */
+  const NodeState& state() const noexcept { return state_; }
+#endif
 
   /** @brief Check if on-enter callback is set. */
   bool has_on_enter() const noexcept { return on_enter_ != nullptr; }
@@ -389,9 +2255,26 @@ class Node final {
   /** @brief Check if on-exit callback is set. */
   bool has_on_exit() const noexcept { return on_exit_ != nullptr; }
 
+  /** @brief Get the tick callback (empty for composites). */
+  const TickFn& tick() const noexcept { return tick_; }
+
+#if (BT_NODE_STATE_SIZE > 0)
+  /** @brief Get the stateful tick callback. */
+  const StateTickFn& state_tick() const noexcept { return state_tick_; }
+#endif
+
+  /** @brief Get the on-enter callback. */
+  const CallbackFn& on_enter() const noexcept { return on_enter_; }
+
+  /** @brief Get the on-exit callback. */
+  const CallbackFn& on_exit() const noexcept { return on_exit_; }
+
   /** @brief Get parallel policy. */
   ParallelPolicy parallel_policy() const noexcept { return success_policy_; }
 
+  /** @brief Get the subtree source (nullptr unless SUBTREE). */
+  SubtreeSource<Context, Observer>* subtree() const noexcept { return subtree_; }
+
   /** @brief Check if status is a terminal state (not RUNNING). */
   bool is_finished() const noexcept { return status_ != Status::kRunning; }
 
@@ -409,6 +2292,7 @@ class Node final {
    * - Leaf nodes (ACTION/CONDITION) must have a tick callback
    * - Inverter must have exactly 1 child
    * - Parallel children must not exceed bitmap width (32)
+   * - Subtree must have a source and at most 1 (instantiated) child
    * - Children count must not exceed BT_MAX_CHILDREN
    * - No null children in the array
    */
@@ -425,7 +2309,7 @@ class Node final {
     }
 
     if (IsLeafType(type_)) {
-      if (tick_ == nullptr) {
+      if (!has_tick()) {
         return ValidateError::kLeafMissingTick;
       }
     }
@@ -442,6 +2326,12 @@ class Node final {
       }
     }
 
+    if (type_ == NodeType::kSubtree) {
+      if ((subtree_ == nullptr) || (children_count_ > 1U)) {
+        return ValidateError::kInvalidSubtree;
+      }
+    }
+
     return ValidateError::kNone;
   }
 
@@ -472,26 +2362,31 @@ class Node final {
    * @param ctx Shared context reference.
    * @return Execution status after this tick.
    *
-   * Dispatches to the appropriate tick handler based on node type.
-   * Uses switch for jump-table optimization.
+   * Layers run outside in. With BT_DEADLINE, the active TickWatchdog
+   * checks the budget before and after the tick, and a node entered after
+   * an aborting overrun returns RUNNING untouched. ObservedTick() then
+   * calls Observer::OnTick() first, counts depth and visits for the
+   * enclosing BehaviorTree tick (BT_STATS), adds the result to the active
+   * NodeCounters (BT_COUNTERS), writes the change to the active
+   * StatusStream (BT_STATUS_STREAM), calls Observer::OnStatusChange()
+   * after a change and Observer::OnTickEnd() last. TracedDispatch()
+   * records a TraceEvent into the active TickTracer (BT_TRACE), and
+   * ProfiledDispatch() times the tick into the active TickProfiler
+   * (BT_PROFILE) around the switch on node type that runs the handler.
    */
   BT_HOT Status Tick(Context& ctx) noexcept {
-    switch (type_) {
-      case NodeType::kAction:
-      case NodeType::kCondition:
-        return TickLeaf(ctx);
-      case NodeType::kSequence:
-        return TickSequence(ctx);
-      case NodeType::kSelector:
-        return TickSelector(ctx);
-      case NodeType::kParallel:
-        return TickParallel(ctx);
-      case NodeType::kInverter:
-        return TickInverter(ctx);
-      default:
-        status_ = Status::kError;
-        return Status::kError;
+#if defined(BT_DEADLINE)
+    TickWatchdog* const watchdog = TickWatchdog::Active();
+    if (BT_UNLIKELY(watchdog != nullptr)) {
+      if (watchdog->Enter(id_)) {
+        return Status::kRunning;  // tick aborted: resume here next tick
+      }
+      const Status to = ObservedTick(ctx);
+      watchdog->Exit(id_);
+      return to;
     }
+#endif
+    return ObservedTick(ctx);
   }
 
   /**
@@ -502,6 +2397,9 @@ class Node final {
     current_child_ = 0;
     child_done_bits_ = 0;
     child_success_bits_ = 0;
+#if (BT_NODE_STATE_SIZE > 0)
+    state_.Clear();
+#endif
 
     for (uint16_t i = 0; i < children_count_; ++i) {
       if (children_[i] != nullptr) {
@@ -510,9 +2408,216 @@ class Node final {
     }
   }
 
+  /**
+   * @brief Abort a running subtree: on_exit is called for every RUNNING
+   *        node (children before parents), then the subtree is reset.
+   */
+  void Halt(Context& ctx) noexcept {
+    if (status_ == Status::kRunning) {
+      for (uint16_t i = 0; i < children_count_; ++i) {
+        if (children_[i] != nullptr) {
+          children_[i]->Halt(ctx);
+        }
+      }
+      CallExit(ctx);
+#if defined(BT_COUNTERS)
+      NodeCounters* const counters = NodeCounters::Active();
+      if (counters != nullptr) {
+        counters->Count(id_, Status::kRunning, Status::kFailure);
+      }
+#endif
+#if defined(BT_STATUS_STREAM)
+      StatusStream* const stream = StatusStream::Active();
+      if (stream != nullptr) {
+        stream->Record(id_, Status::kRunning, Status::kFailure);
+      }
+#endif
+      Observer::OnStatusChange(*this, Status::kRunning, Status::kFailure);
+    }
+    Reset();
+  }
+
+  /**
+   * @brief Take over the execution state of an equivalent node (non-recursive).
+   * @param other Node of the same type, typically from a previous version
+   *              of the tree.
+   *
+   * Copies status, resume index, parallel bitmaps and NodeState; indices and
+   * bits beyond this node's children are dropped.
+   */
+  void AdoptState(const Node& other) noexcept {
+    status_ = other.status_;
+    current_child_ =
+        (other.current_child_ < children_count_) ? other.current_child_ : 0U;
+    const uint32_t valid =
+        (children_count_ >= 32U)
+            ? ~static_cast<uint32_t>(0)
+            : ((static_cast<uint32_t>(1) << children_count_) - 1U);
+    child_done_bits_ = other.child_done_bits_ & valid;
+    child_success_bits_ = other.child_success_bits_ & valid;
+#if (BT_NODE_STATE_SIZE > 0)
+    std::memcpy(state_.data(), other.state_.data(), NodeState::kSize);
+#endif
+  }
+
+  // --- Patching API (in-place edits that keep execution state) ---
+
+  /**
+   * @brief Insert a child at @p index, shifting later children up.
+   *
+   * The resume index and parallel bits follow the shifted children, so a
+   * RUNNING parent resumes the same child; a child inserted at or before
+   * the resume point first runs on the parent's next entry.
+   */
+  Node& InsertChild(uint16_t index, Node& child) noexcept {
+    assert((children_count_ < kMaxChildren) && (index <= children_count_));
+    for (uint16_t i = children_count_; i > index; --i) {
+      children_[i] = children_[i - 1U];
+    }
+    children_[index] = &child;
+    ++children_count_;
+    if (index <= current_child_) {
+      ++current_child_;
+    }
+    const uint32_t low = LowBits(index);
+    child_done_bits_ =
+        (child_done_bits_ & low) | ((child_done_bits_ & ~low) << 1);
+    child_success_bits_ =
+        (child_success_bits_ & low) | ((child_success_bits_ & ~low) << 1);
+    return *this;
+  }
+
+  /**
+   * @brief Remove the child at @p index, shifting later children down.
+   *
+   * Halt() the child first if it is RUNNING. A RUNNING parent that was
+   * resuming the removed child continues with the one after it.
+   */
+  Node& RemoveChild(uint16_t index) noexcept {
+    assert(index < children_count_);
+    --children_count_;
+    for (uint16_t i = index; i < children_count_; ++i) {
+      children_[i] = children_[i + 1U];
+    }
+    children_[children_count_] = nullptr;
+    if (index < current_child_) {
+      --current_child_;
+    }
+    const uint32_t low = LowBits(index);
+    child_done_bits_ =
+        (child_done_bits_ & low) | ((child_done_bits_ >> 1) & ~low);
+    child_success_bits_ =
+        (child_success_bits_ & low) | ((child_success_bits_ >> 1) & ~low);
+    return *this;
+  }
+
+  /**
+   * @brief Replace the child at @p index; the new child starts fresh.
+   *
+   * Halt() the old child first if it is RUNNING.
+   */
+  Node& ReplaceChild(uint16_t index, Node& child) noexcept {
+    assert(index < children_count_);
+    children_[index] = &child;
+    const uint32_t bit = ~LowBits(index) & LowBits(index + 1U);
+    child_done_bits_ &= ~bit;
+    child_success_bits_ &= ~bit;
+    return *this;
+  }
+
  private:
   // --- Private helpers (force-inlined for hot path) ---
 
+  /**
+   * @brief Tick() with observer hooks, BT_STATS, BT_COUNTERS and
+   *        BT_STATUS_STREAM.
+   */
+  BT_FORCE_INLINE Status ObservedTick(Context& ctx) noexcept {
+    const Status from = status_;
+    Observer::OnTick(*this);
+#if defined(BT_STATS)
+    TickCounter* const counter = TickCounter::Active();
+    if (BT_LIKELY(counter != nullptr)) {
+      counter->Enter(type_);
+    }
+#endif
+    const Status to = TracedDispatch(ctx, from);
+#if defined(BT_STATS)
+    if (BT_LIKELY(counter != nullptr)) {
+      counter->Exit();
+    }
+#endif
+#if defined(BT_COUNTERS)
+    NodeCounters* const counters = NodeCounters::Active();
+    if (BT_LIKELY(counters != nullptr)) {
+      counters->Count(id_, from, to);
+    }
+#endif
+#if defined(BT_STATUS_STREAM)
+    StatusStream* const stream = StatusStream::Active();
+    if (BT_UNLIKELY(stream != nullptr)) {
+      stream->Record(id_, from, to);
+    }
+#endif
+    if (from != to) {
+      Observer::OnStatusChange(*this, from, to);
+    }
+    Observer::OnTickEnd(*this, to);
+    return to;
+  }
+
+  /** @brief ProfiledDispatch(), recorded if a TickTracer is active. */
+  BT_FORCE_INLINE Status TracedDispatch(Context& ctx, Status from) noexcept {
+#if defined(BT_TRACE)
+    TickTracer* const tracer = TickTracer::Active();
+    if (BT_UNLIKELY(tracer != nullptr)) {
+      const uint64_t start = tracer->Now();
+      const Status to = ProfiledDispatch(ctx);
+      tracer->Record(id_, from, to, start);
+      return to;
+    }
+#else
+    (void)from;
+#endif
+    return ProfiledDispatch(ctx);
+  }
+
+  /** @brief Dispatch(), timed if a TickProfiler is active. */
+  BT_FORCE_INLINE Status ProfiledDispatch(Context& ctx) noexcept {
+#if defined(BT_PROFILE)
+    TickProfiler* const profiler = TickProfiler::Active();
+    if (BT_UNLIKELY(profiler != nullptr)) {
+      const uint64_t start = profiler->Enter(id_);
+      const Status to = Dispatch(ctx);
+      profiler->Exit(id_, start);
+      return to;
+    }
+#endif
+    return Dispatch(ctx);
+  }
+
+  /** @brief Type switch behind Tick(). */
+  BT_FORCE_INLINE Status Dispatch(Context& ctx) noexcept {
+    switch (type_) {
+      case NodeType::kAction:
+      case NodeType::kCondition:
+        return TickLeaf(ctx);
+      case NodeType::kSequence:
+        return TickSequence(ctx);
+      case NodeType::kSelector:
+        return TickSelector(ctx);
+      case NodeType::kParallel:
+        return TickParallel(ctx);
+      case NodeType::kInverter:
+        return TickInverter(ctx);
+      case NodeType::kSubtree:
+        return TickSubtree(ctx);
+      default:
+        status_ = Status::kError;
+        return Status::kError;
+    }
+  }
+
   /** @brief Call on_enter callback if set. */
   BT_FORCE_INLINE void CallEnter(Context& ctx) noexcept {
     if (BT_LIKELY(on_enter_ != nullptr)) {
@@ -527,6 +2632,12 @@ class Node final {
     }
   }
 
+  /** @brief Parallel bitmap mask of children [0, index). */
+  static constexpr uint32_t LowBits(uint32_t index) noexcept {
+    return (index >= 32U) ? ~static_cast<uint32_t>(0)
+                          : ((static_cast<uint32_t>(1) << index) - 1U);
+  }
+
   /** @brief Safe child access with bounds checking. */
   BT_FORCE_INLINE Node* ChildAt(uint16_t index) const noexcept {
     if (BT_LIKELY(index < children_count_)) {
@@ -545,7 +2656,7 @@ class Node final {
    * - on_exit called when returning a terminal state
    */
   BT_HOT Status TickLeaf(Context& ctx) noexcept {
-    if (BT_UNLIKELY(tick_ == nullptr)) {
+    if (BT_UNLIKELY(!has_tick())) {
       status_ = Status::kError;
       return Status::kError;
     }
@@ -554,7 +2665,12 @@ class Node final {
       CallEnter(ctx);
     }
 
+#if (BT_NODE_STATE_SIZE > 0)
+    Status result = (BT_LIKELY(tick_ != nullptr)) ? tick_(ctx)
+                                                  : state_tick_(ctx, state_);
+#else
     Status result = tick_(ctx);
+#endif
     status_ = result;
 
     if (result != Status::kRunning) {
@@ -775,6 +2891,42 @@ class Node final {
     return result;
   }
 
+  /**
+   * @brief Tick a SUBTREE decorator node.
+   *
+   * Builds the child through the source when there is none (first entry,
+   * or after the owner released it), then passes its result through.
+   */
+  Status TickSubtree(Context& ctx) noexcept {
+    if (BT_UNLIKELY(subtree_ == nullptr)) {
+      status_ = Status::kError;
+      return Status::kError;
+    }
+    subtree_->idle_ticks = 0;
+
+    if (children_count_ == 0U) {
+      Node* root = subtree_->instantiate(*subtree_);
+      if (BT_UNLIKELY(root == nullptr)) {
+        status_ = Status::kError;
+        return Status::kError;
+      }
+      SetChild(*root);
+    }
+
+    if (status_ != Status::kRunning) {
+      CallEnter(ctx);
+    }
+
+    const Status result = children_[0]->Tick(ctx);
+    status_ = result;
+
+    if (result != Status::kRunning) {
+      CallExit(ctx);
+    }
+
+    return result;
+  }
+
   // --- Data members (cache-friendly layout: hot fields first) ---
 
   // Hot data (accessed every tick) - first cache line
@@ -785,19 +2937,74 @@ class Node final {
   ParallelPolicy success_policy_;
   uint32_t child_done_bits_;
   uint32_t child_success_bits_;
+#if defined(BT_NODE_IDS)
+  uint16_t id_;
+#endif
 
   // Callbacks
   TickFn tick_;
+#if (BT_NODE_STATE_SIZE > 0)
+  StateTickFn state_tick_;
+#endif
   CallbackFn on_enter_;
   CallbackFn on_exit_;
 
   // Children (fixed-capacity inline array, no external lifetime dependency)
   Node* children_[kMaxChildren];
 
+#if (BT_NODE_STATE_SIZE > 0)
+  // Inline user state (per-node, allocation-free)
+  NodeState state_;
+#endif
+
   // Cold data (rarely accessed)
   const char* name_;
+  SubtreeSource<Context, Observer>* subtree_;  // SUBTREE only
 };
 
+// ============================================================================
+// Node IDs
+// ============================================================================
+
+#if defined(BT_NODE_IDS)
+
+/**
+ * @brief Number the nodes of a tree in pre-order (root = @p first).
+ * @return The id after the last one assigned.
+ *
+ * Recursive, like ValidateTree(). A SUBTREE node's child is numbered
+ * only if it is instantiated; give lazily built roots their own range.
+ */
+template <typename Context, typename Observer>
+uint16_t AssignNodeIds(Node<Context, Observer>& root,
+                       uint16_t first = 0U) noexcept {
+  root.set_id(first);
+  uint16_t next = static_cast<uint16_t>(first + 1U);
+  for (uint16_t i = 0; i < root.children_count(); ++i) {
+    next = AssignNodeIds(*root.child(i), next);
+  }
+  return next;
+}
+
+/**
+ * @brief Fill @p names[id] with the name of every node of a tree.
+ * @param capacity Entries in @p names; nodes with larger ids are skipped.
+ *
+ * Recursive, like AssignNodeIds(). Call after numbering the tree.
+ */
+template <typename Context, typename Observer>
+void CollectNodeNames(const Node<Context, Observer>& root, const char** names,
+                      uint16_t capacity) noexcept {
+  if (root.id() < capacity) {
+    names[root.id()] = root.name();
+  }
+  for (uint16_t i = 0; i < root.children_count(); ++i) {
+    CollectNodeNames(*root.child(i), names, capacity);
+  }
+}
+
+#endif  // BT_NODE_IDS
+
 // ============================================================================
 // BehaviorTree
 // ============================================================================
@@ -805,6 +3012,8 @@ class Node final {
 /**
  * @brief Behavior tree manager template.
  * @tparam Context User-defined context type.
+ * @tparam Observer Static hook policy shared with its nodes (see
+ *         NullObserver).
  *
  * Wraps a root node and shared context, providing a high-level API
  * with execution statistics. The context is passed by reference to all
@@ -816,13 +3025,13 @@ class Node final {
  * 3. Call ValidateTree() once to verify structure
  * 4. Call Tick() in your main loop
  */
-template <typename Context>
+template <typename Context, typename Observer>
 class BehaviorTree final {
   static_assert(!std::is_pointer<Context>::value,
                 "Context must not be a pointer type; use the pointed-to type");
 
  public:
-  using NodeType = Node<Context>;
+  using NodeType = Node<Context, Observer>;
 
   /**
    * @brief Construct a behavior tree.
@@ -832,9 +3041,27 @@ class BehaviorTree final {
   explicit BehaviorTree(NodeType& root, Context& context) noexcept
       : root_(&root),
         context_(context),
+#if defined(BT_TRACE)
+        tracer_(nullptr),
+#endif
+#if defined(BT_PROFILE)
+        profiler_(nullptr),
+#endif
+#if defined(BT_DEADLINE)
+        watchdog_(nullptr),
+#endif
+#if defined(BT_COUNTERS)
+        counters_(nullptr),
+#endif
+#if defined(BT_STATUS_STREAM)
+        stream_(nullptr),
+#endif
         last_status_(Status::kFailure),
-        tick_count_(0),
-        max_tick_depth_(0) {}
+        tick_count_(0) {
+#if defined(BT_STATS)
+    ResetStats();
+#endif
+  }
 
   // Non-copyable, non-movable
   BehaviorTree(const BehaviorTree&) = delete;
@@ -861,7 +3088,30 @@ class BehaviorTree final {
    */
   BT_HOT Status Tick() noexcept {
     ++tick_count_;
+#if defined(BT_TRACE)
+    const TickTracer::Scope trace(tracer_);
+#endif
+#if defined(BT_PROFILE)
+    const TickProfiler::Scope profile(profiler_);
+#endif
+#if defined(BT_DEADLINE)
+    const TickWatchdog::Scope deadline(watchdog_);
+#endif
+#if defined(BT_COUNTERS)
+    const NodeCounters::Scope count(counters_);
+#endif
+#if defined(BT_STATUS_STREAM)
+    const StatusStream::Scope changes(stream_);
+#endif
+    Observer::OnTreeTickBegin(*this);
+#if defined(BT_STATS)
+    TickCounter counter;
     last_status_ = root_->Tick(context_);
+    counter.Commit(stats_, last_status_);
+#else
+    last_status_ = root_->Tick(context_);
+#endif
+    Observer::OnTreeTickEnd(*this, last_status_);
     return last_status_;
   }
 
@@ -875,11 +3125,42 @@ class BehaviorTree final {
     last_status_ = Status::kFailure;
   }
 
+  /**
+   * @brief Halt the whole tree between ticks (see Node::Halt()).
+   *
+   * Unlike root().Halt(context()), the RUNNING -> FAILURE changes reach
+   * this tree's status stream and counters. The halt does not count as a
+   * tick.
+   */
+  void Halt() noexcept {
+    Halt(*root_);
+    last_status_ = Status::kFailure;
+  }
+
+  /** @brief Halt one subtree of this tree between ticks, like Halt(). */
+  void Halt(NodeType& node) noexcept {
+#if defined(BT_COUNTERS)
+    const NodeCounters::Scope count(counters_, false);
+#endif
+#if defined(BT_STATUS_STREAM)
+    const StatusStream::Scope changes(stream_, false);
+#endif
+    node.Halt(context_);
+  }
+
   // --- Accessors (lowercase) ---
 
   /** @brief Get root node reference. */
   NodeType& root() const noexcept { return *root_; }
 
+  /**
+   * @brief Tick @p root from the next Tick() on (between ticks only).
+   *
+   * The previous root is left as it is; halt or reset it first if it may
+   * be RUNNING. Statistics and tick_count() carry over.
+   */
+  void set_root(NodeType& root) noexcept { root_ = &root; }
+
   /** @brief Get mutable context reference. */
   Context& context() noexcept { return context_; }
 
@@ -892,12 +3173,92 @@ class BehaviorTree final {
   /** @brief Get total number of Tick() calls. */
   uint32_t tick_count() const noexcept { return tick_count_; }
 
+#if defined(BT_STATS)
+  /** @brief Get execution statistics since construction or ResetStats(). */
+  const TickStats& stats() const noexcept { return stats_; }
+
+  /** @brief Clear execution statistics. */
+  void ResetStats() noexcept { stats_ = TickStats(); }
+#endif
+
+#if defined(BT_TRACE)
+  /**
+   * @brief Record every node tick of this tree into @p tracer
+   *        (nullptr stops tracing).
+   */
+  void set_tracer(TickTracer* tracer) noexcept { tracer_ = tracer; }
+
+  /** @brief Get the tracer (nullptr if tracing is off). */
+  TickTracer* tracer() const noexcept { return tracer_; }
+#endif
+
+#if defined(BT_PROFILE)
+  /**
+   * @brief Time every node tick of this tree into @p profiler
+   *        (nullptr stops profiling).
+   */
+  void set_profiler(TickProfiler* profiler) noexcept { profiler_ = profiler; }
+
+  /** @brief Get the profiler (nullptr if profiling is off). */
+  TickProfiler* profiler() const noexcept { return profiler_; }
+#endif
+
+#if defined(BT_DEADLINE)
+  /**
+   * @brief Check every tick of this tree against @p watchdog's budget
+   *        (nullptr stops the checks).
+   */
+  void set_watchdog(TickWatchdog* watchdog) noexcept { watchdog_ = watchdog; }
+
+  /** @brief Get the watchdog (nullptr if deadline checks are off). */
+  TickWatchdog* watchdog() const noexcept { return watchdog_; }
+#endif
+
+#if defined(BT_COUNTERS)
+  /**
+   * @brief Count every node tick of this tree into @p counters
+   *        (nullptr stops counting).
+   */
+  void set_counters(NodeCounters* counters) noexcept { counters_ = counters; }
+
+  /** @brief Get the counters (nullptr if counting is off). */
+  NodeCounters* counters() const noexcept { return counters_; }
+#endif
+
+#if defined(BT_STATUS_STREAM)
+  /**
+   * @brief Record status changes of this tree into @p stream
+   *        (nullptr stops recording).
+   */
+  void set_status_stream(StatusStream* stream) noexcept { stream_ = stream; }
+
+  /** @brief Get the status stream (nullptr if recording is off). */
+  StatusStream* status_stream() const noexcept { return stream_; }
+#endif
+
  private:
   NodeType* root_;
   Context& context_;
+#if defined(BT_TRACE)
+  TickTracer* tracer_;
+#endif
+#if defined(BT_PROFILE)
+  TickProfiler* profiler_;
+#endif
+#if defined(BT_DEADLINE)
+  TickWatchdog* watchdog_;
+#endif
+#if defined(BT_COUNTERS)
+  NodeCounters* counters_;
+#endif
+#if defined(BT_STATUS_STREAM)
+  StatusStream* stream_;
+#endif
   Status last_status_;
   uint32_t tick_count_;
-  uint32_t max_tick_depth_;
+#if defined(BT_STATS)
+  TickStats stats_;
+#endif
 };
 
 // ============================================================================
@@ -907,49 +3268,69 @@ class BehaviorTree final {
 namespace factory {
 
 /** @brief Configure a node as an action leaf. */
-template <typename Context>
-Node<Context>& MakeAction(Node<Context>& node,
-                           typename Node<Context>::TickFn tick) {
+template <typename Context, typename Observer>
+Node<Context, Observer>& MakeAction(
+    Node<Context, Observer>& node,
+    typename Node<Context, Observer>::TickFn tick) {
   return node.set_type(NodeType::kAction).set_tick(std::move(tick));
 }
 
 /** @brief Configure a node as a condition leaf. */
-template <typename Context>
-Node<Context>& MakeCondition(Node<Context>& node,
-                              typename Node<Context>::TickFn tick) {
+template <typename Context, typename Observer>
+Node<Context, Observer>& MakeCondition(
+    Node<Context, Observer>& node,
+    typename Node<Context, Observer>::TickFn tick) {
   return node.set_type(NodeType::kCondition).set_tick(std::move(tick));
 }
 
+#if (BT_NODE_STATE_SIZE > 0)
+/** @brief Configure a node as an action leaf with inline state. */
+template <typename Context, typename Observer>
+Node<Context, Observer>& MakeStatefulAction(
+    Node<Context, Observer>& node,
+    typename Node<Context, Observer>::StateTickFn tick) {
+  return node.set_type(NodeType::kAction).set_state_tick(std::move(tick));
+}
+
+/** @brief Configure a node as a condition leaf with inline state. */
+template <typename Context, typename Observer>
+Node<Context, Observer>& MakeStatefulCondition(
+    Node<Context, Observer>& node,
+    typename Node<Context, Observer>::StateTickFn tick) {
+  return node.set_type(NodeType::kCondition).set_state_tick(std::move(tick));
+}
+#endif
+
 /** @brief Configure a node as a sequence composite. */
-template <typename Context>
-Node<Context>& MakeSequence(Node<Context>& node,
-                             Node<Context>* const* children,
-                             uint16_t count) {
+template <typename Context, typename Observer>
+Node<Context, Observer>& MakeSequence(
+    Node<Context, Observer>& node, Node<Context, Observer>* const* children,
+    uint16_t count) {
   return node.set_type(NodeType::kSequence).SetChildren(children, count);
 }
 
 /** @brief Configure a node as a selector composite. */
-template <typename Context>
-Node<Context>& MakeSelector(Node<Context>& node,
-                             Node<Context>* const* children,
-                             uint16_t count) {
+template <typename Context, typename Observer>
+Node<Context, Observer>& MakeSelector(
+    Node<Context, Observer>& node, Node<Context, Observer>* const* children,
+    uint16_t count) {
   return node.set_type(NodeType::kSelector).SetChildren(children, count);
 }
 
 /** @brief Configure a node as a parallel composite. */
-template <typename Context>
-Node<Context>& MakeParallel(Node<Context>& node,
-                             Node<Context>* const* children,
-                             uint16_t count,
-                             ParallelPolicy policy = ParallelPolicy::kRequireAll) {
+template <typename Context, typename Observer>
+Node<Context, Observer>& MakeParallel(
+    Node<Context, Observer>& node, Node<Context, Observer>* const* children,
+    uint16_t count, ParallelPolicy policy = ParallelPolicy::kRequireAll) {
   return node.set_type(NodeType::kParallel)
       .SetChildren(children, count)
       .set_parallel_policy(policy);
 }
 
 /** @brief Configure a node as an inverter decorator. */
-template <typename Context>
-Node<Context>& MakeInverter(Node<Context>& node, Node<Context>& child) {
+template <typename Context, typename Observer>
+Node<Context, Observer>& MakeInverter(Node<Context, Observer>& node,
+                                      Node<Context, Observer>& child) {
   return node.set_type(NodeType::kInverter).SetChild(child);
 }
 
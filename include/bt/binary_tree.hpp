@@ -0,0 +1,754 @@
+/**
+ * @file binary_tree.hpp
+ * @brief Versioned, memory-mappable compiled tree format (.btb).
+ *
+ * Serialize() writes a Node<Context> tree as a flat image; at startup the
+ * file is mapped and ticked in place, with no parsing and no per-node
+ * construction:
+ *
+ * @code
+ *   // build step
+ *   bt::SerializeResult r = bt::Serialize(root, registry, buffer, capacity);
+ *   fwrite(buffer, 1, r.size, file);
+ *
+ *   // every process start
+ *   bt::MappedFile file;
+ *   file.Open("mission.btb");
+ *   bt::BinaryImage image;
+ *   image.Open(file.data(), file.size());        // header checks only
+ *   bt::BoundFunctions<Registry> functions;
+ *   functions.Bind(image, registry);             // O(functions), by name
+ *   std::vector<bt::FlatSlot> slots(image.node_count());
+ *   auto tree = image.MakeExecutor(functions, slots.data(), ctx);
+ *   tree.Tick();
+ * @endcode
+ *
+ * Layout (all sections 4-byte aligned, native byte order):
+ *
+ *   BtbHeader | FlatNode[node_count] | uint32_t child_table[child_count]
+ *             | BtbFunction[function_count] | string table
+ *
+ * Functions are stored by name and bound once at load, so the file does not
+ * depend on registration order. Only the header and section bounds are
+ * checked by Open(); call Verify() once for files from untrusted sources.
+ */
+
+#ifndef BT_BINARY_TREE_HPP_
+#define BT_BINARY_TREE_HPP_
+
+#include "flat_tree.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BT_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bt {
+
+// ============================================================================
+// Format
+// ============================================================================
+
+/** @brief File magic ("BTB\0" in little-endian byte order). */
+static constexpr uint32_t kBtbMagic = 0x00425442U;
+
+/** @brief Current format version; bumped on any layout change. */
+static constexpr uint16_t kBtbVersion = 1U;
+
+/** @brief .btb file header. */
+struct BtbHeader {
+  uint32_t magic;             ///< kBtbMagic
+  uint16_t version;           ///< kBtbVersion
+  uint16_t header_size;       ///< sizeof(BtbHeader)
+  uint32_t total_size;        ///< Image size in bytes
+  uint32_t node_count;        ///< FlatNode records (node 0 = root)
+  uint32_t nodes_offset;
+  uint32_t child_count;       ///< Child index table entries
+  uint32_t children_offset;
+  uint32_t function_count;    ///< BtbFunction records
+  uint32_t functions_offset;
+  uint32_t strings_offset;
+  uint32_t strings_size;
+  uint32_t checksum;          ///< FNV-1a of all bytes after the header
+};
+
+static_assert(sizeof(BtbHeader) == 48U, "BtbHeader layout changed");
+
+/** @brief Function table record (bound by name at load). */
+struct BtbFunction {
+  uint32_t name;              ///< String table offset
+  uint8_t kind;               ///< Registry<>::Kind value
+  uint8_t reserved[3];
+};
+
+/** @brief BtbFunction::kind values (Registry<>::Kind). */
+static constexpr uint8_t kBtbKindTick = 1U;
+static constexpr uint8_t kBtbKindStateTick = 2U;
+static constexpr uint8_t kBtbKindCallback = 3U;
+
+/** @brief Binary format error codes. */
+enum class BinaryError : uint8_t {
+  kNone = 0,                ///< Success
+  kBufferTooSmall,          ///< Output buffer smaller than required size
+  kMisaligned,              ///< Buffer not 4-byte aligned
+  kInvalidNode,             ///< Source node fails Validate() or is SUBTREE
+  kUnregisteredFunction,    ///< Callback not found in the registry
+  kTooDeep,                 ///< Source tree deeper than kBtbMaxDepth
+  kBadMagic,                ///< Not a .btb image (or foreign byte order)
+  kUnsupportedVersion,      ///< Written by an incompatible version
+  kTruncated,               ///< Section extends past the image
+  kCorrupt,                 ///< Index out of range or checksum mismatch
+  kUnknownFunction,         ///< Function name missing from the registry
+  kWrongFunctionKind,       ///< Registered under a different kind
+  kTooManyFunctions,        ///< More functions than the binding table
+  kIoError                  ///< File could not be opened or mapped
+};
+
+/** @brief Convert BinaryError to human-readable string. */
+inline constexpr const char* BinaryErrorToString(BinaryError e) noexcept {
+  return (e == BinaryError::kNone)                  ? "NONE"
+       : (e == BinaryError::kBufferTooSmall)        ? "BUFFER_TOO_SMALL"
+       : (e == BinaryError::kMisaligned)            ? "MISALIGNED"
+       : (e == BinaryError::kInvalidNode)           ? "INVALID_NODE"
+       : (e == BinaryError::kUnregisteredFunction)  ? "UNREGISTERED_FUNCTION"
+       : (e == BinaryError::kTooDeep)               ? "TOO_DEEP"
+       : (e == BinaryError::kBadMagic)              ? "BAD_MAGIC"
+       : (e == BinaryError::kUnsupportedVersion)    ? "UNSUPPORTED_VERSION"
+       : (e == BinaryError::kTruncated)             ? "TRUNCATED"
+       : (e == BinaryError::kCorrupt)               ? "CORRUPT"
+       : (e == BinaryError::kUnknownFunction)       ? "UNKNOWN_FUNCTION"
+       : (e == BinaryError::kWrongFunctionKind)     ? "WRONG_FUNCTION_KIND"
+       : (e == BinaryError::kTooManyFunctions)      ? "TOO_MANY_FUNCTIONS"
+       : (e == BinaryError::kIoError)               ? "IO_ERROR"
+       : "UNKNOWN";
+}
+
+/** @brief Maximum source tree depth accepted by Serialize(). */
+static constexpr uint32_t kBtbMaxDepth = 64U;
+
+/** @brief Result of Serialize(). */
+struct SerializeResult {
+  BinaryError error;          ///< kNone on success
+  size_t size;                ///< Bytes written (or required)
+};
+
+// ============================================================================
+// Serialization
+// ============================================================================
+
+namespace detail {
+
+/** @brief Plain function pointer behind a callback, or nullptr. */
+template <typename R, typename... Args>
+auto RawFunction(R (*fn)(Args...)) noexcept -> R (*)(Args...) {
+  return fn;
+}
+
+template <typename R, typename... Args, size_t Capacity>
+auto RawFunction(const InplaceFunction<R(Args...), Capacity>& fn) noexcept
+    -> R (*)(Args...) {
+  R (*const* target)(Args...) = fn.template target<R (*)(Args...)>();
+  return (target != nullptr) ? *target : nullptr;
+}
+
+#if defined(BT_USE_STD_FUNCTION)
+template <typename R, typename... Args>
+auto RawFunction(const std::function<R(Args...)>& fn) noexcept
+    -> R (*)(Args...) {
+  R (*const* target)(Args...) = fn.template target<R (*)(Args...)>();
+  return (target != nullptr) ? *target : nullptr;
+}
+#endif
+
+inline size_t AlignUp4(size_t n) noexcept {
+  return (n + 3U) & ~static_cast<size_t>(3U);
+}
+
+/** @brief Two-pass writer: pass 1 sizes (out == nullptr), pass 2 writes. */
+template <typename Context, typename RegistryT, typename Observer>
+class BtbWriter final {
+ public:
+  using NodeT = Node<Context, Observer>;
+  using Entry = typename RegistryT::Entry;
+  using Kind = typename RegistryT::Kind;
+
+  explicit BtbWriter(const RegistryT& registry) noexcept
+      : registry_(registry), node_count_(0), child_count_(0),
+        function_count_(0), strings_size_(0), nodes_(nullptr),
+        children_(nullptr), functions_(nullptr), strings_(nullptr) {
+    for (uint16_t i = 0; i < RegistryT::capacity(); ++i) {
+      remap_[i] = kNoFunction;
+    }
+  }
+
+  /** @brief Sizing pass; returns the image size. */
+  BinaryError Measure(const NodeT& root, size_t& size) noexcept {
+    const BinaryError err = Visit(root, 0U, nullptr);
+    if (err != BinaryError::kNone) {
+      return err;
+    }
+    size = Layout(nullptr);
+    return BinaryError::kNone;
+  }
+
+  /** @brief Writing pass into a zeroed buffer of at least Measure() bytes. */
+  void Write(const NodeT& root, unsigned char* out) noexcept {
+    const uint32_t node_count = node_count_;
+    const uint32_t child_count = child_count_;
+    Layout(out);
+    // Counters restart and are re-accumulated while writing
+    node_count_ = 0;
+    child_count_ = 0;
+    function_count_ = 0;
+    strings_size_ = 0;
+    for (uint16_t i = 0; i < RegistryT::capacity(); ++i) {
+      remap_[i] = kNoFunction;
+    }
+    uint32_t root_index = 0;
+    (void)Visit(root, 0U, &root_index);
+    assert((node_count_ == node_count) && (child_count_ == child_count));
+    (void)node_count;
+    (void)child_count;
+
+    BtbHeader& h = *reinterpret_cast<BtbHeader*>(out);
+    const unsigned char* body = out + sizeof(BtbHeader);
+    h.checksum = HashName(reinterpret_cast<const char*>(body),
+                          h.total_size - sizeof(BtbHeader));
+  }
+
+ private:
+  /** @brief Compute section offsets; fill the header when out != nullptr. */
+  size_t Layout(unsigned char* out) noexcept {
+    const size_t nodes_offset = sizeof(BtbHeader);
+    const size_t children_offset =
+        nodes_offset + sizeof(FlatNode) * node_count_;
+    const size_t functions_offset =
+        children_offset + sizeof(uint32_t) * child_count_;
+    const size_t strings_offset =
+        functions_offset + sizeof(BtbFunction) * function_count_;
+    const size_t total = AlignUp4(strings_offset + strings_size_);
+    if (out != nullptr) {
+      BtbHeader& h = *reinterpret_cast<BtbHeader*>(out);
+      h.magic = kBtbMagic;
+      h.version = kBtbVersion;
+      h.header_size = static_cast<uint16_t>(sizeof(BtbHeader));
+      h.total_size = static_cast<uint32_t>(total);
+      h.node_count = node_count_;
+      h.nodes_offset = static_cast<uint32_t>(nodes_offset);
+      h.child_count = child_count_;
+      h.children_offset = static_cast<uint32_t>(children_offset);
+      h.function_count = function_count_;
+      h.functions_offset = static_cast<uint32_t>(functions_offset);
+      h.strings_offset = static_cast<uint32_t>(strings_offset);
+      h.strings_size = strings_size_;
+      h.checksum = 0;
+      nodes_ = reinterpret_cast<FlatNode*>(out + nodes_offset);
+      children_ = reinterpret_cast<uint32_t*>(out + children_offset);
+      functions_ = reinterpret_cast<BtbFunction*>(out + functions_offset);
+      strings_ = reinterpret_cast<char*>(out + strings_offset);
+    }
+    return total;
+  }
+
+  uint32_t AddString(const char* text) noexcept {
+    const uint32_t offset = strings_size_;
+    const size_t length = NameLength(text);
+    if (strings_ != nullptr) {
+      std::memcpy(strings_ + offset, text, length + 1U);
+    }
+    strings_size_ += static_cast<uint32_t>(length + 1U);
+    return offset;
+  }
+
+  /** @brief File-local function index for a registry entry. */
+  uint16_t AddFunction(const Entry& e) noexcept {
+    if (remap_[e.id] == kNoFunction) {
+      remap_[e.id] = static_cast<uint16_t>(function_count_);
+      if (functions_ != nullptr) {
+        BtbFunction& f = functions_[function_count_];
+        f.name = AddString(e.name);
+        f.kind = static_cast<uint8_t>(e.kind);
+      } else {
+        (void)AddString(e.name);
+      }
+      ++function_count_;
+    }
+    return remap_[e.id];
+  }
+
+  using AnyFn = void (*)();
+
+  /** @brief Registry entry of a kind whose raw target equals fn. */
+  template <typename Fn>
+  const Entry* Lookup(Kind kind, Fn fn) const noexcept {
+    if (fn == nullptr) {
+      return nullptr;
+    }
+    for (uint16_t id = 0; id < registry_.size(); ++id) {
+      const Entry* e = registry_.FindById(id);
+      if ((e->kind == kind) && (Target(*e) == reinterpret_cast<AnyFn>(fn))) {
+        return e;
+      }
+    }
+    return nullptr;
+  }
+
+  static AnyFn Target(const Entry& e) noexcept {
+    if (e.kind == Kind::kTick) {
+      return reinterpret_cast<AnyFn>(RawFunction(e.tick));
+    }
+#if (BT_NODE_STATE_SIZE > 0)
+    if (e.kind == Kind::kStateTick) {
+      return reinterpret_cast<AnyFn>(RawFunction(e.state_tick));
+    }
+#endif
+    return reinterpret_cast<AnyFn>(RawFunction(e.callback));
+  }
+
+  BinaryError ResolveCallback(bool present,
+                              const typename NodeT::CallbackFn& fn,
+                              uint16_t& index) noexcept {
+    index = kNoFunction;
+    if (!present) {
+      return BinaryError::kNone;
+    }
+    const Entry* e = Lookup(Kind::kCallback, RawFunction(fn));
+    if (e == nullptr) {
+      return BinaryError::kUnregisteredFunction;
+    }
+    index = AddFunction(*e);
+    return BinaryError::kNone;
+  }
+
+  /**
+   * @brief Pre-order visit. Reserves the node record and its child span
+   *        before recursing, so children of node i follow i in the image.
+   */
+  BinaryError Visit(const NodeT& node, uint32_t depth,
+                    uint32_t* index_out) noexcept {
+    if (depth >= kBtbMaxDepth) {
+      return BinaryError::kTooDeep;
+    }
+    if ((node.Validate() != ValidateError::kNone) ||
+        (node.type() == NodeType::kSubtree)) {  // lazy: nothing to serialize
+      return BinaryError::kInvalidNode;
+    }
+    const uint32_t index = node_count_;
+    ++node_count_;
+    const uint32_t first_child = child_count_;
+    child_count_ += node.children_count();
+
+    FlatNode record{node.type(), node.parallel_policy(), node.children_count(),
+                    first_child, kNoFunction, kNoFunction, kNoFunction, 0U,
+                    AddString(node.name())};
+
+    if (IsLeafType(node.type())) {
+      const Entry* e = Lookup(Kind::kTick, RawFunction(node.tick()));
+#if (BT_NODE_STATE_SIZE > 0)
+      if (e == nullptr) {
+        e = Lookup(Kind::kStateTick, RawFunction(node.state_tick()));
+      }
+#endif
+      if (e == nullptr) {
+        return BinaryError::kUnregisteredFunction;
+      }
+      record.tick = AddFunction(*e);
+    }
+    BinaryError err = ResolveCallback(node.has_on_enter(), node.on_enter(),
+                                      record.on_enter);
+    if (err == BinaryError::kNone) {
+      err = ResolveCallback(node.has_on_exit(), node.on_exit(),
+                            record.on_exit);
+    }
+    if (err != BinaryError::kNone) {
+      return err;
+    }
+
+    for (uint16_t i = 0; i < node.children_count(); ++i) {
+      uint32_t child_index = 0;
+      err = Visit(*node.child(i), depth + 1U, &child_index);
+      if (err != BinaryError::kNone) {
+        return err;
+      }
+      if (children_ != nullptr) {
+        children_[first_child + i] = child_index;
+      }
+    }
+    if (nodes_ != nullptr) {
+      nodes_[index] = record;
+    }
+    if (index_out != nullptr) {
+      *index_out = index;
+    }
+    return BinaryError::kNone;
+  }
+
+  const RegistryT& registry_;
+  uint32_t node_count_;
+  uint32_t child_count_;
+  uint32_t function_count_;
+  uint32_t strings_size_;
+  FlatNode* nodes_;
+  uint32_t* children_;
+  BtbFunction* functions_;
+  char* strings_;
+  uint16_t remap_[RegistryT::capacity()];
+};
+
+}  // namespace detail
+
+/**
+ * @brief Write a tree as a .btb image.
+ * @param root Root of a valid tree.
+ * @param registry Registry holding every callback used by the tree; callbacks
+ *        are matched by their plain function pointer, so leaves must use
+ *        registered functions (or capture-less lambdas stored as such).
+ * @param out 4-byte aligned output buffer (nullptr to query the size).
+ * @param capacity Buffer size in bytes.
+ * @return Error and the written (or required) size.
+ */
+template <typename Context, typename Observer, typename RegistryT>
+SerializeResult Serialize(const Node<Context, Observer>& root,
+                          const RegistryT& registry, void* out,
+                          size_t capacity) noexcept {
+  detail::BtbWriter<Context, RegistryT, Observer> writer(registry);
+  size_t size = 0;
+  const BinaryError err = writer.Measure(root, size);
+  if (err != BinaryError::kNone) {
+    return SerializeResult{err, 0U};
+  }
+  if ((out == nullptr) || (capacity < size)) {
+    return SerializeResult{BinaryError::kBufferTooSmall, size};
+  }
+  if ((reinterpret_cast<uintptr_t>(out) & 3U) != 0U) {
+    return SerializeResult{BinaryError::kMisaligned, size};
+  }
+  std::memset(out, 0, size);
+  writer.Write(root, static_cast<unsigned char*>(out));
+  return SerializeResult{BinaryError::kNone, size};
+}
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+/**
+ * @brief Read-only view of a .btb image (typically a mapped file).
+ *
+ * Holds pointers into the image; nothing is copied.
+ */
+class BinaryImage final {
+ public:
+  BinaryImage() noexcept
+      : header_(nullptr), nodes_(nullptr), children_(nullptr),
+        functions_(nullptr), strings_(nullptr) {}
+
+  /**
+   * @brief Attach to an image. O(1): checks the header and section bounds.
+   * @param data Image start (4-byte aligned; must outlive the view).
+   * @param size Image size in bytes.
+   */
+  BinaryError Open(const void* data, size_t size) noexcept {
+    *this = BinaryImage();
+    if ((reinterpret_cast<uintptr_t>(data) & 3U) != 0U) {
+      return BinaryError::kMisaligned;
+    }
+    if ((data == nullptr) || (size < sizeof(BtbHeader))) {
+      return BinaryError::kTruncated;
+    }
+    const unsigned char* base = static_cast<const unsigned char*>(data);
+    const BtbHeader& h = *reinterpret_cast<const BtbHeader*>(base);
+    if (h.magic != kBtbMagic) {
+      return BinaryError::kBadMagic;
+    }
+    if ((h.version != kBtbVersion) || (h.header_size != sizeof(BtbHeader))) {
+      return BinaryError::kUnsupportedVersion;
+    }
+    // Sections start past the header; Verify() hashes total_size - header
+    if ((h.total_size > size) || (h.total_size < sizeof(BtbHeader)) ||
+        (h.node_count == 0U) || (h.nodes_offset < sizeof(BtbHeader)) ||
+        (h.children_offset < sizeof(BtbHeader)) ||
+        (h.functions_offset < sizeof(BtbHeader)) ||
+        (h.strings_offset < sizeof(BtbHeader)) ||
+        !InBounds(h, h.nodes_offset, sizeof(FlatNode), h.node_count) ||
+        !InBounds(h, h.children_offset, sizeof(uint32_t), h.child_count) ||
+        !InBounds(h, h.functions_offset, sizeof(BtbFunction),
+                  h.function_count) ||
+        !InBounds(h, h.strings_offset, 1U, h.strings_size)) {
+      return BinaryError::kTruncated;
+    }
+    header_ = &h;
+    nodes_ = reinterpret_cast<const FlatNode*>(base + h.nodes_offset);
+    children_ = reinterpret_cast<const uint32_t*>(base + h.children_offset);
+    functions_ =
+        reinterpret_cast<const BtbFunction*>(base + h.functions_offset);
+    strings_ = reinterpret_cast<const char*>(base + h.strings_offset);
+    return BinaryError::kNone;
+  }
+
+  /**
+   * @brief Full structural check, O(image size): checksum, child and
+   *        function indices, function kinds (a tick where a tick is called,
+   *        a callback for on_enter / on_exit), node types and parallel
+   *        policies, the 32-child parallel limit, string offsets and
+   *        pre-order child placement.
+   */
+  BinaryError Verify() const noexcept {
+    if (header_ == nullptr) {
+      return BinaryError::kTruncated;
+    }
+    const unsigned char* body =
+        reinterpret_cast<const unsigned char*>(header_) + sizeof(BtbHeader);
+    if (HashName(reinterpret_cast<const char*>(body),
+                 header_->total_size - sizeof(BtbHeader)) !=
+        header_->checksum) {
+      return BinaryError::kCorrupt;
+    }
+    if ((header_->strings_size == 0U) ||
+        (strings_[header_->strings_size - 1U] != '\0')) {
+      return BinaryError::kCorrupt;
+    }
+    for (uint32_t f = 0; f < header_->function_count; ++f) {
+      if (functions_[f].name >= header_->strings_size) {
+        return BinaryError::kCorrupt;
+      }
+    }
+    for (uint32_t i = 0; i < header_->node_count; ++i) {
+      const FlatNode& n = nodes_[i];
+      if ((n.name >= header_->strings_size) ||
+          (static_cast<uint8_t>(n.type) >
+           static_cast<uint8_t>(NodeType::kInverter)) ||
+          (static_cast<uint8_t>(n.policy) >
+           static_cast<uint8_t>(ParallelPolicy::kRequireOne)) ||
+          ((n.type == NodeType::kParallel) &&
+           (n.child_count > 32U)) ||  // FlatSlot child bitmaps
+          (static_cast<uint64_t>(n.first_child) + n.child_count >
+           header_->child_count) ||
+          !ValidTick(n.tick) || !ValidCallback(n.on_enter) ||
+          !ValidCallback(n.on_exit) ||
+          (IsLeafType(n.type) != (n.tick != kNoFunction))) {
+        return BinaryError::kCorrupt;
+      }
+      for (uint16_t c = 0; c < n.child_count; ++c) {
+        // Pre-order: children come after their parent (rules out cycles)
+        const uint32_t child = children_[n.first_child + c];
+        if ((child <= i) || (child >= header_->node_count)) {
+          return BinaryError::kCorrupt;
+        }
+      }
+    }
+    return BinaryError::kNone;
+  }
+
+  /** @brief Create an executor over this image. */
+  template <typename Context, typename Functions>
+  FlatExecutor<Context, Functions> MakeExecutor(const Functions& functions,
+                                                FlatSlot* slots,
+                                                Context& context) const noexcept {
+    return FlatExecutor<Context, Functions>(nodes_, children_, node_count(),
+                                            functions, slots, context);
+  }
+
+  /** @brief Check if an image is attached. */
+  bool is_open() const noexcept { return header_ != nullptr; }
+
+  const BtbHeader& header() const noexcept { return *header_; }
+  const FlatNode* nodes() const noexcept { return nodes_; }
+  const uint32_t* children() const noexcept { return children_; }
+  uint32_t node_count() const noexcept {
+    return (header_ != nullptr) ? header_->node_count : 0U;
+  }
+  uint32_t function_count() const noexcept {
+    return (header_ != nullptr) ? header_->function_count : 0U;
+  }
+  const BtbFunction& function(uint32_t index) const noexcept {
+    assert(index < function_count());
+    return functions_[index];
+  }
+
+  /** @brief String at a string table offset (node or function name). */
+  const char* string(uint32_t offset) const noexcept {
+    return strings_ + offset;
+  }
+
+  /** @brief Name of node index. */
+  const char* node_name(uint32_t index) const noexcept {
+    assert(index < node_count());
+    return string(nodes_[index].name);
+  }
+
+ private:
+  static bool InBounds(const BtbHeader& h, uint32_t offset, size_t element,
+                       uint32_t count) noexcept {
+    return ((offset & 3U) == 0U || element == 1U) &&
+           (static_cast<uint64_t>(offset) +
+                static_cast<uint64_t>(element) * count <=
+            h.total_size);
+  }
+
+  bool ValidTick(uint16_t index) const noexcept {
+    if (index == kNoFunction) {
+      return true;
+    }
+    return (index < header_->function_count) &&
+           ((functions_[index].kind == kBtbKindTick) ||
+            (functions_[index].kind == kBtbKindStateTick));
+  }
+
+  bool ValidCallback(uint16_t index) const noexcept {
+    return (index == kNoFunction) ||
+           ((index < header_->function_count) &&
+            (functions_[index].kind == kBtbKindCallback));
+  }
+
+  const BtbHeader* header_;
+  const FlatNode* nodes_;
+  const uint32_t* children_;
+  const BtbFunction* functions_;
+  const char* strings_;
+};
+
+/**
+ * @brief Function table of a .btb image bound to a Registry.
+ * @tparam RegistryT Registry<Context, N> type.
+ * @tparam kMaxFunctions Maximum distinct functions per image.
+ *
+ * Satisfies the FlatExecutor Functions interface. Holds pointers to registry
+ * entries, so the registry must outlive the binding.
+ */
+template <typename RegistryT, uint16_t kMaxFunctions = 256U>
+class BoundFunctions final {
+ public:
+  using Entry = typename RegistryT::Entry;
+  using Kind = typename RegistryT::Kind;
+
+  static_assert((static_cast<uint8_t>(Kind::kTick) == kBtbKindTick) &&
+                    (static_cast<uint8_t>(Kind::kStateTick) ==
+                     kBtbKindStateTick) &&
+                    (static_cast<uint8_t>(Kind::kCallback) ==
+                     kBtbKindCallback),
+                "Registry kinds must match the kBtbKind* values");
+
+  BoundFunctions() noexcept : entries_{}, count_(0) {}
+
+  /**
+   * @brief Resolve every function of the image by name. O(functions).
+   * @return kNone, or the first name that is missing / of another kind.
+   */
+  BinaryError Bind(const BinaryImage& image,
+                   const RegistryT& registry) noexcept {
+    count_ = 0;
+    if (image.function_count() > kMaxFunctions) {
+      return BinaryError::kTooManyFunctions;
+    }
+    for (uint32_t f = 0; f < image.function_count(); ++f) {
+      const BtbFunction& fn = image.function(f);
+      const Entry* e = registry.Find(image.string(fn.name));
+      if (e == nullptr) {
+        return BinaryError::kUnknownFunction;
+      }
+      if (static_cast<uint8_t>(e->kind) != fn.kind) {
+        return BinaryError::kWrongFunctionKind;
+      }
+      entries_[f] = e;
+    }
+    count_ = static_cast<uint16_t>(image.function_count());
+    return BinaryError::kNone;
+  }
+
+  /** @brief Invoke a leaf tick function. */
+  template <typename Context>
+  BT_FORCE_INLINE Status Tick(uint16_t id, Context& ctx,
+                              FlatSlot& slot) const noexcept {
+    const Entry& e = *entries_[id];
+#if (BT_NODE_STATE_SIZE > 0)
+    if (BT_UNLIKELY(e.kind == Kind::kStateTick)) {
+      return e.state_tick(ctx, slot.state);
+    }
+#endif
+    (void)slot;
+    return e.tick(ctx);
+  }
+
+  /** @brief Invoke an on_enter / on_exit callback. */
+  template <typename Context>
+  BT_FORCE_INLINE void Call(uint16_t id, Context& ctx) const noexcept {
+    entries_[id]->callback(ctx);
+  }
+
+  /** @brief Number of bound functions. */
+  uint16_t size() const noexcept { return count_; }
+
+ private:
+  const Entry* entries_[kMaxFunctions];
+  uint16_t count_;
+};
+
+// ============================================================================
+// File mapping
+// ============================================================================
+
+#if defined(BT_HAS_MMAP)
+
+/**
+ * @brief Read-only private mapping of a whole file (POSIX mmap).
+ *
+ * Pages are faulted in on first access; untouched parts of the tree are
+ * never read from disk.
+ */
+class MappedFile final {
+ public:
+  MappedFile() noexcept : data_(nullptr), size_(0) {}
+  ~MappedFile() { Close(); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /** @brief Map a file read-only. */
+  BinaryError Open(const char* path) noexcept {
+    Close();
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+      return BinaryError::kIoError;
+    }
+    struct stat st;
+    if ((::fstat(fd, &st) != 0) || (st.st_size <= 0)) {
+      (void)::close(fd);
+      return BinaryError::kIoError;
+    }
+    void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                     MAP_PRIVATE, fd, 0);
+    (void)::close(fd);
+    if (p == MAP_FAILED) {
+      return BinaryError::kIoError;
+    }
+    data_ = p;
+    size_ = static_cast<size_t>(st.st_size);
+    return BinaryError::kNone;
+  }
+
+  /** @brief Unmap. */
+  void Close() noexcept {
+    if (data_ != nullptr) {
+      (void)::munmap(data_, size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+  }
+
+  const void* data() const noexcept { return data_; }
+  size_t size() const noexcept { return size_; }
+
+ private:
+  void* data_;
+  size_t size_;
+};
+
+#endif  // BT_HAS_MMAP
+
+}  // namespace bt
+
+#endif  // BT_BINARY_TREE_HPP_
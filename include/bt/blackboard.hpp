@@ -0,0 +1,328 @@
+/**
+ * @file blackboard.hpp
+ * @brief Structure-of-arrays blackboard for batched multi-agent ticking.
+ *
+ * When the same tree drives many agents, an array-of-structs Context makes
+ * every condition stride across per-agent records. This header provides the
+ * entity-system layout instead: each blackboard key is a Column spanning
+ * all agents, and a tree ticks one agent through an AgentContext view
+ * (board pointer + agent index).
+ *
+ * Batch ticking walks agents in index order, so a condition leaf reading
+ * `ctx.at(&Board::health)` touches consecutive elements of one contiguous,
+ * cache-line aligned column. Results are collected one bit per agent in a
+ * LaneMask (64 agents per word), which ForEachLane() iterates to fall back
+ * to per-agent work only where needed.
+ *
+ * Usage:
+ * @code
+ *   struct Crowd {
+ *     bt::Column<float, 1024> health;
+ *     bt::Column<int32_t, 1024> ammo;
+ *   };
+ *   using AgentCtx = bt::AgentContext<Crowd>;
+ *
+ *   bt::Node<AgentCtx> low_health("LowHealth");
+ *   bt::factory::MakeCondition(low_health, [](AgentCtx& c) {
+ *     return (c.at(&Crowd::health) < 20.0F) ? bt::Status::kSuccess
+ *                                           : bt::Status::kFailure;
+ *   });
+ *
+ *   bt::LaneMask<1024> fleeing;
+ *   bt::TickBatch(low_health, crowd, agent_count, fleeing);
+ * @endcode
+ */
+
+#ifndef BT_BLACKBOARD_HPP_
+#define BT_BLACKBOARD_HPP_
+
+#include "behavior_tree.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace bt {
+
+// ============================================================================
+// Lane helpers
+// ============================================================================
+
+/// Agents per lane block (one bit per agent in a uint64_t word).
+static constexpr uint32_t kLanesPerBlock = 64U;
+
+/** @brief Round an agent count up to whole lane blocks. */
+inline constexpr uint32_t RoundUpToBlock(uint32_t n) noexcept {
+  return (n + (kLanesPerBlock - 1U)) & ~(kLanesPerBlock - 1U);
+}
+
+/** @brief Number of 64-bit lane words needed for n agents. */
+inline constexpr uint32_t LaneWords(uint32_t n) noexcept {
+  return (n + (kLanesPerBlock - 1U)) / kLanesPerBlock;
+}
+
+/** @brief Mask of the valid lanes in word `word_index` for n agents. */
+inline constexpr uint64_t ValidLanes(uint32_t n, uint32_t word_index) noexcept {
+  return ((word_index + 1U) * kLanesPerBlock <= n)
+             ? ~static_cast<uint64_t>(0)
+         : (word_index * kLanesPerBlock >= n)
+             ? static_cast<uint64_t>(0)
+             : ((static_cast<uint64_t>(1) << (n % kLanesPerBlock)) - 1U);
+}
+
+namespace detail {
+
+/** @brief Index of the lowest set bit (word must be non-zero). */
+BT_FORCE_INLINE uint32_t CountTrailingZeros64(uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index = 0;
+  _BitScanForward64(&index, word);
+  return static_cast<uint32_t>(index);
+#else
+  uint32_t index = 0;
+  while ((word & 1U) == 0U) {
+    word >>= 1U;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+}  // namespace detail
+
+// ============================================================================
+// Column
+// ============================================================================
+
+/**
+ * @brief One blackboard key stored contiguously for all agents.
+ * @tparam T Trivial element type (float, int32_t, ...).
+ * @tparam kCapacity Maximum number of agents.
+ *
+ * Storage is 64-byte aligned and padded to whole 64-agent blocks, so batch
+ * kernels may always read full blocks without bounds checks. Padding
+ * elements are zero-initialized.
+ */
+template <typename T, uint32_t kCapacity>
+class Column final {
+  static_assert(std::is_trivial<T>::value, "Column element must be trivial");
+  static_assert(kCapacity > 0U, "Column capacity must be non-zero");
+
+ public:
+  /// Element type.
+  using ValueType = T;
+  /// Allocated elements (capacity rounded up to whole lane blocks).
+  static constexpr uint32_t kPaddedSize = RoundUpToBlock(kCapacity);
+
+  Column() noexcept : values_{} {}
+
+  Column(const Column&) = delete;
+  Column& operator=(const Column&) = delete;
+
+  /** @brief Access one agent's value. */
+  T& operator[](uint32_t agent) noexcept {
+    assert(agent < kCapacity);
+    return values_[agent];
+  }
+
+  /** @brief Access one agent's value (const). */
+  const T& operator[](uint32_t agent) const noexcept {
+    assert(agent < kCapacity);
+    return values_[agent];
+  }
+
+  /** @brief Contiguous column data (kPaddedSize elements). */
+  T* data() noexcept { return values_; }
+
+  /** @brief Contiguous column data (const). */
+  const T* data() const noexcept { return values_; }
+
+  /** @brief Maximum number of agents. */
+  static constexpr uint32_t capacity() noexcept { return kCapacity; }
+
+  /** @brief Set every agent's value. */
+  void Fill(const T& value) noexcept {
+    for (uint32_t i = 0; i < kCapacity; ++i) {
+      values_[i] = value;
+    }
+  }
+
+ private:
+  alignas(64) T values_[kPaddedSize];
+};
+
+// Out-of-line definition for ODR-uses under C++14 (redundant in C++17)
+template <typename T, uint32_t kCapacity>
+constexpr uint32_t Column<T, kCapacity>::kPaddedSize;
+
+// ============================================================================
+// LaneMask
+// ============================================================================
+
+/**
+ * @brief One bit per agent, 64 agents per word.
+ * @tparam kCapacity Maximum number of agents.
+ *
+ * Bit (agent % 64) of word (agent / 64) belongs to `agent`.
+ */
+template <uint32_t kCapacity>
+class LaneMask final {
+  static_assert(kCapacity > 0U, "LaneMask capacity must be non-zero");
+
+ public:
+  /// Number of 64-bit words.
+  static constexpr uint32_t kWordCount = LaneWords(kCapacity);
+
+  LaneMask() noexcept : words_{} {}
+
+  LaneMask(const LaneMask&) = delete;
+  LaneMask& operator=(const LaneMask&) = delete;
+
+  /** @brief Test one agent's bit. */
+  bool Test(uint32_t agent) const noexcept {
+    assert(agent < kCapacity);
+    return ((words_[agent / kLanesPerBlock] >> (agent % kLanesPerBlock)) &
+            1U) != 0U;
+  }
+
+  /** @brief Set or clear one agent's bit. */
+  void Set(uint32_t agent, bool value) noexcept {
+    assert(agent < kCapacity);
+    const uint64_t bit = static_cast<uint64_t>(1) << (agent % kLanesPerBlock);
+    if (value) {
+      words_[agent / kLanesPerBlock] |= bit;
+    } else {
+      words_[agent / kLanesPerBlock] &= ~bit;
+    }
+  }
+
+  /** @brief Clear all bits. */
+  void Clear() noexcept {
+    for (uint32_t i = 0; i < kWordCount; ++i) {
+      words_[i] = 0U;
+    }
+  }
+
+  /** @brief Number of set bits among the first agent_count agents. */
+  uint32_t Count(uint32_t agent_count = kCapacity) const noexcept {
+    uint32_t total = 0;
+    for (uint32_t w = 0; w < LaneWords(agent_count); ++w) {
+      uint64_t word = words_[w] & ValidLanes(agent_count, w);
+      while (word != 0U) {
+        word &= word - 1U;
+        ++total;
+      }
+    }
+    return total;
+  }
+
+  /** @brief Raw word storage (kWordCount words). */
+  uint64_t* words() noexcept { return words_; }
+
+  /** @brief Raw word storage (const). */
+  const uint64_t* words() const noexcept { return words_; }
+
+ private:
+  uint64_t words_[kWordCount];
+};
+
+// Out-of-line definition for ODR-uses under C++14 (redundant in C++17)
+template <uint32_t kCapacity>
+constexpr uint32_t LaneMask<kCapacity>::kWordCount;
+
+// ============================================================================
+// AgentContext
+// ============================================================================
+
+/**
+ * @brief Per-agent view of a structure-of-arrays blackboard.
+ * @tparam Board User struct whose members are Column<T, N> keys.
+ *
+ * Used as the Context of trees that read the SoA blackboard. It is two
+ * words, so batch drivers re-point `agent` instead of copying data.
+ */
+template <typename Board>
+struct AgentContext {
+  Board* board;     ///< Shared blackboard (all agents)
+  uint32_t agent;   ///< Agent index ticked through this view
+
+  /** @brief This agent's value of a column key. */
+  template <typename T, uint32_t N>
+  T& at(Column<T, N> Board::*key) const noexcept {
+    return (board->*key)[agent];
+  }
+};
+
+// ============================================================================
+// Batch ticking
+// ============================================================================
+
+/**
+ * @brief Call fn(agent) for every set lane of one mask word.
+ * @param word Lane bits.
+ * @param first_agent Agent index of bit 0.
+ */
+template <typename Fn>
+BT_FORCE_INLINE void ForEachLane(uint64_t word, uint32_t first_agent, Fn&& fn) {
+  while (word != 0U) {
+    fn(first_agent + detail::CountTrailingZeros64(word));
+    word &= word - 1U;
+  }
+}
+
+/**
+ * @brief Call fn(agent) for every set lane among the first agent_count.
+ */
+template <uint32_t N, typename Fn>
+void ForEachLane(const LaneMask<N>& mask, uint32_t agent_count, Fn&& fn) {
+  assert(agent_count <= N);
+  for (uint32_t w = 0; w < LaneWords(agent_count); ++w) {
+    ForEachLane(mask.words()[w] & ValidLanes(agent_count, w),
+                w * kLanesPerBlock, fn);
+  }
+}
+
+/**
+ * @brief Tick one shared subtree for agents [0, agent_count), in order.
+ * @param node Subtree root, evaluated once per agent.
+ * @param board SoA blackboard.
+ * @param agent_count Number of agents to evaluate.
+ * @param success Receives one bit per agent (set on SUCCESS).
+ * @return Number of agents for which the subtree succeeded.
+ *
+ * The subtree's execution state is shared by all agents, so it must be
+ * stateless across ticks: conditions and composites of conditions, which
+ * never return RUNNING. Agents that run long actions keep their own tree.
+ */
+template <typename Board, uint32_t N, typename Observer>
+uint32_t TickBatch(Node<AgentContext<Board>, Observer>& node, Board& board,
+                   uint32_t agent_count, LaneMask<N>& success) noexcept {
+  assert(agent_count <= N);
+  AgentContext<Board> ctx{&board, 0U};
+  uint32_t total = 0;
+
+  for (uint32_t w = 0; w < LaneWords(agent_count); ++w) {
+    uint64_t bits = 0;
+    const uint32_t first = w * kLanesPerBlock;
+    const uint32_t last = (first + kLanesPerBlock < agent_count)
+                              ? (first + kLanesPerBlock)
+                              : agent_count;
+    for (uint32_t a = first; a < last; ++a) {
+      ctx.agent = a;
+      const Status s = node.Tick(ctx);
+      assert(s != Status::kRunning);
+      if (s == Status::kSuccess) {
+        bits |= static_cast<uint64_t>(1) << (a - first);
+        ++total;
+      }
+    }
+    success.words()[w] = bits;
+  }
+  return total;
+}
+
+}  // namespace bt
+
+#endif  // BT_BLACKBOARD_HPP_
@@ -0,0 +1,271 @@
+/**
+ * @file chrome_trace.hpp
+ * @brief Chrome Trace Event (chrome://tracing, Perfetto) export of
+ *        TickTracer events.
+ *
+ * Each TraceEvent becomes a complete ("X") event on the track of its tree,
+ * so nested node ticks show up as a flame chart per tick. A node that goes
+ * RUNNING also opens an async span ("b") that is closed ("e") by the tick
+ * that leaves RUNNING. These spans cover the whole multi-tick action on
+ * a separate row.
+ *
+ * @code
+ *   const char* names[64] = {};
+ *   bt::CollectNodeNames(root, names, 64);
+ *
+ *   std::FILE* f = std::fopen("bt_trace.json", "w");
+ *   bt::ChromeTraceWriter writer(f);
+ *   writer.NameTrack(1, "npc_tree");
+ *
+ *   // consumer thread, while the tree ticks
+ *   writer.Drain(tracer, 1, names, 64);
+ *
+ *   writer.Finish();
+ *   std::fclose(f);
+ * @endcode
+ *
+ * The writer runs on the consumer thread and formats into a fixed
+ * internal buffer. It never allocates, and the tick thread only ever pays
+ * for TickTracer::Record(). Timestamps are relative to the start of the
+ * first event written; its enclosing parents get small negative ones. A
+ * RUNNING span whose node is halted instead of ticked to completion stays
+ * open until the end of the capture.
+ *
+ * Requires BT_TRACE.
+ */
+
+#ifndef BT_CHROME_TRACE_HPP_
+#define BT_CHROME_TRACE_HPP_
+
+#include <cstdio>
+
+#include "behavior_tree.hpp"
+
+#if !defined(BT_TRACE)
+#error "chrome_trace.hpp requires BT_TRACE"
+#endif
+
+namespace bt {
+
+/**
+ * @brief Streams TraceEvents to a FILE* as Chrome Trace Event JSON.
+ *
+ * Not thread-safe; use it from the one thread that drains the tracers.
+ */
+class ChromeTraceWriter final {
+ public:
+  /// Events drained from a tracer per batch.
+  static constexpr uint32_t kDrainBatch = 64U;
+
+  /** @brief Start the JSON document on @p out (must outlive the writer). */
+  explicit ChromeTraceWriter(std::FILE* out) noexcept
+      : out_(out), used_(0), origin_ns_(0), has_origin_(false),
+        first_(true), ok_(out != nullptr), events_(0), buffer_{} {
+    Append("{\"traceEvents\":[\n");
+  }
+
+  ChromeTraceWriter(const ChromeTraceWriter&) = delete;
+  ChromeTraceWriter& operator=(const ChromeTraceWriter&) = delete;
+
+  /** @brief Label track @p track in the viewer (a "thread_name" record). */
+  void NameTrack(uint32_t track, const char* name) noexcept {
+    BeginRecord();
+    Format("{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\","
+           "\"args\":{\"name\":",
+           track);
+    AppendString(name);
+    Append("}}");
+  }
+
+  /**
+   * @brief Write @p count events recorded on @p track.
+   * @param names Node names by id (see CollectNodeNames()); ids without a
+   *              name are written as "node <id>".
+   */
+  void Write(const TraceEvent* events, uint32_t count, uint32_t track,
+             const char* const* names, uint16_t name_count) noexcept {
+    for (uint32_t i = 0; i < count; ++i) {
+      WriteEvent(events[i], track, names, name_count);
+    }
+  }
+
+  /**
+   * @brief Drain @p tracer completely onto @p track.
+   * @return Number of events written.
+   */
+  uint32_t Drain(TickTracer& tracer, uint32_t track, const char* const* names,
+                 uint16_t name_count) noexcept {
+    TraceEvent batch[kDrainBatch];
+    uint32_t total = 0;
+    uint32_t n = 0;
+    do {
+      n = tracer.Drain(batch, kDrainBatch);
+      Write(batch, n, track, names, name_count);
+      total += n;
+    } while (n == kDrainBatch);
+    return total;
+  }
+
+  /**
+   * @brief Close the JSON document and flush.
+   * @return false if any write to the file failed.
+   */
+  bool Finish() noexcept {
+    Append("\n]}\n");
+    Flush();
+    if (out_ != nullptr) {
+      ok_ = ok_ && (std::fflush(out_) == 0);
+    }
+    return ok_;
+  }
+
+  /** @brief Node tick events written so far. */
+  uint64_t events() const noexcept { return events_; }
+
+ private:
+  static constexpr uint32_t kBufferSize = 4096U;
+  static constexpr uint32_t kMaxRecord = 512U;  // flushed below this
+  static constexpr uint32_t kMaxFormat = 160U;  // longest Format() output
+
+  void WriteEvent(const TraceEvent& e, uint32_t track,
+                  const char* const* names, uint16_t name_count) noexcept {
+    if (!has_origin_) {
+      origin_ns_ = e.start_ns;
+      has_origin_ = true;
+    }
+    // Parents are recorded after their children, so they may start
+    // before the origin: keep the offset signed.
+    const int64_t start = static_cast<int64_t>(e.start_ns - origin_ns_);
+    const int64_t end = start + static_cast<int64_t>(e.duration_ns);
+    const char* const name =
+        ((names != nullptr) && (e.node_id < name_count)) ? names[e.node_id]
+                                                         : nullptr;
+
+    BeginRecord();
+    Append("{\"ph\":\"X\",\"pid\":1,\"tid\":");
+    Format("%u,\"ts\":", track);
+    AppendMicros(start);
+    Append(",\"dur\":");
+    AppendMicros(e.duration_ns);
+    Append(",\"name\":");
+    AppendName(name, e.node_id);
+    Format(",\"args\":{\"id\":%u,\"from\":\"%s\",\"to\":\"%s\"}}",
+           static_cast<unsigned>(e.node_id), StatusToString(e.from),
+           StatusToString(e.to));
+    ++events_;
+
+    if ((e.from != Status::kRunning) && (e.to == Status::kRunning)) {
+      WriteAsync('b', start, track, e.node_id, name);
+    } else if ((e.from == Status::kRunning) && (e.to != Status::kRunning)) {
+      WriteAsync('e', end, track, e.node_id, name);
+    }
+  }
+
+  void WriteAsync(char phase, int64_t ts, uint32_t track, uint16_t node_id,
+                  const char* name) noexcept {
+    BeginRecord();
+    Format("{\"ph\":\"%c\",\"cat\":\"running\",\"pid\":1,\"tid\":%u,"
+           "\"id\":\"%x.%x\",\"ts\":",
+           phase, track, track, static_cast<unsigned>(node_id));
+    AppendMicros(ts);
+    Append(",\"name\":");
+    AppendName(name, node_id);
+    Append("}");
+  }
+
+  void BeginRecord() noexcept {
+    if ((kBufferSize - used_) < kMaxRecord) {
+      Flush();
+    }
+    if (!first_) {
+      Append(",\n");
+    }
+    first_ = false;
+  }
+
+  void AppendName(const char* name, uint16_t node_id) noexcept {
+    if (name != nullptr) {
+      AppendString(name);
+    } else {
+      Format("\"node %u\"", static_cast<unsigned>(node_id));
+    }
+  }
+
+  /* Nanoseconds as microseconds with three decimals. */
+  void AppendMicros(int64_t ns) noexcept {
+    const uint64_t abs_ns = (ns < 0) ? (0U - static_cast<uint64_t>(ns))
+                                     : static_cast<uint64_t>(ns);
+    Format("%s%llu.%03u", (ns < 0) ? "-" : "",
+           static_cast<unsigned long long>(abs_ns / 1000U),
+           static_cast<unsigned>(abs_ns % 1000U));
+  }
+
+  /* JSON string; long names are truncated to keep one record bounded. */
+  void AppendString(const char* s) noexcept {
+    static const char kHex[] = "0123456789abcdef";
+    Put('"');
+    for (uint32_t n = 0; (s != nullptr) && (*s != '\0') && (n < 128U);
+         ++s, ++n) {
+      const unsigned char c = static_cast<unsigned char>(*s);
+      if ((c == '"') || (c == '\\')) {
+        Put('\\');
+        Put(static_cast<char>(c));
+      } else if (c < 0x20U) {
+        Append("\\u00");
+        Put(kHex[c >> 4U]);
+        Put(kHex[c & 0x0FU]);
+      } else {
+        Put(static_cast<char>(c));
+      }
+    }
+    Put('"');
+  }
+
+  template <typename... Args>
+  void Format(const char* fmt, Args... args) noexcept {
+    if ((kBufferSize - used_) < kMaxFormat) {
+      Flush();
+    }
+    const int n = std::snprintf(buffer_ + used_, kBufferSize - used_, fmt,
+                                args...);
+    if (n > 0) {
+      const uint32_t len = static_cast<uint32_t>(n);
+      used_ += (len < (kBufferSize - used_)) ? len : (kBufferSize - used_ - 1U);
+    }
+  }
+
+  void Append(const char* s) noexcept {
+    while (*s != '\0') {
+      Put(*s);
+      ++s;
+    }
+  }
+
+  void Put(char c) noexcept {
+    if (used_ + 1U >= kBufferSize) {
+      Flush();
+    }
+    buffer_[used_] = c;
+    ++used_;
+  }
+
+  void Flush() noexcept {
+    if ((out_ != nullptr) && (used_ > 0U)) {
+      ok_ = ok_ && (std::fwrite(buffer_, 1, used_, out_) == used_);
+    }
+    used_ = 0;
+  }
+
+  std::FILE* out_;
+  uint32_t used_;
+  uint64_t origin_ns_;
+  bool has_origin_;
+  bool first_;
+  bool ok_;
+  uint64_t events_;
+  char buffer_[kBufferSize];
+};
+
+}  // namespace bt
+
+#endif  // BT_CHROME_TRACE_HPP_
@@ -0,0 +1,111 @@
+/**
+ * @file codegen.hpp
+ * @brief Runtime support for trees compiled to C++ by tools/bt_codegen.
+ *
+ * bt_codegen turns a tree description (the XML accepted by LoadXml) into a
+ * header with one class per tree. Every node becomes a member function of
+ * straight-line code: leaf functions and lifecycle callbacks are called by
+ * name, composites tick their children in order and resume a RUNNING child
+ * through an explicit jump table of labels. Execution state is one FlatSlot
+ * per node, indexed in pre-order like FlatExecutor, so the generated class
+ * behaves exactly like ticking the same tree through Node<Context>:
+ *
+ * @code
+ *   // CMake: generate at build time
+ *   add_custom_command(OUTPUT mission_tree.hpp
+ *       COMMAND bt_codegen --class MissionTree --context Robot
+ *               --include robot_leaves.hpp mission.xml mission_tree.hpp
+ *       DEPENDS bt_codegen mission.xml)
+ *
+ *   // Application
+ *   #include "mission_tree.hpp"
+ *   MissionTree tree(robot);
+ *   while (tree.Tick() == bt::Status::kRunning) {}
+ * @endcode
+ *
+ * This header holds the few helpers the generated code shares; it is not
+ * needed to write trees by hand.
+ */
+
+#ifndef BT_CODEGEN_HPP_
+#define BT_CODEGEN_HPP_
+
+#include "flat_tree.hpp"
+
+namespace bt {
+namespace codegen {
+
+/** @brief Call a plain leaf tick (the slot's NodeState is unused). */
+template <typename Context>
+BT_FORCE_INLINE Status InvokeTick(Status (*fn)(Context&), Context& ctx,
+                                  FlatSlot& /*slot*/) noexcept {
+  return fn(ctx);
+}
+
+#if (BT_NODE_STATE_SIZE > 0)
+/** @brief Call a stateful leaf tick with the slot's NodeState. */
+template <typename Context>
+BT_FORCE_INLINE Status InvokeTick(Status (*fn)(Context&, NodeState&),
+                                  Context& ctx, FlatSlot& slot) noexcept {
+  return fn(ctx, slot.state);
+}
+#endif
+
+/** @brief Inverter result mapping (RUNNING / ERROR pass through). */
+BT_FORCE_INLINE constexpr Status Invert(Status s) noexcept {
+  return (s == Status::kSuccess)   ? Status::kFailure
+       : (s == Status::kFailure)   ? Status::kSuccess
+       : s;
+}
+
+/** @brief Per-tick child tally of an unrolled Parallel node. */
+struct ParallelCounts {
+  uint16_t running = 0;
+  uint16_t success = 0;
+  uint16_t failure = 0;
+
+  /** @brief Count a child finished on an earlier tick; true if it was. */
+  BT_FORCE_INLINE bool Finished(const FlatSlot& s, uint32_t mask) noexcept {
+    if ((s.child_done_bits & mask) == 0U) {
+      return false;
+    }
+    if ((s.child_success_bits & mask) != 0U) {
+      ++success;
+    } else {
+      ++failure;
+    }
+    return true;
+  }
+
+  /** @brief Record a child's status for this tick. */
+  BT_FORCE_INLINE void Record(FlatSlot& s, uint32_t mask,
+                              Status child_status) noexcept {
+    if (child_status == Status::kRunning) {
+      ++running;
+    } else if (child_status == Status::kSuccess) {
+      s.child_done_bits |= mask;
+      s.child_success_bits |= mask;
+      ++success;
+    } else {
+      s.child_done_bits |= mask;
+      ++failure;
+    }
+  }
+
+  /** @brief Parallel result under the given policy. */
+  BT_FORCE_INLINE Status Resolve(ParallelPolicy policy) const noexcept {
+    if (policy == ParallelPolicy::kRequireOne) {
+      return (success > 0U)   ? Status::kSuccess
+           : (running > 0U)   ? Status::kRunning
+           : Status::kFailure;
+    }
+    return (failure > 0U)   ? Status::kFailure
+         : (running > 0U)   ? Status::kRunning
+         : Status::kSuccess;
+  }
+};
+
+}  // namespace codegen
+}  // namespace bt
+
+#endif  // BT_CODEGEN_HPP_
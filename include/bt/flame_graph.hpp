@@ -0,0 +1,107 @@
+/**
+ * @file flame_graph.hpp
+ * @brief Collapsed-stack ("folded") output of TickProfiler path costs.
+ *
+ * Writes one line per root-to-node path recorded by a TickProfiler with a
+ * path table, in the format read by flamegraph.pl, inferno and speedscope:
+ *
+ *   Root;Patrol;ReadSensor 12345
+ *
+ * The weight of a line is the time spent in the path's last node alone.
+ * The viewers sum each frame's descendants, so every frame is drawn as
+ * wide as its inclusive time. Weights are in the profiler's clock units
+ * (cycles with the default rdtsc clock).
+ *
+ * @code
+ *   static bt::NodeProfile nodes[256];
+ *   static bt::PathSlot paths[1024];
+ *   bt::TickProfiler profiler(nodes, 256);
+ *   profiler.set_paths(paths, 1024);
+ *   tree.set_profiler(&profiler);
+ *   // ... tick many times, possibly many agents' trees ...
+ *   bt::WriteFoldedStacks(profiler, names, 256, file);
+ * @endcode
+ *
+ * Trees of many agents that share node ids (same template, same
+ * AssignNodeIds() numbering) fold into the same paths. Requires BT_PROFILE.
+ */
+
+#ifndef BT_FLAME_GRAPH_HPP_
+#define BT_FLAME_GRAPH_HPP_
+
+#include <cstdio>
+
+#include "behavior_tree.hpp"
+
+#if !defined(BT_PROFILE)
+#error "flame_graph.hpp requires BT_PROFILE"
+#endif
+
+namespace bt {
+
+namespace detail {
+
+/* Node name with the folded-format separators ';' and '\n' replaced. */
+inline void WriteFoldedFrame(std::FILE* out, const char* const* names,
+                             uint16_t name_count, uint16_t node_id) noexcept {
+  const char* name =
+      ((names != nullptr) && (node_id < name_count)) ? names[node_id] : nullptr;
+  if (name == nullptr) {
+    std::fprintf(out, "node %u", static_cast<unsigned>(node_id));
+    return;
+  }
+  for (; *name != '\0'; ++name) {
+    const char c = *name;
+    std::fputc((c == ';') ? ':' : (((c == '\n') || (c == '\r')) ? ' ' : c),
+               out);
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Write every recorded path of @p profiler as a folded stack.
+ * @param names Node names by id (see CollectNodeNames()); ids without a
+ *              name are written as "node <id>".
+ * @return Number of lines written. Paths whose weight is 0 are skipped.
+ *
+ * Call between ticks, on the tick thread.
+ */
+inline uint32_t WriteFoldedStacks(const TickProfiler& profiler,
+                                  const char* const* names,
+                                  uint16_t name_count,
+                                  std::FILE* out) noexcept {
+  const PathSlot* const paths = profiler.paths();
+  if ((paths == nullptr) || (out == nullptr)) {
+    return 0;
+  }
+  uint32_t lines = 0;
+  uint16_t stack[BT_PROFILE_MAX_DEPTH];
+  for (uint32_t i = 0; i < profiler.path_capacity(); ++i) {
+    const PathSlot& leaf = paths[i];
+    if ((leaf.key == 0U) || (leaf.exclusive == 0U)) {
+      continue;
+    }
+    // Walk up to the root; a missing ancestor (table full) cuts the stack.
+    uint32_t depth = 0;
+    for (const PathSlot* p = &leaf;
+         (p != nullptr) && (depth < BT_PROFILE_MAX_DEPTH);
+         p = profiler.FindPath(p->parent)) {
+      stack[depth] = p->node_id;
+      ++depth;
+    }
+    while (depth > 0U) {
+      --depth;
+      detail::WriteFoldedFrame(out, names, name_count, stack[depth]);
+      std::fputc((depth > 0U) ? ';' : ' ', out);
+    }
+    std::fprintf(out, "%llu\n",
+                 static_cast<unsigned long long>(leaf.exclusive));
+    ++lines;
+  }
+  return lines;
+}
+
+}  // namespace bt
+
+#endif  // BT_FLAME_GRAPH_HPP_
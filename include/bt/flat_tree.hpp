@@ -0,0 +1,346 @@
+/**
+ * @file flat_tree.hpp
+ * @brief Position-independent node records and their interpreter.
+ *
+ * A flat tree separates what a Node<Context> mixes together:
+ *
+ * - Topology (read-only): an array of FlatNode records in pre-order plus a
+ *   child index table. Records hold indices instead of pointers, so the
+ *   arrays can live in a memory-mapped file or in ROM unchanged.
+ * - Execution state (writable): one FlatSlot per node, supplied by the
+ *   caller as a separate block.
+ * - Callbacks: referenced by 16-bit function index and resolved through a
+ *   Functions table (see BoundFunctions in binary_tree.hpp).
+ *
+ * FlatExecutor ticks such a tree with exactly the semantics of Node::Tick(),
+ * including on_enter / on_exit timing and parallel bookkeeping.
+ */
+
+#ifndef BT_FLAT_TREE_HPP_
+#define BT_FLAT_TREE_HPP_
+
+#include "registry.hpp"
+
+namespace bt {
+
+// ============================================================================
+// Records
+// ============================================================================
+
+/**
+ * @brief One node of a flat tree (20 bytes, trivially copyable).
+ *
+ * Children of node i are child_table[first_child .. first_child +
+ * child_count). Function fields hold kNoFunction when unused.
+ */
+struct FlatNode {
+  NodeType type;            ///< Node type
+  ParallelPolicy policy;    ///< Parallel success policy
+  uint16_t child_count;     ///< Number of children
+  uint32_t first_child;     ///< First entry in the child index table
+  uint16_t tick;            ///< Leaf tick function index
+  uint16_t on_enter;        ///< on_enter callback index
+  uint16_t on_exit;         ///< on_exit callback index
+  uint16_t reserved;        ///< Must be 0
+  uint32_t name;            ///< Name (string table offset)
+};
+
+static_assert(sizeof(FlatNode) == 20U, "FlatNode layout changed");
+static_assert(std::is_trivially_copyable<FlatNode>::value,
+              "FlatNode must be trivially copyable");
+
+/** @brief Per-node execution state of a flat tree (writable block). */
+struct FlatSlot {
+  Status status;              ///< Last status
+  uint16_t current_child;     ///< Resume index (Sequence / Selector)
+  uint32_t child_done_bits;   ///< Parallel: finished children
+  uint32_t child_success_bits;///< Parallel: succeeded children
+#if (BT_NODE_STATE_SIZE > 0)
+  NodeState state;            ///< Stateful tick user block
+#endif
+
+  /** @brief Initial state; constexpr so static slot arrays need no startup code. */
+  constexpr FlatSlot() noexcept
+      : status(Status::kFailure), current_child(0), child_done_bits(0),
+        child_success_bits(0)
+#if (BT_NODE_STATE_SIZE > 0)
+        , state()
+#endif
+  {}
+
+  /** @brief Return to the initial (never ticked) state. */
+  void Reset() noexcept {
+    status = Status::kFailure;
+    current_child = 0;
+    child_done_bits = 0;
+    child_success_bits = 0;
+#if (BT_NODE_STATE_SIZE > 0)
+    state.Clear();
+#endif
+  }
+};
+
+// ============================================================================
+// Interpreter
+// ============================================================================
+
+/**
+ * @brief Ticks a flat tree.
+ * @tparam Context User-defined context type.
+ * @tparam Functions Callback table providing
+ *         `Status Tick(uint16_t id, Context&, FlatSlot&) const` and
+ *         `void Call(uint16_t id, Context&) const`.
+ *
+ * The records, child table and function table are only read; all mutation
+ * goes to the slot block, so one topology can back many executors.
+ */
+template <typename Context, typename Functions>
+class FlatExecutor final {
+ public:
+  /**
+   * @brief Construct an executor (node 0 is the root).
+   * @param nodes Pre-ordered node records.
+   * @param children Child index table.
+   * @param node_count Number of records (and slots).
+   * @param functions Callback table.
+   * @param slots Writable state, one per node (must outlive the executor).
+   * @param context Shared context (must outlive the executor).
+   */
+  FlatExecutor(const FlatNode* nodes, const uint32_t* children,
+               uint32_t node_count, const Functions& functions,
+               FlatSlot* slots, Context& context) noexcept
+      : nodes_(nodes), children_(children), node_count_(node_count),
+        functions_(functions), slots_(slots), context_(context),
+        last_status_(Status::kFailure), tick_count_(0) {}
+
+  FlatExecutor(const FlatExecutor&) = delete;
+  FlatExecutor& operator=(const FlatExecutor&) = delete;
+  FlatExecutor(FlatExecutor&&) noexcept = default;
+
+  /** @brief Execute one tick from the root. */
+  BT_HOT Status Tick() noexcept {
+    ++tick_count_;
+    last_status_ = (node_count_ > 0U) ? TickNode(0U) : Status::kError;
+    return last_status_;
+  }
+
+  /** @brief Reset all slots to their initial state. */
+  void Reset() noexcept {
+    for (uint32_t i = 0; i < node_count_; ++i) {
+      slots_[i].Reset();
+    }
+    last_status_ = Status::kFailure;
+  }
+
+  /** @brief Status of node index (pre-order). */
+  Status status(uint32_t index) const noexcept {
+    assert(index < node_count_);
+    return slots_[index].status;
+  }
+
+  /** @brief Execution state of node index. */
+  FlatSlot& slot(uint32_t index) noexcept {
+    assert(index < node_count_);
+    return slots_[index];
+  }
+
+  /** @brief Node record at index. */
+  const FlatNode& node(uint32_t index) const noexcept {
+    assert(index < node_count_);
+    return nodes_[index];
+  }
+
+  /** @brief Number of nodes. */
+  uint32_t node_count() const noexcept { return node_count_; }
+
+  /** @brief Get mutable context reference. */
+  Context& context() noexcept { return context_; }
+
+  /** @brief Get the status from the last Tick() call. */
+  Status last_status() const noexcept { return last_status_; }
+
+  /** @brief Get total number of Tick() calls. */
+  uint32_t tick_count() const noexcept { return tick_count_; }
+
+ private:
+  BT_FORCE_INLINE void CallEnter(const FlatNode& n) noexcept {
+    if (n.on_enter != kNoFunction) {
+      functions_.Call(n.on_enter, context_);
+    }
+  }
+
+  BT_FORCE_INLINE void CallExit(const FlatNode& n) noexcept {
+    if (n.on_exit != kNoFunction) {
+      functions_.Call(n.on_exit, context_);
+    }
+  }
+
+  BT_HOT Status TickNode(uint32_t index) noexcept {
+    const FlatNode& n = nodes_[index];
+    FlatSlot& s = slots_[index];
+    switch (n.type) {
+      case NodeType::kAction:
+      case NodeType::kCondition:
+        return TickLeaf(n, s);
+      case NodeType::kSequence:
+        return TickSequence(n, s);
+      case NodeType::kSelector:
+        return TickSelector(n, s);
+      case NodeType::kParallel:
+        return TickParallel(n, s);
+      case NodeType::kInverter:
+        return TickInverter(n, s);
+      default:
+        s.status = Status::kError;
+        return Status::kError;
+    }
+  }
+
+  BT_HOT Status TickLeaf(const FlatNode& n, FlatSlot& s) noexcept {
+    if (BT_UNLIKELY(n.tick == kNoFunction)) {
+      s.status = Status::kError;
+      return Status::kError;
+    }
+    if (s.status != Status::kRunning) {
+      CallEnter(n);
+    }
+    const Status result = functions_.Tick(n.tick, context_, s);
+    s.status = result;
+    if (result != Status::kRunning) {
+      CallExit(n);
+    }
+    return result;
+  }
+
+  BT_HOT Status TickSequence(const FlatNode& n, FlatSlot& s) noexcept {
+    if (s.status != Status::kRunning) {
+      s.current_child = 0;
+      CallEnter(n);
+    }
+    for (uint16_t i = s.current_child; i < n.child_count; ++i) {
+      const Status child_status = TickNode(children_[n.first_child + i]);
+      if (child_status == Status::kRunning) {
+        s.current_child = i;
+        s.status = Status::kRunning;
+        return Status::kRunning;
+      }
+      if (child_status != Status::kSuccess) {
+        s.current_child = i;
+        s.status = child_status;
+        CallExit(n);
+        return child_status;
+      }
+    }
+    s.status = Status::kSuccess;
+    CallExit(n);
+    return Status::kSuccess;
+  }
+
+  BT_HOT Status TickSelector(const FlatNode& n, FlatSlot& s) noexcept {
+    if (s.status != Status::kRunning) {
+      s.current_child = 0;
+      CallEnter(n);
+    }
+    for (uint16_t i = s.current_child; i < n.child_count; ++i) {
+      const Status child_status = TickNode(children_[n.first_child + i]);
+      if (child_status == Status::kRunning) {
+        s.current_child = i;
+        s.status = Status::kRunning;
+        return Status::kRunning;
+      }
+      if ((child_status == Status::kSuccess) ||
+          BT_UNLIKELY(child_status == Status::kError)) {
+        s.current_child = i;
+        s.status = child_status;
+        CallExit(n);
+        return child_status;
+      }
+    }
+    s.status = Status::kFailure;
+    CallExit(n);
+    return Status::kFailure;
+  }
+
+  BT_HOT Status TickParallel(const FlatNode& n, FlatSlot& s) noexcept {
+    if (s.status != Status::kRunning) {
+      s.child_done_bits = 0;
+      s.child_success_bits = 0;
+      CallEnter(n);
+    }
+
+    uint16_t running_count = 0;
+    uint16_t success_count = 0;
+    uint16_t failure_count = 0;
+
+    for (uint16_t i = 0; i < n.child_count; ++i) {
+      const uint32_t bit_mask = (static_cast<uint32_t>(1) << i);
+      if ((s.child_done_bits & bit_mask) != 0U) {
+        if ((s.child_success_bits & bit_mask) != 0U) {
+          ++success_count;
+        } else {
+          ++failure_count;
+        }
+        continue;
+      }
+      const Status child_status = TickNode(children_[n.first_child + i]);
+      if (child_status == Status::kRunning) {
+        ++running_count;
+      } else if (child_status == Status::kSuccess) {
+        s.child_done_bits |= bit_mask;
+        s.child_success_bits |= bit_mask;
+        ++success_count;
+      } else {
+        s.child_done_bits |= bit_mask;
+        ++failure_count;
+      }
+    }
+
+    Status result;
+    if (n.policy == ParallelPolicy::kRequireOne) {
+      result = (success_count > 0U)   ? Status::kSuccess
+             : (running_count > 0U)   ? Status::kRunning
+             : Status::kFailure;
+    } else {
+      result = (failure_count > 0U)   ? Status::kFailure
+             : (running_count > 0U)   ? Status::kRunning
+             : Status::kSuccess;
+    }
+    s.status = result;
+    if (result != Status::kRunning) {
+      CallExit(n);
+    }
+    return result;
+  }
+
+  Status TickInverter(const FlatNode& n, FlatSlot& s) noexcept {
+    if (BT_UNLIKELY(n.child_count != 1U)) {
+      s.status = Status::kError;
+      return Status::kError;
+    }
+    if (s.status != Status::kRunning) {
+      CallEnter(n);
+    }
+    const Status child_status = TickNode(children_[n.first_child]);
+    const Status result = (child_status == Status::kSuccess)   ? Status::kFailure
+                        : (child_status == Status::kFailure)   ? Status::kSuccess
+                        : child_status;  // RUNNING/ERROR unchanged
+    s.status = result;
+    if (result != Status::kRunning) {
+      CallExit(n);
+    }
+    return result;
+  }
+
+  const FlatNode* nodes_;
+  const uint32_t* children_;
+  uint32_t node_count_;
+  const Functions& functions_;
+  FlatSlot* slots_;
+  Context& context_;
+  Status last_status_;
+  uint32_t tick_count_;
+};
+
+}  // namespace bt
+
+#endif  // BT_FLAT_TREE_HPP_
@@ -0,0 +1,309 @@
+/**
+ * @file guard_program.hpp
+ * @brief Bit-sliced boolean guards: AND/OR/NOT over 64 agents per word.
+ *
+ * Boolean blackboard entries are stored bit-sliced in a FlagColumn (one
+ * uint64_t per flag per 64 agents). A condition-only subtree -- condition
+ * leaves combined by kInverter, kSequence, kSelector and kParallel -- is
+ * compiled once into a GuardProgram, a short postfix program that
+ * evaluates the subtree for 64 agents with one word operation per node:
+ *
+ *   Condition leaf  -> load the leaf's flag / mask word
+ *   Inverter        -> NOT
+ *   Sequence        -> AND          Parallel(RequireAll) -> AND
+ *   Selector        -> OR           Parallel(RequireOne) -> OR
+ *
+ * This matches Node::Tick() for leaves that only return SUCCESS/FAILURE,
+ * which is why nodes with on_enter/on_exit callbacks or actions are
+ * rejected at compile time. Agents whose guard passes are then ticked
+ * individually (see ForEachLane()), so per-agent dispatch is only paid by
+ * lanes that actually reach actions.
+ *
+ * Usage:
+ * @code
+ *   struct Crowd {
+ *     bt::FlagColumn<4096> alive, armed, hidden;
+ *   };
+ *   // can_attack = Sequence(alive, armed, Inverter(hidden))
+ *   const bt::FlagBinding flags[] = {{"Alive", crowd.alive.words()},
+ *                                    {"Armed", crowd.armed.words()},
+ *                                    {"Hidden", crowd.hidden.words()}};
+ *   bt::GuardProgram<AgentCtx> program;
+ *   program.Compile(can_attack, flags, 3);
+ *   program.Evaluate(agent_count, attack_lanes);
+ *   bt::ForEachLane(attack_lanes, agent_count,
+ *                   [&](uint32_t a) { agent_trees[a]->Tick(); });
+ * @endcode
+ */
+
+#ifndef BT_GUARD_PROGRAM_HPP_
+#define BT_GUARD_PROGRAM_HPP_
+
+#include "blackboard.hpp"
+
+namespace bt {
+
+/**
+ * @brief Bit-sliced boolean blackboard column (one bit per agent).
+ *
+ * Same layout as LaneMask, so flags, batch-condition results and guard
+ * program outputs are interchangeable, and MaskCondition<> reads any of
+ * them from per-agent trees.
+ */
+template <uint32_t kCapacity>
+using FlagColumn = LaneMask<kCapacity>;
+
+/** @brief Name-to-flag binding used to resolve condition leaves. */
+struct FlagBinding {
+  const char* name;        ///< Condition node name (matched with strcmp)
+  const uint64_t* words;   ///< Bit-sliced flag / mask words
+};
+
+/** @brief GuardProgram compilation error codes. */
+enum class GuardError : uint8_t {
+  kNone = 0,            ///< Compiled successfully
+  kUnboundCondition,    ///< Condition leaf has no flag binding
+  kUnsupportedNode,     ///< Action, lifecycle callback or unknown type
+  kProgramTooLarge,     ///< More nodes than kMaxInstructions
+  kTooDeep,             ///< Operand stack exceeds kMaxStack
+  kNullChild            ///< Null pointer in children array
+};
+
+/** @brief Convert GuardError to human-readable string. */
+inline constexpr const char* GuardErrorToString(GuardError e) noexcept {
+  return (e == GuardError::kNone)              ? "NONE"
+       : (e == GuardError::kUnboundCondition)  ? "UNBOUND_CONDITION"
+       : (e == GuardError::kUnsupportedNode)   ? "UNSUPPORTED_NODE"
+       : (e == GuardError::kProgramTooLarge)   ? "PROGRAM_TOO_LARGE"
+       : (e == GuardError::kTooDeep)           ? "TOO_DEEP"
+       : (e == GuardError::kNullChild)         ? "NULL_CHILD"
+       : "UNKNOWN";
+}
+
+/**
+ * @brief Compiled condition-only subtree, evaluated 64 agents per word.
+ * @tparam Context Context type of the source tree.
+ * @tparam kMaxInstructions Maximum program length (one per node).
+ * @tparam Observer Observer policy of the source tree.
+ */
+template <typename Context, uint16_t kMaxInstructions = 64U,
+          typename Observer = NullObserver>
+class GuardProgram final {
+ public:
+  using NodeT = Node<Context, Observer>;
+
+  /// Maximum operand stack depth during evaluation.
+  static constexpr uint16_t kMaxStack = 32U;
+
+  /**
+   * @brief Leaf resolver: returns the words for a condition leaf, or
+   *        nullptr if the leaf cannot be evaluated bit-sliced.
+   */
+  using Resolver = const uint64_t* (*)(const NodeT& leaf, void* user);
+
+  GuardProgram() noexcept : instructions_{}, count_(0) {}
+
+  GuardProgram(const GuardProgram&) = delete;
+  GuardProgram& operator=(const GuardProgram&) = delete;
+
+  /**
+   * @brief Compile a condition-only subtree.
+   * @param root Subtree root.
+   * @param resolve Maps condition leaves to bit-sliced words.
+   * @param user Opaque pointer forwarded to resolve.
+   * @return GuardError::kNone on success; the program is empty otherwise.
+   */
+  GuardError Compile(const NodeT& root, Resolver resolve,
+                     void* user) noexcept {
+    count_ = 0;
+    uint16_t depth = 0;
+    const GuardError err = Emit(root, resolve, user, depth);
+    if (err != GuardError::kNone) {
+      count_ = 0;
+    }
+    return err;
+  }
+
+  /**
+   * @brief Compile, resolving condition leaves by node name.
+   * @param root Subtree root.
+   * @param bindings Name-to-words table.
+   * @param count Number of bindings.
+   */
+  GuardError Compile(const NodeT& root, const FlagBinding* bindings,
+                     uint32_t count) noexcept {
+    BindingTable table{bindings, count};
+    return Compile(root, &ResolveByName, &table);
+  }
+
+  /**
+   * @brief Evaluate the subtree for one 64-agent word.
+   * @param word Word index (agents [word*64, word*64+64)).
+   * @return Success mask for those agents.
+   */
+  uint64_t EvaluateWord(uint32_t word) const noexcept {
+    uint64_t stack[kMaxStack];
+    uint16_t top = 0;
+    for (uint16_t i = 0; i < count_; ++i) {
+      const Instruction& in = instructions_[i];
+      switch (in.op) {
+        case Op::kLoad:
+          stack[top] = in.words[word];
+          ++top;
+          break;
+        case Op::kNot:
+          stack[top - 1U] = ~stack[top - 1U];
+          break;
+        case Op::kAnd: {
+          uint64_t acc = ~static_cast<uint64_t>(0);
+          for (uint16_t k = 0; k < in.arity; ++k) {
+            --top;
+            acc &= stack[top];
+          }
+          stack[top] = acc;
+          ++top;
+          break;
+        }
+        case Op::kOr: {
+          uint64_t acc = 0;
+          for (uint16_t k = 0; k < in.arity; ++k) {
+            --top;
+            acc |= stack[top];
+          }
+          stack[top] = acc;
+          ++top;
+          break;
+        }
+        default:
+          break;
+      }
+    }
+    return (top == 1U) ? stack[0] : 0U;
+  }
+
+  /**
+   * @brief Evaluate the subtree for agents [0, agent_count).
+   * @param agent_count Number of agents.
+   * @param out Success bit per agent; lanes >= agent_count are 0.
+   * @return Number of agents for which the subtree succeeds.
+   */
+  template <uint32_t N>
+  uint32_t Evaluate(uint32_t agent_count, LaneMask<N>& out) const noexcept {
+    assert(agent_count <= N);
+    for (uint32_t w = 0; w < LaneWords(agent_count); ++w) {
+      out.words()[w] = EvaluateWord(w) & ValidLanes(agent_count, w);
+    }
+    return out.Count(agent_count);
+  }
+
+  /** @brief Number of compiled instructions (0 if not compiled). */
+  uint16_t size() const noexcept { return count_; }
+
+  /** @brief Check if a program is loaded. */
+  bool empty() const noexcept { return count_ == 0U; }
+
+ private:
+  enum class Op : uint8_t { kLoad = 0, kNot, kAnd, kOr };
+
+  struct Instruction {
+    Op op;
+    uint16_t arity;
+    const uint64_t* words;
+  };
+
+  struct BindingTable {
+    const FlagBinding* bindings;
+    uint32_t count;
+  };
+
+  static const uint64_t* ResolveByName(const NodeT& leaf,
+                                       void* user) noexcept {
+    const BindingTable* table = static_cast<const BindingTable*>(user);
+    for (uint32_t i = 0; i < table->count; ++i) {
+      if (std::strcmp(table->bindings[i].name, leaf.name()) == 0) {
+        return table->bindings[i].words;
+      }
+    }
+    return nullptr;
+  }
+
+  GuardError Push(Op op, uint16_t arity, const uint64_t* words) noexcept {
+    if (count_ >= kMaxInstructions) {
+      return GuardError::kProgramTooLarge;
+    }
+    instructions_[count_] = Instruction{op, arity, words};
+    ++count_;
+    return GuardError::kNone;
+  }
+
+  /** @brief Emit postfix code; depth tracks the operand stack. */
+  GuardError Emit(const NodeT& node, Resolver resolve, void* user,
+                  uint16_t& depth) noexcept {
+    if (node.has_on_enter() || node.has_on_exit()) {
+      return GuardError::kUnsupportedNode;
+    }
+    GuardError err = GuardError::kNone;
+
+    switch (node.type()) {
+      case NodeType::kCondition: {
+        const uint64_t* words = resolve(node, user);
+        if (words == nullptr) {
+          return GuardError::kUnboundCondition;
+        }
+        ++depth;
+        if (depth > kMaxStack) {
+          return GuardError::kTooDeep;
+        }
+        return Push(Op::kLoad, 0U, words);
+      }
+      case NodeType::kInverter: {
+        if (node.children_count() != 1U) {
+          return GuardError::kUnsupportedNode;
+        }
+        const NodeT* child = node.child(0);
+        if (child == nullptr) {
+          return GuardError::kNullChild;
+        }
+        err = Emit(*child, resolve, user, depth);
+        if (err != GuardError::kNone) {
+          return err;
+        }
+        return Push(Op::kNot, 1U, nullptr);
+      }
+      case NodeType::kSequence:
+      case NodeType::kSelector:
+      case NodeType::kParallel: {
+        const uint16_t n = node.children_count();
+        for (uint16_t i = 0; i < n; ++i) {
+          const NodeT* child = node.child(i);
+          if (child == nullptr) {
+            return GuardError::kNullChild;
+          }
+          err = Emit(*child, resolve, user, depth);
+          if (err != GuardError::kNone) {
+            return err;
+          }
+        }
+        const bool is_and =
+            (node.type() == NodeType::kSequence) ||
+            ((node.type() == NodeType::kParallel) &&
+             (node.parallel_policy() == ParallelPolicy::kRequireAll));
+        // n operands are replaced by one result (identity if n == 0)
+        depth = static_cast<uint16_t>(depth - n + 1U);
+        if (depth > kMaxStack) {
+          return GuardError::kTooDeep;
+        }
+        return Push(is_and ? Op::kAnd : Op::kOr, n, nullptr);
+      }
+      default:
+        return GuardError::kUnsupportedNode;
+    }
+  }
+
+  Instruction instructions_[kMaxInstructions];
+  uint16_t count_;
+};
+
+}  // namespace bt
+
+#endif  // BT_GUARD_PROGRAM_HPP_
@@ -0,0 +1,331 @@
+/**
+ * @file hot_reload.hpp
+ * @brief Double-buffered tree handle swapped at tick boundaries.
+ *
+ * ReloadableTree wraps a BehaviorTree whose definition changes at
+ * runtime. A builder thread constructs the new version (e.g. LoadXml() into
+ * a second NodeArena), and Publish() validates it on that thread and hands
+ * it over through a single atomic slot. The tick thread picks it up at the
+ * start of the next Tick(), so the loop never blocks and never observes a
+ * half-built tree. Ticks go through BehaviorTree::Tick(), so observer hooks
+ * and the tracer, profiler, watchdog, counters and status stream set on
+ * tree() apply as usual:
+ *
+ * @code
+ *   // tick thread
+ *   bt::ReloadableTree<Ctx> tree(initial_root, ctx, bt::ReloadPolicy::kMapState);
+ *   tree.tree().set_tracer(&tracer);                // BT_TRACE builds
+ *   for (;;) { tree.Tick(); }
+ *
+ *   // builder thread (two arenas, used alternately)
+ *   NodeArena<Ctx>& arena = arenas[next];
+ *   arena.Clear();                                  // previous version retired
+ *   LoadResult<Ctx> r = LoadXml(xml, len, registry, arena);
+ *   if (tree.Publish(*r.root) == bt::ReloadError::kNone) {
+ *     next ^= 1U;
+ *   }
+ *   while (tree.TakeRetired() == nullptr) { wait; } // old root no longer used
+ * @endcode
+ *
+ * On swap the old tree is either halted (on_exit for running nodes, new
+ * tree starts fresh) or its execution state is mapped onto the new tree:
+ * a new node adopts the state of the old node with the same name, type and
+ * child count (node ID = name + type); running old nodes without a
+ * counterpart are halted through BehaviorTree::Halt(), while old nodes whose
+ * state moved on are left idle without on_exit. Either way the halts reach
+ * the status stream and counters attached to tree().
+ */
+
+#ifndef BT_HOT_RELOAD_HPP_
+#define BT_HOT_RELOAD_HPP_
+
+#include <atomic>
+
+#include "registry.hpp"
+
+namespace bt {
+
+/** @brief What happens to running nodes when a new tree is swapped in. */
+enum class ReloadPolicy : uint8_t {
+  kHalt = 0,     ///< Halt the old tree; the new tree starts from scratch
+  kMapState      ///< Carry state over to matching nodes (by name + type)
+};
+
+/** @brief Publish() error codes. */
+enum class ReloadError : uint8_t {
+  kNone = 0,         ///< Published; swapped in at the next Tick()
+  kInvalidTree,      ///< New tree fails ValidateTree()
+  kBusy              ///< Previous version not yet swapped in or retired
+};
+
+/** @brief Convert ReloadError to human-readable string. */
+inline constexpr const char* ReloadErrorToString(ReloadError e) noexcept {
+  return (e == ReloadError::kNone)        ? "NONE"
+       : (e == ReloadError::kInvalidTree) ? "INVALID_TREE"
+       : (e == ReloadError::kBusy)        ? "BUSY"
+       : "UNKNOWN";
+}
+
+/**
+ * @brief Behavior tree handle whose definition can be replaced while ticking.
+ * @tparam Context User-defined context type.
+ * @tparam kMaxNodes Largest tree whose state can be mapped; bigger trees
+ *         fall back to ReloadPolicy::kHalt.
+ * @tparam Observer Static hook policy of the nodes (see NullObserver).
+ *
+ * Tick(), Reset() and the accessors belong to the tick thread; Publish()
+ * and TakeRetired() to a single builder thread.
+ */
+template <typename Context, uint16_t kMaxNodes = 1024U,
+          typename Observer = NullObserver>
+class ReloadableTree final {
+ public:
+  using TreeType = BehaviorTree<Context, Observer>;
+  using NodeType = Node<Context, Observer>;
+
+  /**
+   * @brief Construct with an initial tree.
+   * @param root Initial root (must stay valid until retired).
+   * @param context Shared context (must outlive the handle).
+   * @param policy Swap policy.
+   */
+  ReloadableTree(NodeType& root, Context& context,
+                 ReloadPolicy policy = ReloadPolicy::kHalt) noexcept
+      : tree_(root, context), policy_(policy), reload_count_(0),
+        pending_(nullptr), retired_(nullptr), old_count_(0) {}
+
+  ReloadableTree(const ReloadableTree&) = delete;
+  ReloadableTree& operator=(const ReloadableTree&) = delete;
+  ReloadableTree(ReloadableTree&&) = delete;
+  ReloadableTree& operator=(ReloadableTree&&) = delete;
+
+  // --- Tick thread ---
+
+  /**
+   * @brief Swap in a published tree if there is one, then tick.
+   *
+   * Without a pending tree the only extra cost over BehaviorTree::Tick() is
+   * one relaxed atomic load.
+   */
+  BT_HOT Status Tick() noexcept {
+    if (BT_UNLIKELY(pending_.load(std::memory_order_relaxed) != nullptr)) {
+      Swap();
+    }
+    return tree_.Tick();
+  }
+
+  /** @brief Reset the current tree to initial state. */
+  void Reset() noexcept { tree_.Reset(); }
+
+  /** @brief Change the swap policy (tick thread). */
+  void set_policy(ReloadPolicy policy) noexcept { policy_ = policy; }
+
+  /** @brief Current root (tick thread). */
+  NodeType& root() const noexcept { return tree_.root(); }
+
+  /**
+   * @brief Underlying tree, whose root follows the swaps (tick thread).
+   *
+   * Use it to attach a tracer, profiler, watchdog, counters or status
+   * stream, or to read the statistics.
+   */
+  TreeType& tree() noexcept { return tree_; }
+
+  /** @brief Get mutable context reference. */
+  Context& context() noexcept { return tree_.context(); }
+
+  /** @brief Get the status from the last Tick() call. */
+  Status last_status() const noexcept { return tree_.last_status(); }
+
+  /** @brief Get total number of Tick() calls. */
+  uint32_t tick_count() const noexcept { return tree_.tick_count(); }
+
+  /** @brief Number of trees swapped in so far. */
+  uint32_t reload_count() const noexcept { return reload_count_; }
+
+  // --- Builder thread ---
+
+  /**
+   * @brief Validate a new tree and queue it for the next tick boundary.
+   * @param root New root; must not share nodes with the current tree and
+   *        must stay valid until it is retired in turn.
+   */
+  ReloadError Publish(NodeType& root) noexcept {
+    if ((pending_.load(std::memory_order_acquire) != nullptr) ||
+        (retired_.load(std::memory_order_acquire) != nullptr)) {
+      return ReloadError::kBusy;
+    }
+    if (root.ValidateTree() != ValidateError::kNone) {
+      return ReloadError::kInvalidTree;
+    }
+    pending_.store(&root, std::memory_order_release);
+    return ReloadError::kNone;
+  }
+
+  /**
+   * @brief Take the root replaced by the last swap.
+   * @return Old root (no longer referenced by the tick thread; its storage
+   *         may be reused), or nullptr if nothing was retired since.
+   */
+  NodeType* TakeRetired() noexcept {
+    return retired_.exchange(nullptr, std::memory_order_acquire);
+  }
+
+  /** @brief Check if a published tree is waiting for the next tick. */
+  bool has_pending() const noexcept {
+    return pending_.load(std::memory_order_acquire) != nullptr;
+  }
+
+ private:
+  static constexpr uint32_t kTableSize = 2U * kMaxNodes;
+  static constexpr uint16_t kEmptySlot = 0xFFFFU;
+  static_assert((kTableSize & (kTableSize - 1U)) == 0U,
+                "kMaxNodes must be a power of two");
+
+  void Swap() noexcept {
+    NodeType* next = pending_.load(std::memory_order_acquire);
+    NodeType* old = &tree_.root();
+    next->Reset();
+    if ((policy_ == ReloadPolicy::kMapState) && CollectOld(*old) &&
+        Fits(*next)) {
+      MapState(*next);
+    } else {
+      tree_.Halt();
+    }
+    tree_.set_root(*next);
+    ++reload_count_;
+    // Retire before freeing the slot: Publish() sees both or neither
+    retired_.store(old, std::memory_order_release);
+    pending_.store(nullptr, std::memory_order_release);
+  }
+
+  static uint32_t KeyHash(const NodeType& node) noexcept {
+    return HashName(node.name(), NameLength(node.name())) ^
+           static_cast<uint32_t>(node.type());
+  }
+
+  static bool SameId(const NodeType& a, const NodeType& b) noexcept {
+    return (a.type() == b.type()) &&
+           (a.children_count() == b.children_count()) &&
+           (std::strcmp(a.name(), b.name()) == 0);
+  }
+
+  /** @brief Gather the old tree in pre-order and index it by node ID. */
+  bool CollectOld(NodeType& root) noexcept {
+    old_count_ = 0;
+    uint16_t stack_top = 0;
+    stack_[stack_top++] = &root;
+    while (stack_top > 0U) {
+      NodeType* node = stack_[--stack_top];
+      if (old_count_ >= kMaxNodes) {
+        return false;
+      }
+      old_[old_count_] = node;
+      ++old_count_;
+      for (uint16_t i = node->children_count(); i > 0U; --i) {
+        NodeType* child = node->child(static_cast<uint16_t>(i - 1U));
+        if (child != nullptr) {
+          if (stack_top >= kMaxNodes) {
+            return false;
+          }
+          stack_[stack_top++] = child;
+        }
+      }
+    }
+    for (uint32_t s = 0; s < kTableSize; ++s) {
+      table_[s] = kEmptySlot;
+    }
+    for (uint16_t i = 0; i < old_count_; ++i) {
+      consumed_[i] = false;
+      uint32_t slot = KeyHash(*old_[i]) & (kTableSize - 1U);
+      while (table_[slot] != kEmptySlot) {
+        slot = (slot + 1U) & (kTableSize - 1U);
+      }
+      table_[slot] = i;
+    }
+    return true;
+  }
+
+  /** @brief Check that @p root has at most kMaxNodes nodes. */
+  bool Fits(NodeType& root) noexcept {
+    uint32_t count = 0;
+    uint16_t stack_top = 0;
+    stack_[stack_top++] = &root;
+    while (stack_top > 0U) {
+      NodeType* node = stack_[--stack_top];
+      if (++count > kMaxNodes) {
+        return false;
+      }
+      for (uint16_t i = 0; i < node->children_count(); ++i) {
+        NodeType* child = node->child(i);
+        if (child != nullptr) {
+          if (stack_top >= kMaxNodes) {
+            return false;
+          }
+          stack_[stack_top++] = child;
+        }
+      }
+    }
+    return true;
+  }
+
+  /** @brief First unconsumed old node with the same ID, or nullptr. */
+  NodeType* TakeMatch(const NodeType& node) noexcept {
+    uint32_t slot = KeyHash(node) & (kTableSize - 1U);
+    while (table_[slot] != kEmptySlot) {
+      const uint16_t i = table_[slot];
+      if (!consumed_[i] && SameId(*old_[i], node)) {
+        consumed_[i] = true;
+        return old_[i];
+      }
+      slot = (slot + 1U) & (kTableSize - 1U);
+    }
+    return nullptr;
+  }
+
+  void MapState(NodeType& root) noexcept {
+    uint16_t stack_top = 0;
+    stack_[stack_top++] = &root;
+    while (stack_top > 0U) {
+      NodeType* node = stack_[--stack_top];
+      const NodeType* match = TakeMatch(*node);
+      if (match != nullptr) {
+        node->AdoptState(*match);
+      }
+      for (uint16_t i = node->children_count(); i > 0U; --i) {
+        NodeType* child = node->child(static_cast<uint16_t>(i - 1U));
+        if (child != nullptr) {
+          stack_[stack_top++] = child;  // Fits() bounds the depth
+        }
+      }
+    }
+    // Children first: an adopted node goes idle (its new counterpart owns
+    // the running action) before an unmatched ancestor's Halt() reaches it.
+    for (uint16_t i = old_count_; i > 0U; --i) {
+      NodeType* node = old_[i - 1U];
+      if (consumed_[i - 1U]) {
+        node->AdoptState(idle_);
+      } else if (node->is_running()) {
+        tree_.Halt(*node);
+      }
+    }
+  }
+
+  TreeType tree_;
+  ReloadPolicy policy_;
+  uint32_t reload_count_;
+  std::atomic<NodeType*> pending_;
+  std::atomic<NodeType*> retired_;
+
+  // Swap scratch (tick thread only)
+  NodeType idle_;  // never ticked: AdoptState() source for a plain reset
+  NodeType* old_[kMaxNodes];
+  NodeType* stack_[kMaxNodes];
+  uint16_t table_[kTableSize];
+  bool consumed_[kMaxNodes];
+  uint16_t old_count_;
+};
+
+}  // namespace bt
+
+#endif  // BT_HOT_RELOAD_HPP_
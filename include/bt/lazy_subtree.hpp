@@ -0,0 +1,356 @@
+/**
+ * @file lazy_subtree.hpp
+ * @brief Subtrees built on first entry into pooled arenas, released when idle.
+ *
+ * Large mission trees carry many contingency branches that rarely run. A
+ * LazySubtree keeps only a factory and a descriptor; its SUBTREE node
+ * builds the branch the first time it is ticked, into one block of a
+ * SubtreePool, so resident memory follows the branches actually in use:
+ *
+ * @code
+ *   static unsigned char pool_buffer[16 * 1024];
+ *   bt::SubtreePool<Ctx> pool(pool_buffer, sizeof(pool_buffer), 2048);
+ *
+ *   // descriptor: anything the factory understands (XML text, .btb offset)
+ *   bt::LazySubtree<Ctx> evade(pool, BuildFromXml, kEvadeXml);
+ *   evade.Attach(evade_node);                 // SUBTREE node in the main tree
+ *
+ *   for (;;) {
+ *     tree.Tick();
+ *     pool.Sweep(500);    // optional: release subtrees idle > 500 ticks
+ *   }
+ * @endcode
+ *
+ * The pool buffer is cut into equal blocks; each block holds one NodeArena
+ * and the nodes and strings of one instantiated subtree:
+ *
+ *   [ NodeArena | Node 0 | ... | Node n-1 ->  free  <- strings ]
+ *
+ * Release (Sweep() or Release()) destroys the subtree and detaches it from
+ * its node; the next entry rebuilds it from scratch. A RUNNING subtree is
+ * never released by Sweep(). SUBTREE nodes may themselves live inside a
+ * lazily built subtree: releasing the outer one releases the inner ones.
+ */
+
+#ifndef BT_LAZY_SUBTREE_HPP_
+#define BT_LAZY_SUBTREE_HPP_
+
+#include "arena.hpp"
+
+namespace bt {
+
+template <typename Context, typename Observer = NullObserver>
+class LazySubtree;
+
+/**
+ * @brief Builds a subtree into @p arena.
+ * @return Subtree root, or nullptr on failure (e.g. arena exhausted).
+ */
+template <typename Context, typename Observer = NullObserver>
+using SubtreeFactory = Node<Context, Observer>* (*)(
+    NodeArena<Context, Observer>& arena, const void* descriptor);
+
+// ============================================================================
+// SubtreePool
+// ============================================================================
+
+/**
+ * @brief Fixed-block storage shared by a set of LazySubtrees.
+ * @tparam Context User-defined context type.
+ * @tparam Observer Observer policy of the subtree nodes.
+ *
+ * Single-threaded: use from the thread that ticks the tree.
+ */
+template <typename Context, typename Observer = NullObserver>
+class SubtreePool final {
+ public:
+  using ArenaT = NodeArena<Context, Observer>;
+  using LazyT = LazySubtree<Context, Observer>;
+
+  /**
+   * @brief Cut a caller-owned buffer into blocks.
+   * @param buffer Storage (must outlive the pool).
+   * @param bytes Buffer size in bytes.
+   * @param block_bytes Bytes per subtree, including the arena header;
+   *        rounded down to the node alignment.
+   */
+  SubtreePool(void* buffer, size_t bytes, size_t block_bytes) noexcept
+      : free_(nullptr), resident_(nullptr), block_bytes_(0), block_count_(0),
+        free_count_(0), instantiate_count_(0), release_count_(0),
+        failure_count_(0) {
+    const uintptr_t mask = static_cast<uintptr_t>(kAlign - 1U);
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(buffer);
+    const uintptr_t end = addr + bytes;
+    const uintptr_t aligned = (addr + mask) & ~mask;
+    block_bytes_ = block_bytes & ~static_cast<size_t>(mask);
+    if ((aligned > end) || (block_bytes_ <= sizeof(ArenaT))) {
+      block_bytes_ = 0;
+      return;
+    }
+    block_count_ = static_cast<uint32_t>((end - aligned) / block_bytes_);
+    unsigned char* begin = reinterpret_cast<unsigned char*>(aligned);
+    for (uint32_t i = block_count_; i > 0U; --i) {
+      Free(begin + (i - 1U) * block_bytes_);
+    }
+  }
+
+  /** @brief Release every resident subtree. */
+  ~SubtreePool() { ReleaseAll(); }
+
+  SubtreePool(const SubtreePool&) = delete;
+  SubtreePool& operator=(const SubtreePool&) = delete;
+  SubtreePool(SubtreePool&&) = delete;
+  SubtreePool& operator=(SubtreePool&&) = delete;
+
+  /**
+   * @brief Age resident subtrees by one tick and release the idle ones.
+   * @param idle_limit Subtrees not ticked for more than this many calls
+   *        are released (0 = release as soon as one is not RUNNING).
+   * @return Number of subtrees released.
+   *
+   * Call once per tree tick, after Tick().
+   */
+  uint32_t Sweep(uint32_t idle_limit) noexcept {
+    uint32_t released = 0;
+    LazyT* lazy = resident_;
+    while (lazy != nullptr) {
+      // Inner subtrees are instantiated after (and linked before) their
+      // outer one, so releasing lazy never unlinks next
+      LazyT* next = lazy->next_;
+      if (lazy->idle_ticks < ~static_cast<uint32_t>(0)) {
+        ++lazy->idle_ticks;
+      }
+      if ((lazy->idle_ticks > idle_limit) && !lazy->node_->is_running()) {
+        released += lazy->Evict();
+      }
+      lazy = next;
+    }
+    return released;
+  }
+
+  /** @brief Release every resident subtree, RUNNING or not. */
+  void ReleaseAll() noexcept {
+    while (resident_ != nullptr) {
+      resident_->Evict();
+    }
+  }
+
+  /** @brief Usable bytes per block (after alignment). */
+  size_t block_bytes() const noexcept { return block_bytes_; }
+
+  /** @brief Total number of blocks. */
+  uint32_t block_count() const noexcept { return block_count_; }
+
+  /** @brief Blocks not holding a subtree. */
+  uint32_t free_blocks() const noexcept { return free_count_; }
+
+  /** @brief Subtrees currently instantiated. */
+  uint32_t resident_count() const noexcept {
+    return block_count_ - free_count_;
+  }
+
+  /** @brief Subtrees built so far (rebuilds included). */
+  uint32_t instantiate_count() const noexcept { return instantiate_count_; }
+
+  /** @brief Subtrees released so far. */
+  uint32_t release_count() const noexcept { return release_count_; }
+
+  /** @brief Failed builds (no free block, factory or validation failure). */
+  uint32_t failure_count() const noexcept { return failure_count_; }
+
+ private:
+  friend class LazySubtree<Context, Observer>;
+
+  static constexpr size_t kAlign =
+      (alignof(typename ArenaT::NodeT) > alignof(ArenaT))
+          ? alignof(typename ArenaT::NodeT)
+          : alignof(ArenaT);
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  void* Allocate() noexcept {
+    FreeBlock* block = free_;
+    if (block == nullptr) {
+      return nullptr;
+    }
+    free_ = block->next;
+    --free_count_;
+    return block;
+  }
+
+  void Free(void* block) noexcept {
+    free_ = ::new (block) FreeBlock{free_};
+    ++free_count_;
+  }
+
+  FreeBlock* free_;      // free block list
+  LazyT* resident_;      // instantiated subtrees, most recent first
+  size_t block_bytes_;
+  uint32_t block_count_;
+  uint32_t free_count_;
+  uint32_t instantiate_count_;
+  uint32_t release_count_;
+  uint32_t failure_count_;
+};
+
+// ============================================================================
+// LazySubtree
+// ============================================================================
+
+/**
+ * @brief Source of one SUBTREE node: factory + descriptor, built on demand.
+ * @tparam Context User-defined context type.
+ * @tparam Observer Observer policy of the subtree nodes.
+ *
+ * Must outlive the node it is attached to, and be destroyed before its
+ * pool (declare the pool first).
+ */
+template <typename Context, typename Observer>
+class LazySubtree final : public SubtreeSource<Context, Observer> {
+ public:
+  using NodeT = Node<Context, Observer>;
+  using ArenaT = NodeArena<Context, Observer>;
+
+  /**
+   * @brief Describe a subtree without building it.
+   * @param pool Block storage for the instantiated subtree.
+   * @param factory Builds the subtree into a block's arena.
+   * @param descriptor Passed to factory unchanged (may be nullptr).
+   */
+  LazySubtree(SubtreePool<Context, Observer>& pool,
+              SubtreeFactory<Context, Observer> factory,
+              const void* descriptor = nullptr) noexcept
+      : SubtreeSource<Context, Observer>{&LazySubtree::Instantiate, 0U},
+        pool_(pool), factory_(factory), descriptor_(descriptor),
+        node_(nullptr), arena_(nullptr), next_(nullptr) {}
+
+  /** @brief Release the subtree if it is resident. */
+  ~LazySubtree() { Evict(); }
+
+  LazySubtree(const LazySubtree&) = delete;
+  LazySubtree& operator=(const LazySubtree&) = delete;
+  LazySubtree(LazySubtree&&) = delete;
+  LazySubtree& operator=(LazySubtree&&) = delete;
+
+  /**
+   * @brief Turn @p node into this subtree's SUBTREE node.
+   *
+   * Re-attaching (e.g. from the factory of an enclosing lazy subtree that
+   * was rebuilt) releases the previous instance first.
+   */
+  NodeT& Attach(NodeT& node) noexcept {
+    Evict();
+    node_ = &node;
+    return node.set_type(NodeType::kSubtree).set_subtree(this);
+  }
+
+  /**
+   * @brief Release the subtree now.
+   * @return false if it is RUNNING (kept; Halt() the node first).
+   */
+  bool Release() noexcept {
+    if ((arena_ != nullptr) && node_->is_running()) {
+      return false;
+    }
+    static_cast<void>(Evict());
+    return true;
+  }
+
+  /** @brief Check if the subtree is currently instantiated. */
+  bool resident() const noexcept { return arena_ != nullptr; }
+
+  /** @brief Root of the instantiated subtree (nullptr if not resident). */
+  NodeT* root() const noexcept {
+    return (arena_ != nullptr) ? node_->child(0) : nullptr;
+  }
+
+  /** @brief Arena holding the instantiated subtree (nullptr if not). */
+  ArenaT* arena() const noexcept { return arena_; }
+
+  /** @brief Attached SUBTREE node (nullptr before Attach()). */
+  NodeT* node() const noexcept { return node_; }
+
+  /** @brief Descriptor passed to the factory. */
+  const void* descriptor() const noexcept { return descriptor_; }
+
+ private:
+  friend class SubtreePool<Context, Observer>;
+
+  static NodeT* Instantiate(SubtreeSource<Context, Observer>& source) noexcept {
+    return static_cast<LazySubtree&>(source).Build();
+  }
+
+  NodeT* Build() noexcept {
+    void* block = pool_.Allocate();
+    if (block == nullptr) {
+      ++pool_.failure_count_;
+      return nullptr;
+    }
+    unsigned char* raw = static_cast<unsigned char*>(block);
+    ArenaT* arena = ::new (block)
+        ArenaT(raw + sizeof(ArenaT), pool_.block_bytes_ - sizeof(ArenaT));
+    NodeT* root = factory_(*arena, descriptor_);
+    if ((root == nullptr) || (root->ValidateTree() != ValidateError::kNone)) {
+      arena->~ArenaT();
+      pool_.Free(block);
+      ++pool_.failure_count_;
+      return nullptr;
+    }
+    arena_ = arena;
+    next_ = pool_.resident_;
+    pool_.resident_ = this;
+    ++pool_.instantiate_count_;
+    return root;
+  }
+
+  /** @brief Release unconditionally; returns the number released. */
+  uint32_t Evict() noexcept {
+    if (arena_ == nullptr) {
+      return 0U;
+    }
+    for (LazySubtree** link = &pool_.resident_; *link != nullptr;
+         link = &(*link)->next_) {
+      if (*link == this) {
+        *link = next_;
+        break;
+      }
+    }
+    next_ = nullptr;
+
+    // SUBTREE nodes inside this block lose their storage as well
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(arena_);
+    const uintptr_t end = begin + pool_.block_bytes_;
+    uint32_t released = 1U;
+    LazySubtree* inner = pool_.resident_;
+    while (inner != nullptr) {
+      LazySubtree* next = inner->next_;
+      const uintptr_t at = reinterpret_cast<uintptr_t>(inner->node_);
+      if ((at >= begin) && (at < end)) {
+        released += inner->Evict();
+        next = pool_.resident_;  // list changed; rescan
+      }
+      inner = next;
+    }
+
+    node_->SetChildren(nullptr, 0U);
+    ArenaT* arena = arena_;
+    arena_ = nullptr;
+    arena->~ArenaT();
+    pool_.Free(arena);
+    ++pool_.release_count_;
+    return released;
+  }
+
+  SubtreePool<Context, Observer>& pool_;
+  SubtreeFactory<Context, Observer> factory_;
+  const void* descriptor_;
+  NodeT* node_;
+  ArenaT* arena_;       // block of the resident subtree
+  LazySubtree* next_;   // pool's resident list
+};
+
+}  // namespace bt
+
+#endif  // BT_LAZY_SUBTREE_HPP_
@@ -0,0 +1,184 @@
+/**
+ * @file optimize.hpp
+ * @brief Structural simplification of a built tree before ticking.
+ *
+ * Generated trees often carry nodes that only forward their child's
+ * result. Every one of them costs a Node::Tick() dispatch and a status
+ * write per tick. Optimize() rewrites child pointers to bypass them:
+ *
+ *   Sequence(a, Sequence(b, c), d)  ->  Sequence(a, b, c, d)
+ *   Selector(a, Selector(b, c))     ->  Selector(a, b, c)
+ *   Sequence(x) / Selector(x)       ->  x
+ *   Inverter(Inverter(x))           ->  x
+ *
+ * Only nodes without on_enter / on_exit are removed, and the rewrites
+ * are exact: status, RUNNING resume points and ERROR propagation are
+ * unchanged. A splice is skipped if it would exceed BT_MAX_CHILDREN.
+ * Parallel nodes are kept, and so are Inverter-over-Condition pairs,
+ * because a callback cannot be negated without a new function.
+ * GuardProgram folds those.
+ *
+ * Removed nodes are only unlinked. Their storage (arena, statics) stays
+ * valid and is owned as before.
+ *
+ * @code
+ *   bt::OptimizeResult<Ctx> r = bt::Optimize(*loaded.root);
+ *   bt::BehaviorTree<Ctx> tree(*r.root, ctx);      // root may change
+ *   printf("removed %u of %u nodes (-%u%% dispatches)\n",
+ *          r.removed(), r.nodes_before, r.DispatchReductionPercent());
+ * @endcode
+ */
+
+#ifndef BT_OPTIMIZE_HPP_
+#define BT_OPTIMIZE_HPP_
+
+#include "behavior_tree.hpp"
+
+namespace bt {
+
+/**
+ * @brief Outcome of Optimize().
+ * @tparam Context User-defined context type.
+ * @tparam Observer Observer policy of the nodes.
+ *
+ * Node counts are per root-to-node path, i.e. the Node::Tick() dispatches
+ * of a tick that visits every node.
+ */
+template <typename Context, typename Observer = NullObserver>
+struct OptimizeResult {
+  Node<Context, Observer>* root;  ///< Root to tick (may differ from input)
+  ValidateError error;            ///< Input failed ValidateTree(); unchanged
+  uint32_t nodes_before;          ///< Reachable nodes before the pass
+  uint32_t nodes_after;           ///< Reachable nodes after the pass
+  uint32_t flattened;             ///< Nested same-type composites spliced
+  uint32_t single_child;          ///< One-child Sequence/Selector bypassed
+  uint32_t double_inverters;      ///< Inverter pairs removed (2 nodes each)
+
+  /** @brief Nodes removed from the tick path. */
+  uint32_t removed() const noexcept { return nodes_before - nodes_after; }
+
+  /**
+   * @brief Expected dispatch reduction per tick in percent, assuming every
+   *        node is equally likely to be ticked.
+   */
+  uint32_t DispatchReductionPercent() const noexcept {
+    return (nodes_before > 0U) ? (removed() * 100U) / nodes_before : 0U;
+  }
+};
+
+namespace detail {
+
+/** @brief Rewriting pass behind Optimize(). */
+template <typename Context, typename Observer>
+class Optimizer final {
+ public:
+  using NodeT = Node<Context, Observer>;
+
+  explicit Optimizer(OptimizeResult<Context, Observer>& result) noexcept
+      : result_(result) {}
+
+  static uint32_t CountNodes(const NodeT& node) noexcept {
+    uint32_t count = 1U;
+    for (uint16_t i = 0; i < node.children_count(); ++i) {
+      count += CountNodes(*node.child(i));
+    }
+    return count;
+  }
+
+  /**
+   * @brief Optimize the subtree at @p node (children first).
+   * @return Node that replaces @p node in its parent.
+   */
+  NodeT* Visit(NodeT& node) noexcept {
+    const uint16_t count = node.children_count();
+    if ((count == 0U) || (node.type() == NodeType::kSubtree)) {
+      return &node;  // leaf, or built on demand
+    }
+
+    NodeT* children[NodeT::kMaxChildren];
+    uint16_t out = 0;
+    bool changed = false;
+    for (uint16_t i = 0; i < count; ++i) {
+      NodeT* child = Visit(*node.child(i));
+      changed = changed || (child != node.child(i));
+      const uint16_t pending = static_cast<uint16_t>(count - i - 1U);
+      if (Splicable(node, *child) &&
+          (out + child->children_count() + pending <= NodeT::kMaxChildren)) {
+        for (uint16_t k = 0; k < child->children_count(); ++k) {
+          children[out] = child->child(k);
+          ++out;
+        }
+        ++result_.flattened;
+        changed = true;
+      } else {
+        children[out] = child;
+        ++out;
+      }
+    }
+    if (changed) {
+      node.SetChildren(children, out);
+    }
+
+    if (!Removable(node)) {
+      return &node;
+    }
+    if ((node.type() == NodeType::kInverter) &&
+        (node.child(0)->type() == NodeType::kInverter) &&
+        Removable(*node.child(0))) {
+      ++result_.double_inverters;
+      return node.child(0)->child(0);
+    }
+    if (((node.type() == NodeType::kSequence) ||
+         (node.type() == NodeType::kSelector)) &&
+        (out == 1U)) {
+      ++result_.single_child;
+      return node.child(0);
+    }
+    return &node;
+  }
+
+ private:
+  static bool Removable(const NodeT& node) noexcept {
+    return !node.has_on_enter() && !node.has_on_exit();
+  }
+
+  /** Sequence in Sequence / Selector in Selector: same short-circuit. */
+  static bool Splicable(const NodeT& parent, const NodeT& child) noexcept {
+    return ((parent.type() == NodeType::kSequence) ||
+            (parent.type() == NodeType::kSelector)) &&
+           (child.type() == parent.type()) && Removable(child);
+  }
+
+  OptimizeResult<Context, Observer>& result_;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Remove forwarding-only nodes from a tree (see file comment).
+ * @param root Root of a valid, not yet ticked (or Reset()) tree.
+ * @return New root and statistics; on a ValidateTree() error the tree is
+ *         left untouched and root is returned unchanged.
+ *
+ * Recursive, like ValidateTree(): the input must be acyclic (CheckTree()
+ * for generated graphs).
+ */
+template <typename Context, typename Observer>
+OptimizeResult<Context, Observer> Optimize(
+    Node<Context, Observer>& root) noexcept {
+  OptimizeResult<Context, Observer> r{&root, root.ValidateTree(), 0U, 0U,
+                                      0U, 0U, 0U};
+  if (r.error != ValidateError::kNone) {
+    return r;
+  }
+  using Pass = detail::Optimizer<Context, Observer>;
+  r.nodes_before = Pass::CountNodes(root);
+  Pass pass(r);
+  r.root = pass.Visit(root);
+  r.nodes_after = Pass::CountNodes(*r.root);
+  return r;
+}
+
+}  // namespace bt
+
+#endif  // BT_OPTIMIZE_HPP_
@@ -0,0 +1,462 @@
+/**
+ * @file perf_counters.hpp
+ * @brief Hardware performance counters (Linux perf_event_open) per tick
+ *        and per node type.
+ *
+ * PerfMeter opens one counter group on the calling thread: cycles,
+ * instructions, L1D read misses, last-level cache misses and branch
+ * misses. PerfObserver is an Observer policy (see NullObserver) that
+ * reads the group when a node is entered and when it returns:
+ *
+ * - per tick: counts from entering the root until it returns;
+ * - per node type: each count between two reads goes to the type of the
+ *   node running at that time (exclusive of its children).
+ *
+ * @code
+ *   using PerfNode = bt::Node<Ctx, bt::PerfObserver>;
+ *   bt::BehaviorTree<Ctx, bt::PerfObserver> tree(root, ctx);
+ *
+ *   bt::PerfMeter meter;                 // on the tick thread
+ *   {
+ *     const bt::PerfMeter::Scope perf(&meter);
+ *     for (int i = 0; i < 1000; ++i) tree.Tick();
+ *   }
+ *   meter.Report(stdout);
+ * @endcode
+ *
+ * set_subtree(id) measures only the subtree rooted at that node id
+ * (needs BT_NODE_IDS and AssignNodeIds()).
+ *
+ * Counters the kernel refuses (no PMU in a VM, perf_event_paranoid,
+ * other platforms) are left out; with none open the meter still reports
+ * steady_clock time. Every read is a system call of roughly a
+ * microsecond and is counted too, so compare runs measured the same way.
+ * set_node_types(false) reads only at tick boundaries.
+ */
+
+#ifndef BT_PERF_COUNTERS_HPP_
+#define BT_PERF_COUNTERS_HPP_
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "behavior_tree.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BT_PERF_HAS_EVENTS
+#endif
+
+namespace bt {
+
+/** @brief Hardware events read by PerfMeter. */
+enum class PerfEvent : uint8_t {
+  kCycles = 0,
+  kInstructions,
+  kL1dMisses,     ///< L1 data cache read misses
+  kLlcMisses,     ///< Last-level cache misses
+  kBranchMisses
+};
+
+/** @brief Number of PerfEvent values. */
+constexpr uint32_t kPerfEvents = 5U;
+
+/** @brief Event mask bit of @p e. */
+constexpr uint32_t PerfEventBit(PerfEvent e) noexcept {
+  return 1U << static_cast<uint8_t>(e);
+}
+
+/** @brief Mask with every PerfEvent. */
+constexpr uint32_t kAllPerfEvents = (1U << kPerfEvents) - 1U;
+
+/** @brief Convert PerfEvent to a short column name. */
+inline constexpr const char* PerfEventToString(PerfEvent e) noexcept {
+  return (e == PerfEvent::kCycles)         ? "cycles"
+         : (e == PerfEvent::kInstructions) ? "instructions"
+         : (e == PerfEvent::kL1dMisses)    ? "l1d-misses"
+         : (e == PerfEvent::kLlcMisses)    ? "llc-misses"
+         : (e == PerfEvent::kBranchMisses) ? "branch-misses"
+                                           : "UNKNOWN";
+}
+
+/** @brief Accumulated counts of one tick, one node type or all ticks. */
+struct PerfCounts {
+  uint64_t calls;                ///< Ticks, or node visits per type
+  uint64_t ns;                   ///< steady_clock time
+  uint64_t events[kPerfEvents];  ///< 0 for events that are not open
+
+  /** @brief Count of event @p e. */
+  uint64_t get(PerfEvent e) const noexcept {
+    return events[static_cast<uint8_t>(e)];
+  }
+
+  /** @brief Instructions per cycle, or 0 without both counters. */
+  double ipc() const noexcept {
+    return (get(PerfEvent::kCycles) == 0U)
+               ? 0.0
+               : static_cast<double>(get(PerfEvent::kInstructions)) /
+                     static_cast<double>(get(PerfEvent::kCycles));
+  }
+};
+
+/**
+ * @brief Counter group of the constructing thread plus the per-tick and
+ *        per-node-type totals that PerfObserver fills in.
+ *
+ * Create and use it on the thread that ticks: perf counters follow the
+ * thread that opened them. Not copyable.
+ */
+class PerfMeter final {
+ public:
+  /// set_subtree() value that measures from the outermost node ticked.
+  static constexpr uint16_t kWholeTree = 0xFFFFU;
+  /// Nesting depth tracked for per-type attribution; deeper nodes are
+  /// charged to the node at this depth.
+  static constexpr uint32_t kMaxDepth = 32U;
+  /// Number of NodeType values.
+  static constexpr uint32_t kNodeTypes =
+      static_cast<uint32_t>(NodeType::kSubtree) + 1U;
+
+  /** @brief Thread-local meter fed by PerfObserver; nullptr when idle. */
+  static PerfMeter*& Active() noexcept {
+    static thread_local PerfMeter* active = nullptr;
+    return active;
+  }
+
+  /** @brief Makes @p meter the active one for its lifetime. */
+  class Scope final {
+   public:
+    explicit Scope(PerfMeter* meter) noexcept : previous_(Active()) {
+      Active() = meter;
+    }
+    ~Scope() { Active() = previous_; }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    PerfMeter* previous_;
+  };
+
+  /**
+   * @brief Open the events in @p events (PerfEventBit() mask).
+   *
+   * Pass 0 for a timing-only meter. Events that fail to open are
+   * dropped; events() tells which ones are counted.
+   */
+  explicit PerfMeter(uint32_t events = kAllPerfEvents) noexcept
+      : leader_(-1), open_count_(0), open_mask_(0), subtree_(kWholeTree),
+        node_types_(true), depth_(0), start_{}, last_{}, last_tick_{},
+        total_{}, by_type_{}, slot_event_{}, stack_{}, fds_{} {
+    for (uint32_t i = 0; i < kPerfEvents; ++i) {
+      fds_[i] = -1;
+    }
+    Open(events);
+  }
+
+  ~PerfMeter() { Close(); }
+
+  PerfMeter(const PerfMeter&) = delete;
+  PerfMeter& operator=(const PerfMeter&) = delete;
+
+  // --- Configuration ---
+
+  /** @brief Measure only the subtree rooted at node @p id. */
+  PerfMeter& set_subtree(uint16_t id) noexcept {
+    subtree_ = id;
+    return *this;
+  }
+
+  /** @brief Attribute counts to node types (two reads per node). */
+  PerfMeter& set_node_types(bool enabled) noexcept {
+    node_types_ = enabled;
+    return *this;
+  }
+
+  // --- Results ---
+
+  /** @brief true if at least one hardware counter is open. */
+  bool available() const noexcept { return open_count_ > 0U; }
+
+  /** @brief PerfEventBit() mask of the events being counted. */
+  uint32_t events() const noexcept { return open_mask_; }
+
+  /** @brief Counts of the most recent measured tick (calls is 1). */
+  const PerfCounts& last_tick() const noexcept { return last_tick_; }
+
+  /** @brief Counts summed over all measured ticks. */
+  const PerfCounts& total() const noexcept { return total_; }
+
+  /** @brief Exclusive counts and visits of nodes of type @p type. */
+  const PerfCounts& by_type(NodeType type) const noexcept {
+    return by_type_[static_cast<uint8_t>(type)];
+  }
+
+  /** @brief Zero all results (between ticks). */
+  void Reset() noexcept {
+    last_tick_ = PerfCounts{};
+    total_ = PerfCounts{};
+    for (uint32_t i = 0; i < kNodeTypes; ++i) {
+      by_type_[i] = PerfCounts{};
+    }
+  }
+
+  /**
+   * @brief Print per-tick means and per-type totals to @p out.
+   *
+   * Columns of events that are not open are printed as "-".
+   */
+  void Report(std::FILE* out) const noexcept {
+    if (out == nullptr) {
+      return;
+    }
+    std::fprintf(out, "%-10s %10s %12s", "", "calls", "ns");
+    for (uint32_t e = 0; e < kPerfEvents; ++e) {
+      std::fprintf(out, " %14s",
+                   PerfEventToString(static_cast<PerfEvent>(e)));
+    }
+    std::fputc('\n', out);
+    ReportRow(out, "tick/mean", total_, total_.calls);
+    for (uint32_t t = 0; t < kNodeTypes; ++t) {
+      if (by_type_[t].calls > 0U) {
+        ReportRow(out, NodeTypeToString(static_cast<NodeType>(t)),
+                  by_type_[t], 1U);
+      }
+    }
+  }
+
+  // --- Hooks (called by PerfObserver) ---
+
+  /** @brief Node @p id of type @p type is about to be ticked. */
+  void EnterNode(uint16_t id, NodeType type) noexcept {
+    if (depth_ == 0U) {
+      if ((subtree_ != kWholeTree) && (id != subtree_)) {
+        return;
+      }
+      Read(start_);
+      last_ = start_;
+    } else if (node_types_) {
+      PerfCounts now;
+      Read(now);
+      Charge(now);
+    }
+    if (depth_ < kMaxDepth) {
+      stack_[depth_] = static_cast<uint8_t>(type);
+    }
+    ++depth_;
+    ++by_type_[static_cast<uint8_t>(type)].calls;
+  }
+
+  /** @brief The node entered last returned. */
+  void ExitNode() noexcept {
+    if (depth_ == 0U) {
+      return;
+    }
+    if (node_types_ || (depth_ == 1U)) {
+      PerfCounts now;
+      Read(now);
+      if (node_types_) {
+        Charge(now);
+      }
+      if (depth_ == 1U) {
+        last_tick_ = PerfCounts{};
+        last_tick_.calls = 1U;
+        Accumulate(last_tick_, now, start_);
+        Accumulate(total_, now, start_);
+        ++total_.calls;
+      }
+    }
+    --depth_;
+  }
+
+ private:
+  static constexpr uint32_t kLeaderless = 0xFFFFFFFFU;
+
+  /* Counts between last_ and @p now go to the node on top of the stack. */
+  void Charge(const PerfCounts& now) noexcept {
+    const uint32_t top = ((depth_ < kMaxDepth) ? depth_ : kMaxDepth) - 1U;
+    Accumulate(by_type_[stack_[top]], now, last_);
+    last_ = now;
+  }
+
+  static void Accumulate(PerfCounts& into, const PerfCounts& now,
+                         const PerfCounts& then) noexcept {
+    into.ns += now.ns - then.ns;
+    for (uint32_t e = 0; e < kPerfEvents; ++e) {
+      into.events[e] += now.events[e] - then.events[e];
+    }
+  }
+
+  void ReportRow(std::FILE* out, const char* label, const PerfCounts& c,
+                 uint64_t per) const noexcept {
+    const double div = (per == 0U) ? 1.0 : static_cast<double>(per);
+    std::fprintf(out, "%-10s %10llu %12.0f", label,
+                 static_cast<unsigned long long>(c.calls),
+                 static_cast<double>(c.ns) / div);
+    for (uint32_t e = 0; e < kPerfEvents; ++e) {
+      if ((open_mask_ & (1U << e)) != 0U) {
+        std::fprintf(out, " %14.0f", static_cast<double>(c.events[e]) / div);
+      } else {
+        std::fprintf(out, " %14s", "-");
+      }
+    }
+    std::fputc('\n', out);
+  }
+
+  /* Clock and every open counter into @p out (unopened events are 0). */
+  void Read(PerfCounts& out) noexcept {
+    out = PerfCounts{};
+    out.ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#if defined(BT_PERF_HAS_EVENTS)
+    if (leader_ >= 0) {
+      uint64_t buf[1U + kPerfEvents];  // PERF_FORMAT_GROUP: nr, values
+      const ssize_t n = ::read(leader_, buf, sizeof(buf));
+      if ((n >= static_cast<ssize_t>(sizeof(uint64_t))) &&
+          (buf[0] == open_count_)) {
+        for (uint32_t i = 0; i < open_count_; ++i) {
+          out.events[slot_event_[i]] = buf[1U + i];
+        }
+      }
+    }
+#endif
+  }
+
+#if defined(BT_PERF_HAS_EVENTS)
+  static void EventConfig(uint32_t e, perf_event_attr& attr) noexcept {
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (static_cast<PerfEvent>(e)) {
+      case PerfEvent::kCycles:
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+      case PerfEvent::kInstructions:
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+      case PerfEvent::kL1dMisses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D |
+                      (PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U);
+        break;
+      case PerfEvent::kLlcMisses:
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+      case PerfEvent::kBranchMisses:
+      default:
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    }
+  }
+#endif
+
+  void Open(uint32_t events) noexcept {
+#if defined(BT_PERF_HAS_EVENTS)
+    for (uint32_t e = 0; e < kPerfEvents; ++e) {
+      if ((events & (1U << e)) == 0U) {
+        continue;
+      }
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      EventConfig(e, attr);
+      if (leader_ < 0) {
+        attr.disabled = 1U;  // the group starts on the leader's ioctl
+      }
+      attr.exclude_kernel = 1U;
+      attr.exclude_hv = 1U;
+      attr.read_format = PERF_FORMAT_GROUP;
+      // This thread, any CPU; members join the first counter that opened.
+      const long fd = ::syscall(__NR_perf_event_open, &attr, 0, -1,
+                                leader_, 0UL);
+      if (fd < 0) {
+        continue;
+      }
+      fds_[open_count_] = static_cast<int>(fd);
+      slot_event_[open_count_] = static_cast<uint8_t>(e);
+      if (leader_ < 0) {
+        leader_ = static_cast<int>(fd);
+      }
+      ++open_count_;
+      open_mask_ |= 1U << e;
+    }
+    if (leader_ >= 0) {
+      ::ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ::ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    (void)events;
+#endif
+  }
+
+  void Close() noexcept {
+#if defined(BT_PERF_HAS_EVENTS)
+    // Members before the leader.
+    for (uint32_t i = open_count_; i > 0U; --i) {
+      ::close(fds_[i - 1U]);
+    }
+#endif
+    leader_ = -1;
+    open_count_ = 0;
+    open_mask_ = 0;
+  }
+
+  int leader_;
+  uint32_t open_count_;
+  uint32_t open_mask_;
+  uint16_t subtree_;
+  bool node_types_;
+  uint32_t depth_;
+  PerfCounts start_;
+  PerfCounts last_;
+  PerfCounts last_tick_;
+  PerfCounts total_;
+  PerfCounts by_type_[kNodeTypes];
+  uint8_t slot_event_[kPerfEvents];  // open order -> PerfEvent
+  uint8_t stack_[kMaxDepth];         // NodeType per nesting level
+  int fds_[kPerfEvents];
+};
+
+/**
+ * @brief Observer policy that feeds the thread's active PerfMeter.
+ *
+ * Derive from it instead of NullObserver to combine with other hooks;
+ * call PerfObserver::OnTick()/OnTickEnd() from your overrides.
+ */
+struct PerfObserver : NullObserver {
+  template <typename NodeT>
+  static void OnTick(const NodeT& node) noexcept {
+    PerfMeter* const meter = PerfMeter::Active();
+    if (meter != nullptr) {
+      meter->EnterNode(NodeId(node), node.type());
+    }
+  }
+
+  template <typename NodeT>
+  static void OnTickEnd(const NodeT& /*node*/, Status /*result*/) noexcept {
+    PerfMeter* const meter = PerfMeter::Active();
+    if (meter != nullptr) {
+      meter->ExitNode();
+    }
+  }
+
+ private:
+  /* Without BT_NODE_IDS only whole-tree measurement is possible. */
+  template <typename NodeT>
+  static uint16_t NodeId(const NodeT& node) noexcept {
+#if defined(BT_NODE_IDS)
+    return node.id();
+#else
+    (void)node;
+    return PerfMeter::kWholeTree;
+#endif
+  }
+};
+
+}  // namespace bt
+
+#endif  // BT_PERF_COUNTERS_HPP_
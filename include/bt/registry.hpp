@@ -0,0 +1,203 @@
+/**
+ * @file registry.hpp
+ * @brief Name -> callback registry for data-driven trees.
+ *
+ * Data-driven trees (XML loader, binary format, code generator) refer to
+ * leaf behavior by name. Registry<Context> maps those names to TickFn /
+ * StateTickFn / CallbackFn in a fixed-capacity open-addressing hash table:
+ * the FNV-1a hash of every name is computed once at registration, and a
+ * lookup hashes the query once and usually compares a single entry.
+ *
+ * Names must have static lifetime (string literals), like node names.
+ * Each entry also gets a dense function ID (registration order) so that
+ * serialized trees can reference callbacks by number.
+ */
+
+#ifndef BT_REGISTRY_HPP_
+#define BT_REGISTRY_HPP_
+
+#include "behavior_tree.hpp"
+
+namespace bt {
+
+/**
+ * @brief FNV-1a hash of a name (usable at compile time).
+ * @param text Characters (need not be NUL-terminated).
+ * @param length Number of characters.
+ */
+inline constexpr uint32_t HashName(const char* text, size_t length) noexcept {
+  uint32_t h = 2166136261U;
+  for (size_t i = 0; i < length; ++i) {
+    h ^= static_cast<uint32_t>(static_cast<unsigned char>(text[i]));
+    h *= 16777619U;
+  }
+  return h;
+}
+
+/** @brief Length of a NUL-terminated string (usable at compile time). */
+inline constexpr size_t NameLength(const char* text) noexcept {
+  size_t n = 0;
+  while (text[n] != '\0') {
+    ++n;
+  }
+  return n;
+}
+
+/** @brief Sentinel for "no function" in function-ID fields. */
+static constexpr uint16_t kNoFunction = 0xFFFFU;
+
+/**
+ * @brief Fixed-capacity name -> callback table.
+ * @tparam Context User-defined context type.
+ * @tparam kCapacity Hash table slots (power of two, >= 2x entries advised).
+ *
+ * Callback types do not depend on the node Observer, so one registry serves
+ * trees built with any observer policy.
+ */
+template <typename Context, uint16_t kCapacity = 256U>
+class Registry final {
+  static_assert((kCapacity & (kCapacity - 1U)) == 0U,
+                "Registry capacity must be a power of two");
+  static_assert(kCapacity < kNoFunction, "Registry capacity too large");
+
+ public:
+  using NodeT = Node<Context>;
+  using TickFn = typename NodeT::TickFn;
+  using CallbackFn = typename NodeT::CallbackFn;
+#if (BT_NODE_STATE_SIZE > 0)
+  using StateTickFn = typename NodeT::StateTickFn;
+#endif
+
+  /** @brief Kind of callable stored in an entry. */
+  enum class Kind : uint8_t {
+    kEmpty = 0,
+    kTick,
+    kStateTick,
+    kCallback
+  };
+
+  /** @brief One registered callable. */
+  struct Entry {
+    const char* name;
+    uint32_t hash;
+    uint16_t id;       ///< Dense function ID (registration order)
+    Kind kind;
+    TickFn tick;
+#if (BT_NODE_STATE_SIZE > 0)
+    StateTickFn state_tick;
+#endif
+    CallbackFn callback;
+  };
+
+  Registry() noexcept : slots_{}, order_{}, size_(0) {}
+
+  Registry(const Registry&) = delete;
+  Registry& operator=(const Registry&) = delete;
+
+  /**
+   * @brief Register a tick callback.
+   * @return false if the name exists or the table is full.
+   */
+  bool RegisterTick(const char* name, TickFn fn) noexcept {
+    Entry* e = Insert(name);
+    if (e == nullptr) {
+      return false;
+    }
+    e->kind = Kind::kTick;
+    e->tick = std::move(fn);
+    return true;
+  }
+
+#if (BT_NODE_STATE_SIZE > 0)
+  /** @brief Register a stateful tick callback (see Node::set_state_tick). */
+  bool RegisterStateTick(const char* name, StateTickFn fn) noexcept {
+    Entry* e = Insert(name);
+    if (e == nullptr) {
+      return false;
+    }
+    e->kind = Kind::kStateTick;
+    e->state_tick = std::move(fn);
+    return true;
+  }
+#endif
+
+  /** @brief Register a lifecycle (on_enter / on_exit) callback. */
+  bool RegisterCallback(const char* name, CallbackFn fn) noexcept {
+    Entry* e = Insert(name);
+    if (e == nullptr) {
+      return false;
+    }
+    e->kind = Kind::kCallback;
+    e->callback = std::move(fn);
+    return true;
+  }
+
+  /**
+   * @brief Find an entry by name.
+   * @param name Characters (need not be NUL-terminated).
+   * @param length Number of characters.
+   * @return Entry or nullptr.
+   */
+  const Entry* Find(const char* name, size_t length) const noexcept {
+    const uint32_t hash = HashName(name, length);
+    for (uint16_t probe = 0; probe < kCapacity; ++probe) {
+      const Entry& e = slots_[(hash + probe) & (kCapacity - 1U)];
+      if (e.kind == Kind::kEmpty) {
+        return nullptr;
+      }
+      if ((e.hash == hash) && (std::strncmp(e.name, name, length) == 0) &&
+          (e.name[length] == '\0')) {
+        return &e;
+      }
+    }
+    return nullptr;
+  }
+
+  /** @brief Find an entry by NUL-terminated name. */
+  const Entry* Find(const char* name) const noexcept {
+    return Find(name, NameLength(name));
+  }
+
+  /** @brief Find an entry by function ID (nullptr if out of range). */
+  const Entry* FindById(uint16_t id) const noexcept {
+    return (id < size_) ? order_[id] : nullptr;
+  }
+
+  /** @brief Number of hash table slots (maximum entries). */
+  static constexpr uint16_t capacity() noexcept { return kCapacity; }
+
+  /** @brief Number of registered entries. */
+  uint16_t size() const noexcept { return size_; }
+
+ private:
+  Entry* Insert(const char* name) noexcept {
+    if (size_ >= kCapacity) {
+      return nullptr;
+    }
+    const size_t length = NameLength(name);
+    const uint32_t hash = HashName(name, length);
+    for (uint16_t probe = 0; probe < kCapacity; ++probe) {
+      Entry& e = slots_[(hash + probe) & (kCapacity - 1U)];
+      if (e.kind == Kind::kEmpty) {
+        e.name = name;
+        e.hash = hash;
+        e.id = size_;
+        order_[size_] = &e;
+        ++size_;
+        return &e;
+      }
+      if ((e.hash == hash) && (std::strcmp(e.name, name) == 0)) {
+        return nullptr;
+      }
+    }
+    return nullptr;
+  }
+
+  Entry slots_[kCapacity];
+  Entry* order_[kCapacity];
+  uint16_t size_;
+};
+
+}  // namespace bt
+
+#endif  // BT_REGISTRY_HPP_
@@ -0,0 +1,446 @@
+/**
+ * @file static_tree.hpp
+ * @brief Trees described by constexpr tables, placed in read-only memory.
+ *
+ * Node<Context> trees are built by constructor code and keep topology,
+ * callbacks and execution state together in writable RAM. A static tree is
+ * instead written as a constexpr node list in pre-order, where each entry
+ * gives its child count and names callbacks by index into a constexpr
+ * function-pointer table:
+ *
+ * @code
+ *   enum : uint16_t { kIsReady, kWork, kLog };            // function IDs
+ *   constexpr bt::StaticFunction<Ctx> kFunctions[] = {IsReady, Work, Log};
+ *
+ *   constexpr bt::StaticNodeSpec kSpec[] = {
+ *       bt::spec::Sequence(2).Named("Root"),
+ *       bt::spec::Condition(kIsReady),
+ *       bt::spec::Action(kWork).OnEnter(kLog),
+ *   };
+ *   constexpr auto kTree = bt::BuildStaticTree(kSpec, kFunctions);
+ *   BT_STATIC_VALIDATE(kTree);                           // compile-time checks
+ *
+ *   constexpr bt::StaticFunctions<Ctx> kTable(kFunctions);
+ *   bt::FlatSlot g_slots[kTree.size()];                   // only RAM used
+ *
+ *   auto tree = kTree.MakeExecutor(kTable, g_slots, ctx);
+ *   tree.Tick();
+ * @endcode
+ *
+ * BuildStaticTree() runs entirely at compile time (C++14 relaxed
+ * constexpr), turning the list into FlatNode records and a child index
+ * table, so kTree, kFunctions and kTable are constant-initialized into
+ * .rodata / flash (.data.rel.ro in position-independent builds): there is
+ * no startup construction, and the topology cannot be modified at runtime.
+ * FlatSlot is constexpr-constructible, so the slot array is constant-
+ * initialized as well; it lands in .data rather than .bss only because the
+ * initial status (kFailure) is non-zero. Ticking goes through FlatExecutor
+ * and therefore matches Node::Tick() exactly.
+ */
+
+#ifndef BT_STATIC_TREE_HPP_
+#define BT_STATIC_TREE_HPP_
+
+#include "flat_tree.hpp"
+
+namespace bt {
+
+// ============================================================================
+// Function table
+// ============================================================================
+
+/**
+ * @brief One entry of a constexpr callback table.
+ * @tparam Context User-defined context type.
+ *
+ * Implicitly constructible from a plain tick, a stateful tick or a
+ * lifecycle callback, so a table is written as a list of function names.
+ */
+template <typename Context>
+struct StaticFunction {
+  using TickPtr = Status (*)(Context&);
+  using CallbackPtr = void (*)(Context&);
+#if (BT_NODE_STATE_SIZE > 0)
+  using StateTickPtr = Status (*)(Context&, NodeState&);
+#endif
+
+  TickPtr tick;
+#if (BT_NODE_STATE_SIZE > 0)
+  StateTickPtr state_tick;
+#endif
+  CallbackPtr callback;
+
+  constexpr StaticFunction(TickPtr fn) noexcept  // NOLINT(implicit)
+      : tick(fn),
+#if (BT_NODE_STATE_SIZE > 0)
+        state_tick(nullptr),
+#endif
+        callback(nullptr) {}
+
+#if (BT_NODE_STATE_SIZE > 0)
+  constexpr StaticFunction(StateTickPtr fn) noexcept  // NOLINT(implicit)
+      : tick(nullptr), state_tick(fn), callback(nullptr) {}
+#endif
+
+  constexpr StaticFunction(CallbackPtr fn) noexcept  // NOLINT(implicit)
+      : tick(nullptr),
+#if (BT_NODE_STATE_SIZE > 0)
+        state_tick(nullptr),
+#endif
+        callback(fn) {}
+
+  /** @brief Usable as a leaf tick. */
+  constexpr bool is_tick() const noexcept {
+#if (BT_NODE_STATE_SIZE > 0)
+    return (tick != nullptr) || (state_tick != nullptr);
+#else
+    return tick != nullptr;
+#endif
+  }
+
+  /** @brief Usable as on_enter / on_exit. */
+  constexpr bool is_callback() const noexcept { return callback != nullptr; }
+};
+
+/**
+ * @brief Functions adapter for FlatExecutor over a StaticFunction table.
+ *
+ * Holds only a pointer and a count, so a constexpr instance lives in
+ * .rodata next to the table it refers to.
+ */
+template <typename Context>
+class StaticFunctions final {
+ public:
+  template <uint16_t kCount>
+  constexpr explicit StaticFunctions(
+      const StaticFunction<Context> (&table)[kCount]) noexcept
+      : table_(table), count_(kCount) {}
+
+  /** @brief Call tick function id (validated by BuildStaticTree). */
+  BT_FORCE_INLINE Status Tick(uint16_t id, Context& ctx,
+                              FlatSlot& slot) const noexcept {
+    const StaticFunction<Context>& f = table_[id];
+#if (BT_NODE_STATE_SIZE > 0)
+    return BT_LIKELY(f.tick != nullptr) ? f.tick(ctx)
+                                        : f.state_tick(ctx, slot.state);
+#else
+    (void)slot;
+    return f.tick(ctx);
+#endif
+  }
+
+  /** @brief Call lifecycle callback id. */
+  BT_FORCE_INLINE void Call(uint16_t id, Context& ctx) const noexcept {
+    table_[id].callback(ctx);
+  }
+
+  /** @brief Number of table entries. */
+  constexpr uint16_t size() const noexcept { return count_; }
+
+ private:
+  const StaticFunction<Context>* table_;
+  uint16_t count_;
+};
+
+// ============================================================================
+// Node list
+// ============================================================================
+
+/**
+ * @brief One pre-order entry of a constexpr tree description.
+ *
+ * Create entries with the bt::spec helpers; a composite is followed by the
+ * entries of its child_count subtrees.
+ */
+struct StaticNodeSpec {
+  NodeType type;
+  ParallelPolicy policy;
+  uint16_t child_count;
+  uint16_t tick;
+  uint16_t on_enter;
+  uint16_t on_exit;
+  const char* name;
+
+  /** @brief Copy with an on_enter callback (function table index). */
+  constexpr StaticNodeSpec OnEnter(uint16_t id) const noexcept {
+    return StaticNodeSpec{type, policy, child_count, tick, id, on_exit, name};
+  }
+
+  /** @brief Copy with an on_exit callback (function table index). */
+  constexpr StaticNodeSpec OnExit(uint16_t id) const noexcept {
+    return StaticNodeSpec{type, policy, child_count, tick, on_enter, id, name};
+  }
+
+  /** @brief Copy with a node name (string literal). */
+  constexpr StaticNodeSpec Named(const char* node_name) const noexcept {
+    return StaticNodeSpec{type,     policy,  child_count, tick,
+                          on_enter, on_exit, node_name};
+  }
+};
+
+namespace spec {
+
+/** @brief Action leaf calling tick function id. */
+inline constexpr StaticNodeSpec Action(uint16_t tick) noexcept {
+  return StaticNodeSpec{NodeType::kAction, ParallelPolicy::kRequireAll, 0U,
+                        tick, kNoFunction, kNoFunction, ""};
+}
+
+/** @brief Condition leaf calling tick function id. */
+inline constexpr StaticNodeSpec Condition(uint16_t tick) noexcept {
+  return StaticNodeSpec{NodeType::kCondition, ParallelPolicy::kRequireAll, 0U,
+                        tick, kNoFunction, kNoFunction, ""};
+}
+
+/** @brief Sequence over the next `children` subtrees. */
+inline constexpr StaticNodeSpec Sequence(uint16_t children) noexcept {
+  return StaticNodeSpec{NodeType::kSequence, ParallelPolicy::kRequireAll,
+                        children, kNoFunction, kNoFunction, kNoFunction, ""};
+}
+
+/** @brief Selector over the next `children` subtrees. */
+inline constexpr StaticNodeSpec Selector(uint16_t children) noexcept {
+  return StaticNodeSpec{NodeType::kSelector, ParallelPolicy::kRequireAll,
+                        children, kNoFunction, kNoFunction, kNoFunction, ""};
+}
+
+/** @brief Parallel over the next `children` subtrees. */
+inline constexpr StaticNodeSpec Parallel(
+    uint16_t children,
+    ParallelPolicy policy = ParallelPolicy::kRequireAll) noexcept {
+  return StaticNodeSpec{NodeType::kParallel, policy, children, kNoFunction,
+                        kNoFunction, kNoFunction, ""};
+}
+
+/** @brief Inverter over the next subtree. */
+inline constexpr StaticNodeSpec Inverter() noexcept {
+  return StaticNodeSpec{NodeType::kInverter, ParallelPolicy::kRequireAll, 1U,
+                        kNoFunction, kNoFunction, kNoFunction, ""};
+}
+
+}  // namespace spec
+
+/** @brief BuildStaticTree() error codes. */
+enum class SpecError : uint8_t {
+  kNone = 0,            ///< Built successfully
+  kMissingChildren,     ///< List ends before every composite has its children
+  kMultipleRoots,       ///< Entries left over after the root's subtree
+  kUnknownFunction,     ///< Function index outside the table
+  kWrongFunctionKind,   ///< tick names a callback or vice versa
+  kInvalidNode          ///< Entry fails Node::Validate() (see validate_error)
+};
+
+/** @brief Convert SpecError to human-readable string. */
+inline constexpr const char* SpecErrorToString(SpecError e) noexcept {
+  return (e == SpecError::kNone)               ? "NONE"
+       : (e == SpecError::kMissingChildren)    ? "MISSING_CHILDREN"
+       : (e == SpecError::kMultipleRoots)      ? "MULTIPLE_ROOTS"
+       : (e == SpecError::kUnknownFunction)    ? "UNKNOWN_FUNCTION"
+       : (e == SpecError::kWrongFunctionKind)  ? "WRONG_FUNCTION_KIND"
+       : (e == SpecError::kInvalidNode)        ? "INVALID_NODE"
+       : "UNKNOWN";
+}
+
+/**
+ * @brief Node::Validate() rules applied to one list entry (constexpr).
+ *
+ * Same checks and order as the runtime pass; null children cannot occur
+ * in a node list.
+ */
+inline constexpr ValidateError ValidateSpec(const StaticNodeSpec& s) noexcept {
+  return (!IsLeafType(s.type) && (s.child_count > BT_MAX_CHILDREN))
+             ? ValidateError::kChildrenExceedMax
+       : (IsLeafType(s.type) && (s.tick == kNoFunction))
+             ? ValidateError::kLeafMissingTick
+       : ((s.type == NodeType::kInverter) && (s.child_count != 1U))
+             ? ValidateError::kInverterNotOneChild
+       : ((s.type == NodeType::kParallel) && (s.child_count > 32U))
+             ? ValidateError::kParallelExceedsBitmap
+       : (s.type == NodeType::kSubtree)  // no source in a static tree
+             ? ValidateError::kInvalidSubtree
+       : ValidateError::kNone;
+}
+
+// ============================================================================
+// Compiled tree
+// ============================================================================
+
+/**
+ * @brief Flat records produced by BuildStaticTree() (a literal type).
+ * @tparam kNodes Number of nodes.
+ */
+template <uint32_t kNodes>
+struct StaticTree {
+  FlatNode nodes[kNodes];       ///< Pre-order records (FlatNode::name = index)
+  uint32_t children[kNodes];    ///< Child index table
+  const char* names[kNodes];    ///< Node names
+  SpecError error;              ///< kNone if the records are usable
+  ValidateError validate_error; ///< Rule broken when error == kInvalidNode
+  uint32_t error_node;          ///< Offending list entry
+  uint32_t max_depth;           ///< Levels from root to deepest leaf (root = 1)
+
+  /** @brief Number of nodes (= slots needed). */
+  static constexpr uint32_t size() noexcept { return kNodes; }
+
+  /** @brief Bytes of writable state (the FlatSlot block). */
+  static constexpr size_t state_size() noexcept {
+    return sizeof(FlatSlot) * kNodes;
+  }
+
+  /**
+   * @brief Executor over these records.
+   * @param functions Table adapter the tree was built against.
+   * @param slots Writable state (must outlive the executor).
+   * @param context Shared context (must outlive the executor).
+   */
+  template <typename Context, typename Functions>
+  FlatExecutor<Context, Functions> MakeExecutor(
+      const Functions& functions, FlatSlot (&slots)[kNodes],
+      Context& context) const noexcept {
+    assert(error == SpecError::kNone);
+    return FlatExecutor<Context, Functions>(nodes, children, kNodes,
+                                            functions, slots, context);
+  }
+};
+
+namespace detail {
+
+template <typename Context, uint16_t kFunctions>
+constexpr SpecError CheckFunction(
+    uint16_t id, bool want_tick,
+    const StaticFunction<Context> (&table)[kFunctions]) noexcept {
+  if (id == kNoFunction) {
+    return want_tick ? SpecError::kUnknownFunction : SpecError::kNone;
+  }
+  if (id >= kFunctions) {
+    return SpecError::kUnknownFunction;
+  }
+  const bool ok = want_tick ? table[id].is_tick() : table[id].is_callback();
+  return ok ? SpecError::kNone : SpecError::kWrongFunctionKind;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Compile a pre-order node list into flat records (constexpr).
+ * @param spec Node list; entry 0 is the root.
+ * @param functions Table the function indices refer to (checked for range
+ *        and kind).
+ * @return Records plus error and statistics; use in a constexpr
+ *         initializer and check with BT_STATIC_VALIDATE().
+ *
+ * Every entry passes the Node::Validate() rules when error is kNone, so a
+ * static tree needs no ValidateTree() pass at runtime.
+ */
+template <typename Context, uint32_t kNodes, uint16_t kFunctions>
+constexpr StaticTree<kNodes> BuildStaticTree(
+    const StaticNodeSpec (&spec)[kNodes],
+    const StaticFunction<Context> (&functions)[kFunctions]) noexcept {
+  StaticTree<kNodes> t{};
+  t.error = SpecError::kNone;
+  uint32_t parent[kNodes] = {};   // open composites
+  uint16_t filled[kNodes] = {};   // children attached so far
+  uint32_t depth = 0;
+  uint32_t next_child = 0;
+
+  for (uint32_t i = 0; i < kNodes; ++i) {
+    const StaticNodeSpec& s = spec[i];
+    const bool leaf = IsLeafType(s.type);
+    t.validate_error = ValidateSpec(s);
+    SpecError err = (t.validate_error != ValidateError::kNone)
+                        ? SpecError::kInvalidNode
+                    : leaf ? detail::CheckFunction(s.tick, true, functions)
+                           : SpecError::kNone;
+    if (err == SpecError::kNone) {
+      err = detail::CheckFunction(s.on_enter, false, functions);
+    }
+    if (err == SpecError::kNone) {
+      err = detail::CheckFunction(s.on_exit, false, functions);
+    }
+    if ((err == SpecError::kNone) && (i > 0U) && (depth == 0U)) {
+      err = SpecError::kMultipleRoots;
+    }
+    if ((err == SpecError::kNone) && !leaf &&
+        (next_child + s.child_count >= kNodes + 1U)) {
+      err = SpecError::kMissingChildren;  // more children than entries left
+    }
+    if (err != SpecError::kNone) {
+      t.error = err;
+      t.error_node = i;
+      return t;
+    }
+
+    FlatNode& n = t.nodes[i];
+    n.type = s.type;
+    n.policy = s.policy;
+    n.child_count = leaf ? 0U : s.child_count;
+    n.first_child = next_child;
+    n.tick = leaf ? s.tick : kNoFunction;
+    n.on_enter = s.on_enter;
+    n.on_exit = s.on_exit;
+    n.reserved = 0U;
+    n.name = i;
+    t.names[i] = (s.name != nullptr) ? s.name : "";
+    next_child += n.child_count;
+
+    t.max_depth = (depth + 1U > t.max_depth) ? depth + 1U : t.max_depth;
+    if (depth > 0U) {
+      const uint32_t p = parent[depth - 1U];
+      t.children[t.nodes[p].first_child + filled[depth - 1U]] = i;
+      ++filled[depth - 1U];
+    }
+    if (n.child_count > 0U) {
+      parent[depth] = i;
+      filled[depth] = 0U;
+      ++depth;
+    }
+    while ((depth > 0U) &&
+           (filled[depth - 1U] == t.nodes[parent[depth - 1U]].child_count)) {
+      --depth;
+    }
+  }
+
+  if (depth > 0U) {
+    t.error = SpecError::kMissingChildren;
+    t.error_node = parent[depth - 1U];
+  }
+  return t;
+}
+
+}  // namespace bt
+
+/**
+ * @brief Reject a malformed static tree at compile time.
+ *
+ * One static_assert per failure kind, so the compiler names the problem:
+ * @code
+ *   constexpr auto kTree = bt::BuildStaticTree(kSpec, kFunctions);
+ *   BT_STATIC_VALIDATE(kTree);
+ *   static_assert(kTree.max_depth <= 6U, "stack budget");
+ *   static_assert(kTree.state_size() <= 512U, "RAM budget");
+ * @endcode
+ */
+#define BT_STATIC_VALIDATE(tree)                                              \
+  static_assert((tree).validate_error != bt::ValidateError::kLeafMissingTick, \
+                #tree ": leaf without tick");                                 \
+  static_assert(                                                              \
+      (tree).validate_error != bt::ValidateError::kInverterNotOneChild,       \
+      #tree ": inverter must have exactly one child");                        \
+  static_assert(                                                              \
+      (tree).validate_error != bt::ValidateError::kParallelExceedsBitmap,     \
+      #tree ": parallel with more than 32 children");                         \
+  static_assert(                                                              \
+      (tree).validate_error != bt::ValidateError::kChildrenExceedMax,         \
+      #tree ": more than BT_MAX_CHILDREN children");                          \
+  static_assert((tree).validate_error != bt::ValidateError::kInvalidSubtree,  \
+                #tree ": lazy subtrees need a runtime Node tree");            \
+  static_assert((tree).error != bt::SpecError::kMissingChildren,              \
+                #tree ": composite missing children");                        \
+  static_assert((tree).error != bt::SpecError::kMultipleRoots,                \
+                #tree ": entries after the root subtree");                    \
+  static_assert((tree).error != bt::SpecError::kUnknownFunction,              \
+                #tree ": function index outside the table");                  \
+  static_assert((tree).error != bt::SpecError::kWrongFunctionKind,            \
+                #tree ": tick / callback index of the wrong kind")
+
+#endif  // BT_STATIC_TREE_HPP_
@@ -0,0 +1,366 @@
+/**
+ * @file tree_check.hpp
+ * @brief Iterative whole-graph validation for large or generated trees.
+ *
+ * Node::ValidateTree() recurses and assumes the children form a tree. A
+ * generated structure can violate that: a child pointing back at an
+ * ancestor loops forever, and a node added under two parents shares one
+ * status / resume index between both. CheckTree() walks the graph
+ * depth-first on an explicit stack instead and keeps every node it has seen
+ * in an open-addressing pointer set with an on-path bitset:
+ *
+ * - reaching a node that is on the current path is a cycle;
+ * - reaching a node seen before is sharing, which is rejected unless the
+ *   node is stateless (a leaf with a plain tick and no lifecycle callbacks);
+ * - every new node gets Node::Validate().
+ *
+ * Each node is visited once and each edge followed once, so the pass is
+ * linear in the tree size. All memory comes from a caller-supplied scratch
+ * buffer (see CheckScratchBytes()); nothing is allocated. On the first
+ * error the walk stops and the result holds the path from the root to the
+ * offending node.
+ */
+
+#ifndef BT_TREE_CHECK_HPP_
+#define BT_TREE_CHECK_HPP_
+
+#include "behavior_tree.hpp"
+
+namespace bt {
+
+/** @brief CheckTree() error codes. */
+enum class CheckError : uint8_t {
+  kNone = 0,            ///< Graph is a valid tree
+  kInvalidNode,         ///< Node fails Validate() (see validate_error)
+  kCycle,               ///< Node is its own ancestor
+  kSharedStatefulNode,  ///< Stateful node reachable from two parents
+  kTooDeep,             ///< Depth exceeds the max_depth given to CheckTree()
+  kScratchFull          ///< More nodes than the scratch buffer can track
+};
+
+/** @brief Convert CheckError to human-readable string. */
+inline constexpr const char* CheckErrorToString(CheckError e) noexcept {
+  return (e == CheckError::kNone)               ? "NONE"
+       : (e == CheckError::kInvalidNode)        ? "INVALID_NODE"
+       : (e == CheckError::kCycle)              ? "CYCLE"
+       : (e == CheckError::kSharedStatefulNode) ? "SHARED_STATEFUL_NODE"
+       : (e == CheckError::kTooDeep)            ? "TOO_DEEP"
+       : (e == CheckError::kScratchFull)        ? "SCRATCH_FULL"
+       : "UNKNOWN";
+}
+
+/** @brief Shape statistics gathered by CheckTree(). */
+struct TreeStats {
+  uint32_t node_count;    ///< Distinct nodes
+  uint32_t leaf_count;    ///< Distinct leaves
+  uint32_t shared_count;  ///< Extra parent links to stateless leaves
+  uint32_t max_depth;     ///< Levels on the longest path (root = 1)
+  uint16_t max_fanout;    ///< Largest child count
+};
+
+/**
+ * @brief CheckTree() outcome.
+ *
+ * path[0] is the root and path[path_length - 1] the offending node (or, on
+ * success, empty). The path points into the scratch buffer.
+ */
+template <typename Context, typename Observer = NullObserver>
+struct CheckResult {
+  CheckError error;
+  ValidateError validate_error;
+  const Node<Context, Observer>* const* path;
+  uint32_t path_length;
+  TreeStats stats;
+
+  /** @brief Offending node, or nullptr on success. */
+  const Node<Context, Observer>* node() const noexcept {
+    return (path_length > 0U) ? path[path_length - 1U] : nullptr;
+  }
+
+  /**
+   * @brief Write the path as "Root/Child/Leaf" (truncated to fit).
+   * @return Characters written, excluding the terminator.
+   */
+  size_t FormatPath(char* out, size_t size) const noexcept {
+    if (size == 0U) {
+      return 0U;
+    }
+    size_t n = 0;
+    for (uint32_t i = 0; i < path_length; ++i) {
+      const char* name = path[i]->name();
+      if ((i > 0U) && (n + 1U < size)) {
+        out[n++] = '/';
+      }
+      for (const char* p = name; (*p != '\0') && (n + 1U < size); ++p) {
+        out[n++] = *p;
+      }
+    }
+    out[n] = '\0';
+    return n;
+  }
+};
+
+namespace detail {
+
+/** @brief Power-of-two pointer set size keeping the load at most 1/2. */
+inline constexpr size_t CheckTableSlots(uint32_t max_nodes) noexcept {
+  size_t slots = 64U;
+  while (slots < 2U * static_cast<size_t>(max_nodes)) {
+    slots <<= 1U;
+  }
+  return slots;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Scratch bytes CheckTree() needs.
+ * @param max_nodes Upper bound on distinct nodes.
+ * @param max_depth Deepest path to accept.
+ */
+inline constexpr size_t CheckScratchBytes(uint32_t max_nodes,
+                                          uint32_t max_depth) noexcept {
+  // Walk stack, then the pointer set (load <= 1/2) and its on-path bitset
+  return (static_cast<size_t>(max_depth) + 1U) *
+             (sizeof(const void*) + sizeof(uint32_t) + sizeof(uint16_t)) +
+         detail::CheckTableSlots(max_nodes) * sizeof(const void*) +
+         detail::CheckTableSlots(max_nodes) / 8U +
+         2U * alignof(std::max_align_t);
+}
+
+namespace detail {
+
+/** @brief Explicit-stack graph walk behind CheckTree(). */
+template <typename Context, typename Observer>
+class TreeWalker final {
+ public:
+  using NodeT = Node<Context, Observer>;
+
+  TreeWalker(void* scratch, size_t bytes, uint32_t max_depth) noexcept
+      : keys_(nullptr), on_path_(nullptr), mask_(0), limit_(0), count_(0),
+        path_(nullptr), next_(nullptr), slot_(nullptr),
+        max_depth_(max_depth) {
+    // Layout: [path | slot | next] [on_path bits] [keys]
+    const size_t frames = static_cast<size_t>(max_depth) + 1U;
+    unsigned char* p = Align(static_cast<unsigned char*>(scratch),
+                             alignof(const void*));
+    unsigned char* end = static_cast<unsigned char*>(scratch) + bytes;
+    const size_t stack_bytes =
+        frames * (sizeof(const NodeT*) + sizeof(uint32_t) + sizeof(uint16_t));
+    if ((p > end) || (static_cast<size_t>(end - p) < stack_bytes)) {
+      return;
+    }
+    path_ = reinterpret_cast<const NodeT**>(p);
+    slot_ = reinterpret_cast<uint32_t*>(p + frames * sizeof(const NodeT*));
+    next_ = reinterpret_cast<uint16_t*>(
+        p + frames * (sizeof(const NodeT*) + sizeof(uint32_t)));
+    p = Align(p + stack_bytes, alignof(uint64_t));
+
+    // Largest power-of-two table (plus bitset) that fits the rest
+    size_t slots = 0;
+    if (p <= end) {
+      const size_t rest = static_cast<size_t>(end - p);
+      for (size_t s = 64U; s <= rest; s <<= 1U) {
+        if (s * sizeof(const void*) + s / 8U <= rest) {
+          slots = s;
+        }
+      }
+    }
+    if (slots == 0U) {
+      path_ = nullptr;
+      return;
+    }
+    on_path_ = reinterpret_cast<uint64_t*>(p);
+    keys_ = reinterpret_cast<const void**>(p + slots / 8U);
+    std::memset(on_path_, 0, slots / 8U);
+    std::memset(static_cast<void*>(keys_), 0, slots * sizeof(const void*));
+    mask_ = static_cast<uint32_t>(slots - 1U);
+    limit_ = static_cast<uint32_t>(slots / 2U);
+  }
+
+  CheckResult<Context, Observer> Run(const NodeT& root) noexcept {
+    CheckResult<Context, Observer> r{CheckError::kNone, ValidateError::kNone,
+                                     path_, 0U,
+                                     TreeStats{0U, 0U, 0U, 0U, 0U}};
+    if ((path_ == nullptr) || (max_depth_ == 0U)) {
+      r.error = (path_ == nullptr) ? CheckError::kScratchFull
+                                   : CheckError::kTooDeep;
+      return r;
+    }
+
+    uint32_t depth = 0;
+    bool seen = false;
+    uint32_t slot = 0;
+    if (!Insert(&root, seen, slot)) {
+      r.error = CheckError::kScratchFull;
+      return r;
+    }
+    if (!Enter(root, slot, depth, r)) {
+      return r;
+    }
+
+    while (depth > 0U) {
+      const NodeT* node = path_[depth - 1U];
+      const uint16_t i = next_[depth - 1U];
+      if (i >= node->children_count()) {
+        SetOnPath(slot_[depth - 1U], false);
+        --depth;
+        continue;
+      }
+      next_[depth - 1U] = static_cast<uint16_t>(i + 1U);
+      const NodeT* child = node->child(i);  // non-null: parent validated
+
+      if (!Insert(child, seen, slot)) {
+        r.error = CheckError::kScratchFull;
+        return Fail(r, depth, child);
+      }
+      if (seen) {
+        if (OnPath(slot)) {
+          r.error = CheckError::kCycle;
+          return Fail(r, depth, child);
+        }
+        if (!IsStateless(*child)) {
+          r.error = CheckError::kSharedStatefulNode;
+          return Fail(r, depth, child);
+        }
+        ++r.stats.shared_count;
+        if (depth + 1U > r.stats.max_depth) {
+          r.stats.max_depth = depth + 1U;
+        }
+        continue;
+      }
+      if (!Enter(*child, slot, depth, r)) {
+        return r;
+      }
+    }
+    r.path_length = 0U;
+    return r;
+  }
+
+ private:
+  static unsigned char* Align(unsigned char* p, size_t align) noexcept {
+    const uintptr_t a = reinterpret_cast<uintptr_t>(p);
+    return p + (((a + align - 1U) & ~(align - 1U)) - a);
+  }
+
+  /** @brief Leaf with a plain tick and no lifecycle: safe to share. */
+  static bool IsStateless(const NodeT& node) noexcept {
+    return IsLeafType(node.type()) && !node.has_on_enter() &&
+           !node.has_on_exit()
+#if (BT_NODE_STATE_SIZE > 0)
+           && !node.has_state_tick()
+#endif
+        ;
+  }
+
+  static uint32_t Hash(const void* p) noexcept {
+    const uint64_t v = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p));
+    return static_cast<uint32_t>((v * 0x9E3779B97F4A7C15ULL) >> 32U);
+  }
+
+  /** @brief Find or add a node; false when the set is full. */
+  bool Insert(const void* node, bool& seen, uint32_t& slot) noexcept {
+    uint32_t s = Hash(node) & mask_;
+    while (keys_[s] != nullptr) {
+      if (keys_[s] == node) {
+        seen = true;
+        slot = s;
+        return true;
+      }
+      s = (s + 1U) & mask_;
+    }
+    if (count_ >= limit_) {
+      return false;
+    }
+    keys_[s] = node;
+    ++count_;
+    seen = false;
+    slot = s;
+    return true;
+  }
+
+  bool OnPath(uint32_t slot) const noexcept {
+    return (on_path_[slot >> 6U] & (static_cast<uint64_t>(1) << (slot & 63U))) !=
+           0U;
+  }
+
+  void SetOnPath(uint32_t slot, bool on) noexcept {
+    const uint64_t bit = static_cast<uint64_t>(1) << (slot & 63U);
+    on_path_[slot >> 6U] = on ? (on_path_[slot >> 6U] | bit)
+                              : (on_path_[slot >> 6U] & ~bit);
+  }
+
+  /** @brief Validate a new node, count it and push it on the path. */
+  bool Enter(const NodeT& node, uint32_t slot, uint32_t& depth,
+             CheckResult<Context, Observer>& r) noexcept {
+    r.validate_error = node.Validate();
+    if (r.validate_error != ValidateError::kNone) {
+      r.error = CheckError::kInvalidNode;
+      Fail(r, depth, &node);
+      return false;
+    }
+    if (depth >= max_depth_) {
+      r.error = CheckError::kTooDeep;
+      Fail(r, depth, &node);
+      return false;
+    }
+    TreeStats& st = r.stats;
+    ++st.node_count;
+    if (IsLeafType(node.type())) {
+      ++st.leaf_count;
+    }
+    if (node.children_count() > st.max_fanout) {
+      st.max_fanout = node.children_count();
+    }
+    path_[depth] = &node;
+    slot_[depth] = slot;
+    next_[depth] = 0U;
+    SetOnPath(slot, true);
+    ++depth;
+    if (depth > st.max_depth) {
+      st.max_depth = depth;
+    }
+    return true;
+  }
+
+  /** @brief Append the offending node to the current path. */
+  CheckResult<Context, Observer>& Fail(CheckResult<Context, Observer>& r,
+                                       uint32_t depth,
+                                       const NodeT* node) noexcept {
+    path_[depth] = node;  // depth <= max_depth_: one spare frame
+    r.path_length = depth + 1U;
+    return r;
+  }
+
+  const void** keys_;
+  uint64_t* on_path_;
+  uint32_t mask_;
+  uint32_t limit_;
+  uint32_t count_;
+  const NodeT** path_;
+  uint16_t* next_;
+  uint32_t* slot_;
+  uint32_t max_depth_;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Validate a node graph iteratively in linear time.
+ * @param root Root node.
+ * @param scratch Working memory (CheckScratchBytes() bytes suffice).
+ * @param bytes Scratch size.
+ * @param max_depth Deepest path to accept.
+ * @return Error, offending path and statistics.
+ */
+template <typename Context, typename Observer>
+CheckResult<Context, Observer> CheckTree(const Node<Context, Observer>& root,
+                                         void* scratch, size_t bytes,
+                                         uint32_t max_depth) noexcept {
+  detail::TreeWalker<Context, Observer> walker(scratch, bytes, max_depth);
+  return walker.Run(root);
+}
+
+}  // namespace bt
+
+#endif  // BT_TREE_CHECK_HPP_
@@ -0,0 +1,298 @@
+/**
+ * @file tree_patch.hpp
+ * @brief Transactional subtree insert / remove / replace at tick boundaries.
+ *
+ * Editing children through SetChildren() and then calling Reset() on the
+ * whole tree loses RUNNING progress everywhere. A TreePatch records edits
+ * and applies them together between two ticks: either all of them or,
+ * if any would leave an invalid tree, none. Only the edited parents are
+ * touched, and they keep their execution state:
+ *
+ * - Resume indices and parallel done/success bits move with the children
+ *   that shift, so a RUNNING parent resumes the same child.
+ * - A removed or replaced child that is RUNNING is halted first (its
+ *   on_exit callbacks run). The parent then continues with the next
+ *   child, or starts the replacement fresh.
+ *
+ * @code
+ *   // planner thread
+ *   patch.Insert(patrol, 1, new_branch).Remove(fallback, 0);
+ *   patch.Commit();                       // hand over
+ *
+ *   // tick thread
+ *   patch.ApplyCommitted(tree);           // one atomic load if idle
+ *   tree.Tick();
+ *
+ *   // planner thread, later
+ *   if (patch.done()) { log(patch.result()); patch.Clear(); }
+ * @endcode
+ *
+ * Single-threaded users can call Apply(tree) between ticks instead. Halts
+ * go through BehaviorTree::Halt(), so they reach the tree's status stream
+ * and counters; the Context overloads serve bare node trees. Indices
+ * refer to the tree as left by the preceding edits in the same patch.
+ * Inserted subtrees must not already be in the tree (CheckTree() catches
+ * sharing); the patch does not own them.
+ */
+
+#ifndef BT_TREE_PATCH_HPP_
+#define BT_TREE_PATCH_HPP_
+
+#include <atomic>
+
+#include "behavior_tree.hpp"
+
+namespace bt {
+
+/** @brief TreePatch error codes (first failing edit wins). */
+enum class PatchError : uint8_t {
+  kNone = 0,              ///< Applied (or nothing to apply)
+  kTooManyOps,            ///< More edits than kMaxOps were recorded
+  kNotEditable,           ///< Parent is a leaf or SUBTREE, or inverter arity
+  kIndexOutOfRange,       ///< Index beyond the parent's children
+  kChildrenExceedMax,     ///< Insert would exceed BT_MAX_CHILDREN
+  kParallelExceedsBitmap, ///< Insert would exceed 32 parallel children
+  kInvalidBranch          ///< New subtree fails ValidateTree()
+};
+
+/** @brief Convert PatchError to human-readable string. */
+inline constexpr const char* PatchErrorToString(PatchError e) noexcept {
+  return (e == PatchError::kNone)                  ? "NONE"
+       : (e == PatchError::kTooManyOps)            ? "TOO_MANY_OPS"
+       : (e == PatchError::kNotEditable)           ? "NOT_EDITABLE"
+       : (e == PatchError::kIndexOutOfRange)       ? "INDEX_OUT_OF_RANGE"
+       : (e == PatchError::kChildrenExceedMax)     ? "CHILDREN_EXCEED_MAX"
+       : (e == PatchError::kParallelExceedsBitmap) ? "PARALLEL_EXCEEDS_BITMAP"
+       : (e == PatchError::kInvalidBranch)         ? "INVALID_BRANCH"
+       : "UNKNOWN";
+}
+
+/**
+ * @brief Batch of subtree edits applied atomically at a tick boundary.
+ * @tparam Context User-defined context type.
+ * @tparam kMaxOps Edit capacity.
+ * @tparam Observer Observer policy of the edited nodes.
+ *
+ * Recording, Commit() and Clear() belong to one (planner) thread;
+ * ApplyCommitted() to the tick thread.
+ */
+template <typename Context, uint16_t kMaxOps = 16U,
+          typename Observer = NullObserver>
+class TreePatch final {
+ public:
+  using NodeT = Node<Context, Observer>;
+  using TreeT = BehaviorTree<Context, Observer>;
+
+  TreePatch() noexcept
+      : ops_{}, count_(0), overflow_(false), result_(PatchError::kNone),
+        stage_(kOpen) {}
+
+  TreePatch(const TreePatch&) = delete;
+  TreePatch& operator=(const TreePatch&) = delete;
+  TreePatch(TreePatch&&) = delete;
+  TreePatch& operator=(TreePatch&&) = delete;
+
+  // --- Recording ---
+
+  /** @brief Insert @p child as @p parent's child number @p index. */
+  TreePatch& Insert(NodeT& parent, uint16_t index, NodeT& child) noexcept {
+    return Record(Kind::kInsert, parent, index, &child);
+  }
+
+  /** @brief Remove @p parent's child number @p index. */
+  TreePatch& Remove(NodeT& parent, uint16_t index) noexcept {
+    return Record(Kind::kRemove, parent, index, nullptr);
+  }
+
+  /** @brief Replace @p parent's child number @p index with @p child. */
+  TreePatch& Replace(NodeT& parent, uint16_t index, NodeT& child) noexcept {
+    return Record(Kind::kReplace, parent, index, &child);
+  }
+
+  /** @brief Drop all edits and reopen the patch for recording. */
+  void Clear() noexcept {
+    count_ = 0;
+    overflow_ = false;
+    result_ = PatchError::kNone;
+    stage_.store(kOpen, std::memory_order_relaxed);
+  }
+
+  /** @brief Number of recorded edits. */
+  uint16_t size() const noexcept { return count_; }
+
+  // --- Applying ---
+
+  /**
+   * @brief Check every edit against the current tree without changing it.
+   * @param failed_op Receives the index of the first failing edit.
+   */
+  PatchError Check(uint16_t* failed_op = nullptr) const noexcept {
+    if (overflow_) {
+      return Fail(PatchError::kTooManyOps, kMaxOps, failed_op);
+    }
+    for (uint16_t i = 0; i < count_; ++i) {
+      const PatchError err = CheckOp(i);
+      if (err != PatchError::kNone) {
+        return Fail(err, i, failed_op);
+      }
+    }
+    return PatchError::kNone;
+  }
+
+  /**
+   * @brief Apply all edits now, or none if Check() fails (tick thread,
+   *        between two Tick() calls).
+   * @param tree Tree holding the edited nodes; halts its RUNNING removed
+   *        or replaced children through BehaviorTree::Halt().
+   */
+  PatchError Apply(TreeT& tree) noexcept {
+    return ApplyOps(tree.context(), &tree);
+  }
+
+  /** @brief Apply() for nodes outside a BehaviorTree. */
+  PatchError Apply(Context& ctx) noexcept { return ApplyOps(ctx, nullptr); }
+
+  /** @brief Hand the recorded edits to the tick thread. */
+  void Commit() noexcept {
+    stage_.store(kCommitted, std::memory_order_release);
+  }
+
+  /**
+   * @brief Apply a committed patch (tick thread, before Tick()).
+   * @return true if a patch was taken; its outcome is in result().
+   */
+  bool ApplyCommitted(TreeT& tree) noexcept {
+    return TakeCommitted(tree.context(), &tree);
+  }
+
+  /** @brief ApplyCommitted() for nodes outside a BehaviorTree. */
+  bool ApplyCommitted(Context& ctx) noexcept {
+    return TakeCommitted(ctx, nullptr);
+  }
+
+  /** @brief Check if a committed patch has been applied or rejected. */
+  bool done() const noexcept {
+    return stage_.load(std::memory_order_acquire) == kDone;
+  }
+
+  /** @brief Outcome of the last ApplyCommitted() (valid once done()). */
+  PatchError result() const noexcept { return result_; }
+
+ private:
+  enum class Kind : uint8_t { kInsert = 0, kRemove, kReplace };
+
+  static constexpr uint8_t kOpen = 0U;
+  static constexpr uint8_t kCommitted = 1U;
+  static constexpr uint8_t kDone = 2U;
+
+  PatchError ApplyOps(Context& ctx, TreeT* tree) noexcept {
+    const PatchError err = Check();
+    if (err != PatchError::kNone) {
+      return err;
+    }
+    for (uint16_t i = 0; i < count_; ++i) {
+      const Op& op = ops_[i];
+      NodeT& parent = *op.parent;
+      if (op.kind == Kind::kInsert) {
+        parent.InsertChild(op.index, *op.child);
+        continue;
+      }
+      NodeT* old = parent.child(op.index);
+      if (old->is_running()) {
+        if (tree != nullptr) {
+          tree->Halt(*old);
+        } else {
+          old->Halt(ctx);
+        }
+      }
+      if (op.kind == Kind::kRemove) {
+        parent.RemoveChild(op.index);
+      } else {
+        parent.ReplaceChild(op.index, *op.child);
+      }
+    }
+    return PatchError::kNone;
+  }
+
+  bool TakeCommitted(Context& ctx, TreeT* tree) noexcept {
+    if (BT_LIKELY(stage_.load(std::memory_order_acquire) != kCommitted)) {
+      return false;
+    }
+    result_ = ApplyOps(ctx, tree);
+    stage_.store(kDone, std::memory_order_release);
+    return true;
+  }
+
+  struct Op {
+    Kind kind;
+    uint16_t index;
+    NodeT* parent;
+    NodeT* child;  // insert / replace
+  };
+
+  TreePatch& Record(Kind kind, NodeT& parent, uint16_t index,
+                    NodeT* child) noexcept {
+    if (count_ >= kMaxOps) {
+      overflow_ = true;
+      return *this;
+    }
+    ops_[count_] = Op{kind, index, &parent, child};
+    ++count_;
+    return *this;
+  }
+
+  static PatchError Fail(PatchError err, uint16_t op,
+                         uint16_t* failed_op) noexcept {
+    if (failed_op != nullptr) {
+      *failed_op = op;
+    }
+    return err;
+  }
+
+  /** Edit @p i against the parent's child count after edits [0, i). */
+  PatchError CheckOp(uint16_t i) const noexcept {
+    const Op& op = ops_[i];
+    const NodeT& parent = *op.parent;
+    uint32_t count = parent.children_count();
+    for (uint16_t k = 0; k < i; ++k) {
+      if (ops_[k].parent == op.parent) {
+        count = (ops_[k].kind == Kind::kInsert)   ? count + 1U
+              : (ops_[k].kind == Kind::kRemove)   ? count - 1U
+              : count;
+      }
+    }
+
+    const NodeType type = parent.type();
+    if (IsLeafType(type) || (type == NodeType::kSubtree) ||
+        ((type == NodeType::kInverter) && (op.kind != Kind::kReplace))) {
+      return PatchError::kNotEditable;
+    }
+    const uint32_t limit = (op.kind == Kind::kInsert) ? count : count - 1U;
+    if (((count == 0U) && (op.kind != Kind::kInsert)) || (op.index > limit)) {
+      return PatchError::kIndexOutOfRange;
+    }
+    if (op.kind == Kind::kInsert) {
+      if (count >= NodeT::kMaxChildren) {
+        return PatchError::kChildrenExceedMax;
+      }
+      if ((type == NodeType::kParallel) && (count >= 32U)) {
+        return PatchError::kParallelExceedsBitmap;
+      }
+    }
+    if ((op.child != nullptr) &&
+        (op.child->ValidateTree() != ValidateError::kNone)) {
+      return PatchError::kInvalidBranch;
+    }
+    return PatchError::kNone;
+  }
+
+  Op ops_[kMaxOps];
+  uint16_t count_;
+  bool overflow_;
+  PatchError result_;
+  std::atomic<uint8_t> stage_;
+};
+
+}  // namespace bt
+
+#endif  // BT_TREE_PATCH_HPP_
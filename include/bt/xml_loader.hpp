@@ -0,0 +1,542 @@
+/**
+ * @file xml_loader.hpp
+ * @brief Single-pass XML tree loader building straight into a NodeArena.
+ *
+ * Trees can be described in XML and built at startup, so changing a
+ * behavior needs no recompile:
+ *
+ * @code{.xml}
+ *   <BehaviorTree>
+ *     <Sequence name="Root">
+ *       <Condition name="Ready" tick="IsReady"/>
+ *       <Parallel policy="RequireOne">
+ *         <Action tick="LoadConfig" on_enter="LogEnter" on_exit="LogExit"/>
+ *         <Action tick="Timeout"/>
+ *       </Parallel>
+ *       <Inverter>
+ *         <Condition tick="HasError"/>
+ *       </Inverter>
+ *     </Sequence>
+ *   </BehaviorTree>
+ * @endcode
+ *
+ * Elements: Sequence, Selector, Parallel, Inverter, Action, Condition, and
+ * an optional BehaviorTree wrapper. Attributes: name, tick, on_enter,
+ * on_exit, policy (RequireAll | RequireOne). Comments and the XML prolog are
+ * skipped; entities and text content are not supported.
+ *
+ * The parser is a streaming scanner with no DOM: each start tag creates its
+ * node in the arena (so nodes end up contiguous in pre-order), resolves
+ * callback names through the Registry hash table and links the node to the
+ * parent on an explicit stack. Each node is validated when its element
+ * closes, so a successful load yields a tree that passes ValidateTree().
+ * The source text only needs to live for the duration of the call.
+ */
+
+#ifndef BT_XML_LOADER_HPP_
+#define BT_XML_LOADER_HPP_
+
+#include "arena.hpp"
+#include "registry.hpp"
+
+namespace bt {
+
+/** @brief Maximum element nesting depth accepted by the loader. */
+#ifndef BT_LOADER_MAX_DEPTH
+#define BT_LOADER_MAX_DEPTH 64
+#endif
+
+/** @brief Tree loader error codes. */
+enum class LoadError : uint8_t {
+  kNone = 0,            ///< Loaded successfully
+  kSyntax,              ///< Malformed markup or unexpected text
+  kUnknownElement,      ///< Element is not a node type
+  kUnknownAttribute,    ///< Attribute not understood for this element
+  kUnknownFunction,     ///< Callback name not in the registry
+  kWrongFunctionKind,   ///< e.g. tick="..." names a lifecycle callback
+  kMissingTick,         ///< Leaf element without tick attribute
+  kInvalidPolicy,       ///< policy is not RequireAll / RequireOne
+  kMismatchedTag,       ///< End tag does not match start tag
+  kTooManyChildren,     ///< More than BT_MAX_CHILDREN children
+  kTooDeep,             ///< Nesting exceeds BT_LOADER_MAX_DEPTH
+  kArenaFull,           ///< NodeArena exhausted
+  kNoRoot,              ///< Document contains no node
+  kMultipleRoots,       ///< More than one top-level node
+  kInvalidNode          ///< Node failed Validate() (see validate_error)
+};
+
+/** @brief Convert LoadError to human-readable string. */
+inline constexpr const char* LoadErrorToString(LoadError e) noexcept {
+  return (e == LoadError::kNone)               ? "NONE"
+       : (e == LoadError::kSyntax)             ? "SYNTAX"
+       : (e == LoadError::kUnknownElement)     ? "UNKNOWN_ELEMENT"
+       : (e == LoadError::kUnknownAttribute)   ? "UNKNOWN_ATTRIBUTE"
+       : (e == LoadError::kUnknownFunction)    ? "UNKNOWN_FUNCTION"
+       : (e == LoadError::kWrongFunctionKind)  ? "WRONG_FUNCTION_KIND"
+       : (e == LoadError::kMissingTick)        ? "MISSING_TICK"
+       : (e == LoadError::kInvalidPolicy)      ? "INVALID_POLICY"
+       : (e == LoadError::kMismatchedTag)      ? "MISMATCHED_TAG"
+       : (e == LoadError::kTooManyChildren)    ? "TOO_MANY_CHILDREN"
+       : (e == LoadError::kTooDeep)            ? "TOO_DEEP"
+       : (e == LoadError::kArenaFull)          ? "ARENA_FULL"
+       : (e == LoadError::kNoRoot)             ? "NO_ROOT"
+       : (e == LoadError::kMultipleRoots)      ? "MULTIPLE_ROOTS"
+       : (e == LoadError::kInvalidNode)        ? "INVALID_NODE"
+       : "UNKNOWN";
+}
+
+/** @brief Result of a tree load. */
+template <typename Context, typename Observer = NullObserver>
+struct LoadResult {
+  LoadError error;                ///< kNone on success
+  ValidateError validate_error;   ///< Detail for kInvalidNode
+  uint32_t line;                  ///< 1-based error line (0 on success)
+  Node<Context, Observer>* root;  ///< Root node (nullptr on error)
+  uint32_t node_count;            ///< Nodes created
+};
+
+namespace detail {
+
+/** @brief Borrowed character span of the source text. */
+struct TextSpan {
+  const char* data;
+  size_t size;
+
+  bool Equals(const char* literal) const noexcept {
+    return (std::strncmp(data, literal, size) == 0) &&
+           (literal[size] == '\0');
+  }
+};
+
+/** @brief Streaming XML scanner building nodes as it goes. */
+template <typename Context, typename RegistryT, typename Observer>
+class XmlTreeParser final {
+ public:
+  using NodeT = Node<Context, Observer>;
+  using Entry = typename RegistryT::Entry;
+  using Kind = typename RegistryT::Kind;
+
+  XmlTreeParser(const char* text, size_t length, const RegistryT& registry,
+                NodeArena<Context, Observer>& arena) noexcept
+      : begin_(text), p_(text), end_(text + length), registry_(registry),
+        arena_(arena), depth_(0), root_(nullptr), first_node_(0),
+        validate_error_(ValidateError::kNone) {}
+
+  LoadResult<Context, Observer> Parse() noexcept {
+    first_node_ = arena_.node_count();
+    const LoadError err = ParseDocument();
+    LoadResult<Context, Observer> r{err, validate_error_, 0U, nullptr,
+                          arena_.node_count() - first_node_};
+    if (err != LoadError::kNone) {
+      r.line = LineOf(p_);
+    } else {
+      r.root = root_;
+    }
+    return r;
+  }
+
+ private:
+  struct Frame {
+    NodeT* node;       // nullptr for the BehaviorTree wrapper
+    TextSpan element;  // start tag name, matched by the end tag
+  };
+
+  struct Attributes {
+    TextSpan name;
+    TextSpan tick;
+    TextSpan on_enter;
+    TextSpan on_exit;
+    TextSpan policy;
+  };
+
+  static bool IsSpace(char c) noexcept {
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+  }
+
+  static bool IsNameChar(char c) noexcept {
+    return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+           ((c >= '0') && (c <= '9')) || (c == '_') || (c == '-') ||
+           (c == ':') || (c == '.');
+  }
+
+  uint32_t LineOf(const char* pos) const noexcept {
+    uint32_t line = 1;
+    for (const char* c = begin_; (c < pos) && (c < end_); ++c) {
+      if (*c == '\n') {
+        ++line;
+      }
+    }
+    return line;
+  }
+
+  bool StartsWith(const char* literal) const noexcept {
+    const size_t n = std::strlen(literal);
+    return (static_cast<size_t>(end_ - p_) >= n) &&
+           (std::memcmp(p_, literal, n) == 0);
+  }
+
+  void SkipSpace() noexcept {
+    while ((p_ < end_) && IsSpace(*p_)) {
+      ++p_;
+    }
+  }
+
+  bool SkipPast(const char* terminator) noexcept {
+    const size_t n = std::strlen(terminator);
+    while (static_cast<size_t>(end_ - p_) >= n) {
+      if (std::memcmp(p_, terminator, n) == 0) {
+        p_ += n;
+        return true;
+      }
+      ++p_;
+    }
+    return false;
+  }
+
+  TextSpan ReadName() noexcept {
+    const char* start = p_;
+    while ((p_ < end_) && IsNameChar(*p_)) {
+      ++p_;
+    }
+    return TextSpan{start, static_cast<size_t>(p_ - start)};
+  }
+
+  LoadError ParseDocument() noexcept {
+    while (true) {
+      SkipSpace();
+      if (p_ >= end_) {
+        break;
+      }
+      LoadError err = LoadError::kNone;
+      if (StartsWith("<!--")) {
+        err = SkipPast("-->") ? LoadError::kNone : LoadError::kSyntax;
+      } else if (StartsWith("<?")) {
+        err = SkipPast("?>") ? LoadError::kNone : LoadError::kSyntax;
+      } else if (StartsWith("</")) {
+        err = ParseEndTag();
+      } else if (*p_ == '<') {
+        err = ParseStartTag();
+      } else {
+        err = LoadError::kSyntax;  // text content is not supported
+      }
+      if (err != LoadError::kNone) {
+        return err;
+      }
+    }
+    if (depth_ != 0U) {
+      return LoadError::kSyntax;  // unclosed element
+    }
+    return (root_ != nullptr) ? LoadError::kNone : LoadError::kNoRoot;
+  }
+
+  LoadError ParseAttributes(Attributes& attrs, bool& self_closing) noexcept {
+    while (true) {
+      SkipSpace();
+      if (p_ >= end_) {
+        return LoadError::kSyntax;
+      }
+      if (*p_ == '>') {
+        ++p_;
+        self_closing = false;
+        return LoadError::kNone;
+      }
+      if (StartsWith("/>")) {
+        p_ += 2;
+        self_closing = true;
+        return LoadError::kNone;
+      }
+      const TextSpan key = ReadName();
+      SkipSpace();
+      if ((key.size == 0U) || (p_ >= end_) || (*p_ != '=')) {
+        return LoadError::kSyntax;
+      }
+      ++p_;
+      SkipSpace();
+      if ((p_ >= end_) || ((*p_ != '"') && (*p_ != '\''))) {
+        return LoadError::kSyntax;
+      }
+      const char quote = *p_;
+      ++p_;
+      const char* start = p_;
+      while ((p_ < end_) && (*p_ != quote)) {
+        ++p_;
+      }
+      if (p_ >= end_) {
+        return LoadError::kSyntax;
+      }
+      const TextSpan value{start, static_cast<size_t>(p_ - start)};
+      ++p_;
+
+      if (key.Equals("name")) {
+        attrs.name = value;
+      } else if (key.Equals("tick")) {
+        attrs.tick = value;
+      } else if (key.Equals("on_enter")) {
+        attrs.on_enter = value;
+      } else if (key.Equals("on_exit")) {
+        attrs.on_exit = value;
+      } else if (key.Equals("policy")) {
+        attrs.policy = value;
+      } else {
+        p_ = key.data;
+        return LoadError::kUnknownAttribute;
+      }
+    }
+  }
+
+  static bool ElementType(const TextSpan& element, NodeType& type) noexcept {
+    static const struct {
+      const char* tag;
+      NodeType type;
+    } kElements[] = {{"Action", NodeType::kAction},
+                     {"Condition", NodeType::kCondition},
+                     {"Sequence", NodeType::kSequence},
+                     {"Selector", NodeType::kSelector},
+                     {"Parallel", NodeType::kParallel},
+                     {"Inverter", NodeType::kInverter}};
+    for (const auto& e : kElements) {
+      if (element.Equals(e.tag)) {
+        type = e.type;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  LoadError ResolveCallback(const TextSpan& name,
+                            typename NodeT::CallbackFn& out) const noexcept {
+    const Entry* e = registry_.Find(name.data, name.size);
+    if (e == nullptr) {
+      return LoadError::kUnknownFunction;
+    }
+    if (e->kind != Kind::kCallback) {
+      return LoadError::kWrongFunctionKind;
+    }
+    out = e->callback;
+    return LoadError::kNone;
+  }
+
+  LoadError Configure(NodeT& node, NodeType type,
+                      const Attributes& attrs) const noexcept {
+    node.set_type(type);
+
+    if (IsLeafType(type)) {
+      if (attrs.tick.data == nullptr) {
+        return LoadError::kMissingTick;
+      }
+      const Entry* e = registry_.Find(attrs.tick.data, attrs.tick.size);
+      if (e == nullptr) {
+        return LoadError::kUnknownFunction;
+      }
+      if (e->kind == Kind::kTick) {
+        node.set_tick(e->tick);
+#if (BT_NODE_STATE_SIZE > 0)
+      } else if (e->kind == Kind::kStateTick) {
+        node.set_state_tick(e->state_tick);
+#endif
+      } else {
+        return LoadError::kWrongFunctionKind;
+      }
+    } else if (attrs.tick.data != nullptr) {
+      return LoadError::kUnknownAttribute;
+    }
+
+    if (attrs.policy.data != nullptr) {
+      if (type != NodeType::kParallel) {
+        return LoadError::kUnknownAttribute;
+      }
+      if (attrs.policy.Equals("RequireAll")) {
+        node.set_parallel_policy(ParallelPolicy::kRequireAll);
+      } else if (attrs.policy.Equals("RequireOne")) {
+        node.set_parallel_policy(ParallelPolicy::kRequireOne);
+      } else {
+        return LoadError::kInvalidPolicy;
+      }
+    }
+
+    LoadError err = LoadError::kNone;
+    if (attrs.on_enter.data != nullptr) {
+      typename NodeT::CallbackFn fn;
+      err = ResolveCallback(attrs.on_enter, fn);
+      if (err != LoadError::kNone) {
+        return err;
+      }
+      node.set_on_enter(std::move(fn));
+    }
+    if (attrs.on_exit.data != nullptr) {
+      typename NodeT::CallbackFn fn;
+      err = ResolveCallback(attrs.on_exit, fn);
+      if (err != LoadError::kNone) {
+        return err;
+      }
+      node.set_on_exit(std::move(fn));
+    }
+    return LoadError::kNone;
+  }
+
+  /** @brief Node name: explicit name, else the tick name, else "". */
+  const char* NodeName(const Attributes& attrs) noexcept {
+    if (attrs.name.data != nullptr) {
+      return arena_.StoreString(attrs.name.data, attrs.name.size);
+    }
+    if (attrs.tick.data != nullptr) {
+      const Entry* e = registry_.Find(attrs.tick.data, attrs.tick.size);
+      if (e != nullptr) {
+        return e->name;  // static lifetime
+      }
+    }
+    return "";
+  }
+
+  LoadError ParseStartTag() noexcept {
+    const char* tag_start = p_;
+    ++p_;  // '<'
+    const TextSpan element = ReadName();
+    if (element.size == 0U) {
+      return LoadError::kSyntax;
+    }
+
+    Attributes attrs{};
+    bool self_closing = false;
+    LoadError err = ParseAttributes(attrs, self_closing);
+    if (err != LoadError::kNone) {
+      return err;
+    }
+
+    NodeT* parent = (depth_ > 0U) ? stack_[depth_ - 1U].node : nullptr;
+
+    if (element.Equals("BehaviorTree")) {
+      if (depth_ != 0U) {
+        p_ = tag_start;
+        return LoadError::kUnknownElement;
+      }
+      if (!self_closing) {
+        stack_[depth_] = Frame{nullptr, element};
+        ++depth_;
+      }
+      return LoadError::kNone;
+    }
+
+    NodeType type = NodeType::kAction;
+    if (!ElementType(element, type)) {
+      p_ = tag_start;
+      return LoadError::kUnknownElement;
+    }
+
+    if (parent == nullptr) {
+      if (root_ != nullptr) {
+        p_ = tag_start;
+        return LoadError::kMultipleRoots;
+      }
+    } else {
+      if (IsLeafType(parent->type())) {
+        p_ = tag_start;
+        return LoadError::kSyntax;  // leaves cannot have children
+      }
+      if (parent->children_count() >= NodeT::kMaxChildren) {
+        p_ = tag_start;
+        return LoadError::kTooManyChildren;
+      }
+    }
+
+    const char* name = NodeName(attrs);
+    NodeT* node = (name != nullptr) ? arena_.Create(name) : nullptr;
+    if (node == nullptr) {
+      return LoadError::kArenaFull;
+    }
+    err = Configure(*node, type, attrs);
+    if (err != LoadError::kNone) {
+      p_ = tag_start;
+      return err;
+    }
+
+    if (parent != nullptr) {
+      parent->AddChild(*node);
+    } else {
+      root_ = node;
+    }
+
+    if (self_closing) {
+      return Close(*node, tag_start);
+    }
+    if (depth_ >= static_cast<uint32_t>(BT_LOADER_MAX_DEPTH)) {
+      p_ = tag_start;
+      return LoadError::kTooDeep;
+    }
+    stack_[depth_] = Frame{node, element};
+    ++depth_;
+    return LoadError::kNone;
+  }
+
+  LoadError ParseEndTag() noexcept {
+    const char* tag_start = p_;
+    p_ += 2;  // "</"
+    const TextSpan element = ReadName();
+    SkipSpace();
+    if ((p_ >= end_) || (*p_ != '>')) {
+      return LoadError::kSyntax;
+    }
+    ++p_;
+    if (depth_ == 0U) {
+      p_ = tag_start;
+      return LoadError::kMismatchedTag;
+    }
+    const Frame& top = stack_[depth_ - 1U];
+    if ((top.element.size != element.size) ||
+        (std::memcmp(top.element.data, element.data, element.size) != 0)) {
+      p_ = tag_start;
+      return LoadError::kMismatchedTag;
+    }
+    --depth_;
+    return (top.node != nullptr) ? Close(*top.node, tag_start)
+                                 : LoadError::kNone;
+  }
+
+  LoadError Close(const NodeT& node, const char* tag_start) noexcept {
+    validate_error_ = node.Validate();
+    if (validate_error_ != ValidateError::kNone) {
+      p_ = tag_start;
+      return LoadError::kInvalidNode;
+    }
+    return LoadError::kNone;
+  }
+
+  const char* begin_;
+  const char* p_;
+  const char* end_;
+  const RegistryT& registry_;
+  NodeArena<Context, Observer>& arena_;
+  Frame stack_[BT_LOADER_MAX_DEPTH];
+  uint32_t depth_;
+  NodeT* root_;
+  uint32_t first_node_;
+  ValidateError validate_error_;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Build a tree from XML in one streaming pass.
+ * @param text XML source (need not be NUL-terminated).
+ * @param length Source length in bytes.
+ * @param registry Callback names referenced by tick/on_enter/on_exit.
+ * @param arena Receives the nodes and node names.
+ * @return Root and node count, or an error with its source line.
+ *
+ * On error, nodes created so far stay in the arena; call arena.Clear() to
+ * discard them.
+ */
+template <typename Context, uint16_t kRegistryCapacity, typename Observer>
+LoadResult<Context, Observer> LoadXml(
+    const char* text, size_t length,
+    const Registry<Context, kRegistryCapacity>& registry,
+    NodeArena<Context, Observer>& arena) noexcept {
+  detail::XmlTreeParser<Context, Registry<Context, kRegistryCapacity>,
+                        Observer>
+      parser(text, length, registry, arena);
+  return parser.Parse();
+}
+
+}  // namespace bt
+
+#endif  // BT_XML_LOADER_HPP_
@@ -0,0 +1,55 @@
+/**
+ * @file codegen_leaves.hpp
+ * @brief Leaf functions referenced by codegen_sample.xml.
+ */
+
+#ifndef BT_TESTS_CODEGEN_LEAVES_HPP_
+#define BT_TESTS_CODEGEN_LEAVES_HPP_
+
+#include <bt/behavior_tree.hpp>
+
+#include <string>
+
+namespace cg {
+
+struct Ctx {
+  int work_left = 3;
+  bool ready = true;
+  std::string trace;
+};
+
+inline bt::Status Ready(Ctx& ctx) {
+  ctx.trace += 'r';
+  return ctx.ready ? bt::Status::kSuccess : bt::Status::kFailure;
+}
+
+inline bt::Status Work(Ctx& ctx) {
+  ctx.trace += 'w';
+  if (ctx.work_left > 0) {
+    --ctx.work_left;
+    return bt::Status::kRunning;
+  }
+  return bt::Status::kSuccess;
+}
+
+inline bt::Status Fail(Ctx& ctx) {
+  ctx.trace += 'f';
+  return bt::Status::kFailure;
+}
+
+#if (BT_NODE_STATE_SIZE > 0)
+inline bt::Status Count3(Ctx& ctx, bt::NodeState& state) {
+  ctx.trace += 'c';
+  int& n = state.as<int>();
+  return (++n < 3) ? bt::Status::kRunning : bt::Status::kSuccess;
+}
+#else
+inline bt::Status Count3(Ctx& ctx) { return Work(ctx); }
+#endif
+
+inline void Enter(Ctx& ctx) { ctx.trace += '<'; }
+inline void Exit(Ctx& ctx) { ctx.trace += '>'; }
+
+}  // namespace cg
+
+#endif  // BT_TESTS_CODEGEN_LEAVES_HPP_
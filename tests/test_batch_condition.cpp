@@ -0,0 +1,129 @@
+#include <catch2/catch.hpp>
+#include <bt/batch_condition.hpp>
+
+#include <limits>
+#include <string>
+
+namespace {
+
+constexpr uint32_t kAgents = 200;
+
+struct Swarm {
+  bt::Column<float, kAgents> health;
+  bt::Column<int32_t, kAgents> ammo;
+  bt::LaneMask<kAgents> low_health;
+};
+
+using SwarmCtx = bt::AgentContext<Swarm>;
+
+const bt::CompareOp kAllOps[] = {
+    bt::CompareOp::kLess,    bt::CompareOp::kLessEqual,
+    bt::CompareOp::kGreater, bt::CompareOp::kGreaterEqual,
+    bt::CompareOp::kEqual,   bt::CompareOp::kNotEqual};
+
+template <typename T>
+bool Reference(T a, bt::CompareOp op, T b) {
+  switch (op) {
+    case bt::CompareOp::kLess: return a < b;
+    case bt::CompareOp::kLessEqual: return a <= b;
+    case bt::CompareOp::kGreater: return a > b;
+    case bt::CompareOp::kGreaterEqual: return a >= b;
+    case bt::CompareOp::kEqual: return a == b;
+    case bt::CompareOp::kNotEqual: return a != b;
+  }
+  return false;
+}
+
+void Fill(Swarm& s) {
+  for (uint32_t i = 0; i < kAgents; ++i) {
+    s.health[i] = static_cast<float>(i % 50U) - 10.0F;
+    s.ammo[i] = static_cast<int32_t>(i % 7U) - 3;
+  }
+  s.health[5] = std::numeric_limits<float>::quiet_NaN();
+  s.health[130] = std::numeric_limits<float>::quiet_NaN();
+}
+
+}  // namespace
+
+TEST_CASE("Float conditions match scalar semantics", "[batch]") {
+  Swarm s;
+  Fill(s);
+  for (bt::CompareOp op : kAllOps) {
+    bt::LaneMask<kAgents> out;
+    const uint32_t n =
+        bt::EvaluateBatch(bt::Compare(s.health, op, 12.0F), kAgents, out);
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < kAgents; ++i) {
+      const bool ref = Reference(s.health[i], op, 12.0F);
+      INFO("op " << bt::CompareOpToString(op) << " agent " << i);
+      REQUIRE(out.Test(i) == ref);
+      expected += ref ? 1U : 0U;
+    }
+    REQUIRE(n == expected);
+  }
+}
+
+TEST_CASE("Int32 conditions match scalar semantics", "[batch]") {
+  Swarm s;
+  Fill(s);
+  for (bt::CompareOp op : kAllOps) {
+    bt::LaneMask<kAgents> out;
+    bt::EvaluateBatch(bt::Compare(s.ammo, op, 0), kAgents, out);
+    for (uint32_t i = 0; i < kAgents; ++i) {
+      INFO("op " << bt::CompareOpToString(op) << " agent " << i);
+      REQUIRE(out.Test(i) == Reference(s.ammo[i], op, 0));
+    }
+  }
+}
+
+TEST_CASE("SIMD block kernel matches scalar kernel", "[batch]") {
+  Swarm s;
+  Fill(s);
+  for (uint32_t block = 0; block < bt::LaneWords(kAgents); ++block) {
+    const uint32_t off = block * bt::kLanesPerBlock;
+    REQUIRE(bt::EvaluateBlock(
+                bt::Compare(s.ammo, bt::CompareOp::kGreaterEqual, 1), block) ==
+            bt::detail::CompareBlockScalar<bt::CompareOp::kGreaterEqual>(
+                s.ammo.data() + off, 1));
+    REQUIRE(bt::EvaluateBlock(
+                bt::Compare(s.health, bt::CompareOp::kNotEqual, 0.0F),
+                block) ==
+            bt::detail::CompareBlockScalar<bt::CompareOp::kNotEqual>(
+                s.health.data() + off, 0.0F));
+  }
+}
+
+TEST_CASE("Lanes past agent_count are cleared", "[batch]") {
+  Swarm s;  // all zero: padding and tail pass "== 0"
+  bt::LaneMask<kAgents> out;
+  const uint32_t n = bt::EvaluateBatch(
+      bt::Compare(s.ammo, bt::CompareOp::kEqual, 0), 70U, out);
+  REQUIRE(n == 70U);
+  REQUIRE(out.Test(69));
+  REQUIRE(!out.Test(70));
+  REQUIRE(out.words()[1] == ((static_cast<uint64_t>(1) << 6) - 1U));
+}
+
+TEST_CASE("MaskCondition feeds per-agent trees", "[batch]") {
+  Swarm s;
+  Fill(s);
+  bt::EvaluateBatch(bt::Compare(s.health, bt::CompareOp::kLess, 0.0F),
+                    kAgents, s.low_health);
+
+  bt::Node<SwarmCtx> flee("Flee");
+  bt::factory::MakeCondition(
+      flee, bt::MaskCondition<Swarm, kAgents, &Swarm::low_health>);
+
+  SwarmCtx ctx{&s, 0U};
+  for (uint32_t i = 0; i < kAgents; ++i) {
+    ctx.agent = i;
+    REQUIRE(flee.Tick(ctx) == ((s.health[i] < 0.0F) ? bt::Status::kSuccess
+                                                    : bt::Status::kFailure));
+  }
+}
+
+TEST_CASE("CompareOpToString and kernel name", "[batch]") {
+  REQUIRE(std::string(bt::CompareOpToString(bt::CompareOp::kLessEqual)) ==
+          "<=");
+  REQUIRE(std::string(bt::BatchKernelName()).size() > 0U);
+}
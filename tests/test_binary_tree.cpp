@@ -0,0 +1,371 @@
+#include <catch2/catch.hpp>
+#include <bt/binary_tree.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct BinCtx {
+  int work_left = 2;
+  bool ready = true;
+  std::string trace;
+};
+
+bt::Status Ready(BinCtx& ctx) {
+  ctx.trace += 'r';
+  return ctx.ready ? bt::Status::kSuccess : bt::Status::kFailure;
+}
+
+bt::Status Work(BinCtx& ctx) {
+  ctx.trace += 'w';
+  if (ctx.work_left > 0) {
+    --ctx.work_left;
+    return bt::Status::kRunning;
+  }
+  return bt::Status::kSuccess;
+}
+
+bt::Status Fail(BinCtx& ctx) {
+  ctx.trace += 'f';
+  return bt::Status::kFailure;
+}
+
+bt::Status Unregistered(BinCtx& /*ctx*/) { return bt::Status::kSuccess; }
+
+void Enter(BinCtx& ctx) { ctx.trace += '<'; }
+void Exit(BinCtx& ctx) { ctx.trace += '>'; }
+
+#if (BT_NODE_STATE_SIZE > 0)
+bt::Status Count3(BinCtx& ctx, bt::NodeState& state) {
+  ctx.trace += 'c';
+  int& n = state.as<int>();
+  return (++n < 3) ? bt::Status::kRunning : bt::Status::kSuccess;
+}
+#endif
+
+using Registry = bt::Registry<BinCtx>;
+
+void RegisterAll(Registry& reg) {
+  reg.RegisterTick("Ready", Ready);
+  reg.RegisterTick("Work", Work);
+  reg.RegisterTick("Fail", Fail);
+  reg.RegisterCallback("Enter", Enter);
+  reg.RegisterCallback("Exit", Exit);
+#if (BT_NODE_STATE_SIZE > 0)
+  reg.RegisterStateTick("Count3", Count3);
+#endif
+}
+
+/*
+ * Sequence "Root" (Enter/Exit)
+ * +-- Condition Ready
+ * +-- Parallel RequireAll
+ * |   +-- Action Work (Enter/Exit)
+ * |   +-- Action Count3 (stateful) | Work
+ * +-- Selector
+ *     +-- Inverter
+ *     |   +-- Condition Ready
+ *     +-- Action Fail
+ *     +-- Action Work
+ */
+struct SampleTree {
+  bt::Node<BinCtx> root{"Root"}, ready{"Ready"}, par{"Par"}, work{"Work"},
+      count{"Count"}, sel{"Sel"}, inv{"Inv"}, ready2{"Ready2"}, fail{"Fail"},
+      work2{"Work2"};
+
+  SampleTree() {
+    root.set_type(bt::NodeType::kSequence).set_on_enter(Enter).set_on_exit(
+        Exit);
+    bt::factory::MakeCondition(ready, Ready);
+    par.set_type(bt::NodeType::kParallel);
+    bt::factory::MakeAction(work, Work).set_on_enter(Enter).set_on_exit(Exit);
+#if (BT_NODE_STATE_SIZE > 0)
+    bt::factory::MakeStatefulAction(count, Count3);
+#else
+    bt::factory::MakeAction(count, Work);
+#endif
+    par.AddChild(work).AddChild(count);
+    sel.set_type(bt::NodeType::kSelector);
+    bt::factory::MakeCondition(ready2, Ready);
+    inv.set_type(bt::NodeType::kInverter).AddChild(ready2);
+    bt::factory::MakeAction(fail, Fail);
+    bt::factory::MakeAction(work2, Work);
+    sel.AddChild(inv).AddChild(fail).AddChild(work2);
+    root.AddChild(ready).AddChild(par).AddChild(sel);
+  }
+};
+
+std::vector<uint32_t> SerializeTree(const bt::Node<BinCtx>& root,
+                                    const Registry& reg) {
+  const bt::SerializeResult probe = bt::Serialize(root, reg, nullptr, 0);
+  REQUIRE(probe.error == bt::BinaryError::kBufferTooSmall);
+  std::vector<uint32_t> image((probe.size + 3U) / 4U);
+  const bt::SerializeResult r =
+      bt::Serialize(root, reg, image.data(), image.size() * 4U);
+  REQUIRE(r.error == bt::BinaryError::kNone);
+  REQUIRE(r.size == probe.size);
+  return image;
+}
+
+/* Recompute the checksum after editing an image in place. */
+void Rehash(std::vector<uint32_t>& image) {
+  bt::BtbHeader& h = *reinterpret_cast<bt::BtbHeader*>(image.data());
+  const char* body =
+      reinterpret_cast<const char*>(image.data()) + sizeof(bt::BtbHeader);
+  h.checksum = bt::HashName(body, h.total_size - sizeof(bt::BtbHeader));
+}
+
+}  // namespace
+
+TEST_CASE("Serialize writes a pre-ordered image", "[binary]") {
+  Registry reg;
+  RegisterAll(reg);
+  SampleTree t;
+  const std::vector<uint32_t> buffer = SerializeTree(t.root, reg);
+
+  bt::BinaryImage image;
+  REQUIRE(image.Open(buffer.data(), buffer.size() * 4U) ==
+          bt::BinaryError::kNone);
+  REQUIRE(image.Verify() == bt::BinaryError::kNone);
+  REQUIRE(image.node_count() == 10U);
+  REQUIRE(image.header().version == bt::kBtbVersion);
+
+  const char* expected[] = {"Root", "Ready", "Par",    "Work",  "Count",
+                            "Sel",  "Inv",   "Ready2", "Fail",  "Work2"};
+  for (uint32_t i = 0; i < 10U; ++i) {
+    REQUIRE(std::strcmp(image.node_name(i), expected[i]) == 0);
+  }
+  REQUIRE(image.nodes()[0].child_count == 3U);
+  REQUIRE(image.nodes()[2].type == bt::NodeType::kParallel);
+  REQUIRE(image.nodes()[0].on_enter != bt::kNoFunction);
+  REQUIRE(image.nodes()[1].on_enter == bt::kNoFunction);
+
+  // Only functions used by the tree, each once
+  const uint32_t functions = (BT_NODE_STATE_SIZE > 0) ? 6U : 5U;
+  REQUIRE(image.function_count() == functions);
+}
+
+TEST_CASE("Flat executor matches Node ticking", "[binary]") {
+  Registry reg;
+  RegisterAll(reg);
+  SampleTree t;
+  const std::vector<uint32_t> buffer = SerializeTree(t.root, reg);
+
+  bt::BinaryImage image;
+  REQUIRE(image.Open(buffer.data(), buffer.size() * 4U) ==
+          bt::BinaryError::kNone);
+  bt::BoundFunctions<Registry> functions;
+  REQUIRE(functions.Bind(image, reg) == bt::BinaryError::kNone);
+
+  BinCtx node_ctx, flat_ctx;
+  bt::BehaviorTree<BinCtx> tree(t.root, node_ctx);
+  std::vector<bt::FlatSlot> slots(image.node_count());
+  auto flat = image.MakeExecutor(functions, slots.data(), flat_ctx);
+
+  const bt::Node<BinCtx>* order[] = {&t.root, &t.ready, &t.par,   &t.work,
+                                     &t.count, &t.sel,  &t.inv,   &t.ready2,
+                                     &t.fail, &t.work2};
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < 8; ++i) {
+      if (i == 5) {
+        node_ctx.ready = flat_ctx.ready = false;
+      }
+      REQUIRE(flat.Tick() == tree.Tick());
+      REQUIRE(flat_ctx.trace == node_ctx.trace);
+      for (uint32_t n = 0; n < 10U; ++n) {
+        REQUIRE(flat.status(n) == order[n]->status());
+      }
+    }
+    tree.Reset();
+    flat.Reset();
+    node_ctx = BinCtx{};
+    flat_ctx = BinCtx{};
+  }
+}
+
+TEST_CASE("Serialize rejects unregistered and invalid trees", "[binary]") {
+  Registry reg;
+  RegisterAll(reg);
+  static uint32_t buffer[1024];
+
+  bt::Node<BinCtx> seq("Seq"), leaf("Leaf");
+  seq.set_type(bt::NodeType::kSequence).AddChild(leaf);
+
+  bt::factory::MakeAction(leaf, Unregistered);
+  REQUIRE(bt::Serialize(seq, reg, buffer, sizeof(buffer)).error ==
+          bt::BinaryError::kUnregisteredFunction);
+
+  leaf.set_tick(nullptr);
+  REQUIRE(bt::Serialize(seq, reg, buffer, sizeof(buffer)).error ==
+          bt::BinaryError::kInvalidNode);
+
+  bt::factory::MakeAction(leaf, Work);
+  const bt::SerializeResult small = bt::Serialize(seq, reg, buffer, 16U);
+  REQUIRE(small.error == bt::BinaryError::kBufferTooSmall);
+  REQUIRE(small.size > 16U);
+
+  unsigned char* bytes = reinterpret_cast<unsigned char*>(buffer);
+  REQUIRE(bt::Serialize(seq, reg, bytes + 1, sizeof(buffer) - 4U).error ==
+          bt::BinaryError::kMisaligned);
+}
+
+TEST_CASE("BinaryImage detects damaged images", "[binary]") {
+  Registry reg;
+  RegisterAll(reg);
+  SampleTree t;
+  std::vector<uint32_t> buffer = SerializeTree(t.root, reg);
+  const size_t size = buffer.size() * 4U;
+  bt::BinaryImage image;
+
+  SECTION("bad magic") {
+    buffer[0] ^= 1U;
+    REQUIRE(image.Open(buffer.data(), size) == bt::BinaryError::kBadMagic);
+    REQUIRE_FALSE(image.is_open());
+  }
+  SECTION("future version") {
+    reinterpret_cast<bt::BtbHeader*>(buffer.data())->version = 99U;
+    REQUIRE(image.Open(buffer.data(), size) ==
+            bt::BinaryError::kUnsupportedVersion);
+  }
+  SECTION("truncated") {
+    REQUIRE(image.Open(buffer.data(), size - 8U) ==
+            bt::BinaryError::kTruncated);
+    REQUIRE(image.Open(buffer.data(), 10U) == bt::BinaryError::kTruncated);
+  }
+  SECTION("size or sections overlapping the header") {
+    bt::BtbHeader& h = *reinterpret_cast<bt::BtbHeader*>(buffer.data());
+    h.nodes_offset = 0U;  // node 0 would alias the header
+    REQUIRE(image.Open(buffer.data(), size) == bt::BinaryError::kTruncated);
+    REQUIRE(image.Verify() == bt::BinaryError::kTruncated);
+
+    // 48-byte header claiming a 24-byte image: the checksum length of
+    // total_size - sizeof(BtbHeader) would wrap around
+    uint32_t crafted[sizeof(bt::BtbHeader) / 4U] = {};
+    bt::BtbHeader& c = *reinterpret_cast<bt::BtbHeader*>(crafted);
+    c.magic = bt::kBtbMagic;
+    c.version = bt::kBtbVersion;
+    c.header_size = sizeof(bt::BtbHeader);
+    c.total_size = 24U;
+    c.node_count = 1U;
+    c.strings_size = 1U;
+    REQUIRE(image.Open(crafted, sizeof(crafted)) ==
+            bt::BinaryError::kTruncated);
+    REQUIRE_FALSE(image.is_open());
+    REQUIRE(image.Verify() == bt::BinaryError::kTruncated);
+  }
+  SECTION("flipped byte fails Verify") {
+    buffer[sizeof(bt::BtbHeader) / 4U + 1U] ^= 0x10000U;
+    REQUIRE(image.Open(buffer.data(), size) == bt::BinaryError::kNone);
+    REQUIRE(image.Verify() == bt::BinaryError::kCorrupt);
+  }
+  SECTION("tick swapped with a callback fails Verify") {
+    REQUIRE(image.Open(buffer.data(), size) == bt::BinaryError::kNone);
+    bt::FlatNode& work = const_cast<bt::FlatNode&>(image.nodes()[3]);
+    std::swap(work.tick, work.on_enter);
+    Rehash(buffer);
+    REQUIRE(image.Verify() == bt::BinaryError::kCorrupt);
+  }
+  SECTION("callback slot holding a tick fails Verify") {
+    REQUIRE(image.Open(buffer.data(), size) == bt::BinaryError::kNone);
+    bt::FlatNode& root = const_cast<bt::FlatNode&>(image.nodes()[0]);
+    root.on_exit = image.nodes()[1].tick;
+    Rehash(buffer);
+    REQUIRE(image.Verify() == bt::BinaryError::kCorrupt);
+  }
+  SECTION("bad parallel policy fails Verify") {
+    REQUIRE(image.Open(buffer.data(), size) == bt::BinaryError::kNone);
+    bt::FlatNode& par = const_cast<bt::FlatNode&>(image.nodes()[2]);
+    par.policy = static_cast<bt::ParallelPolicy>(7);
+    Rehash(buffer);
+    REQUIRE(image.Verify() == bt::BinaryError::kCorrupt);
+  }
+  SECTION("missing function at bind") {
+    REQUIRE(image.Open(buffer.data(), size) == bt::BinaryError::kNone);
+    Registry other;
+    other.RegisterTick("Ready", Ready);
+    bt::BoundFunctions<Registry> functions;
+    REQUIRE(functions.Bind(image, other) == bt::BinaryError::kUnknownFunction);
+  }
+  SECTION("function registered with another kind") {
+    REQUIRE(image.Open(buffer.data(), size) == bt::BinaryError::kNone);
+    Registry other;
+    other.RegisterCallback("Ready", Enter);
+    RegisterAll(other);  // "Ready" already taken by the callback
+    bt::BoundFunctions<Registry> functions;
+    REQUIRE(functions.Bind(image, other) ==
+            bt::BinaryError::kWrongFunctionKind);
+  }
+}
+
+TEST_CASE("Verify rejects parallel nodes over 32 children", "[binary]") {
+  Registry reg;
+  RegisterAll(reg);
+  // Root -> 5 sequences x 8 conditions: 45 child table entries
+  bt::Node<BinCtx> root("Root");
+  bt::Node<BinCtx> groups[5];
+  bt::Node<BinCtx> leaves[5][8];
+  root.set_type(bt::NodeType::kSequence);
+  for (int g = 0; g < 5; ++g) {
+    groups[g].set_type(bt::NodeType::kSequence);
+    for (int l = 0; l < 8; ++l) {
+      bt::factory::MakeCondition(leaves[g][l], Ready);
+      groups[g].AddChild(leaves[g][l]);
+    }
+    root.AddChild(groups[g]);
+  }
+  std::vector<uint32_t> buffer = SerializeTree(root, reg);
+  bt::BinaryImage image;
+  REQUIRE(image.Open(buffer.data(), buffer.size() * 4U) ==
+          bt::BinaryError::kNone);
+  REQUIRE(image.header().child_count == 45U);
+
+  // Make the root a parallel over the first table entries (all > 0)
+  bt::FlatNode& r = const_cast<bt::FlatNode&>(image.nodes()[0]);
+  r.type = bt::NodeType::kParallel;
+  r.first_child = 0U;
+  r.child_count = 32U;
+  Rehash(buffer);
+  REQUIRE(image.Verify() == bt::BinaryError::kNone);
+  r.child_count = 33U;
+  Rehash(buffer);
+  REQUIRE(image.Verify() == bt::BinaryError::kCorrupt);
+}
+
+#if defined(BT_HAS_MMAP)
+TEST_CASE("MappedFile ticks a tree straight from the mapping", "[binary]") {
+  Registry reg;
+  RegisterAll(reg);
+  SampleTree t;
+  const std::vector<uint32_t> buffer = SerializeTree(t.root, reg);
+
+  const std::string path = "bt_test_tree.btb";
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  REQUIRE(f != nullptr);
+  REQUIRE(std::fwrite(buffer.data(), 4U, buffer.size(), f) == buffer.size());
+  std::fclose(f);
+
+  {
+    bt::MappedFile file;
+    REQUIRE(file.Open(path.c_str()) == bt::BinaryError::kNone);
+    bt::BinaryImage image;
+    REQUIRE(image.Open(file.data(), file.size()) == bt::BinaryError::kNone);
+    REQUIRE(image.Verify() == bt::BinaryError::kNone);
+    bt::BoundFunctions<Registry> functions;
+    REQUIRE(functions.Bind(image, reg) == bt::BinaryError::kNone);
+
+    BinCtx ctx;
+    std::vector<bt::FlatSlot> slots(image.node_count());
+    auto tree = image.MakeExecutor(functions, slots.data(), ctx);
+    REQUIRE(tree.Tick() == bt::Status::kRunning);
+    REQUIRE(tree.slot(0).status == bt::Status::kRunning);
+  }
+  std::remove(path.c_str());
+
+  bt::MappedFile missing;
+  REQUIRE(missing.Open("does/not/exist.btb") == bt::BinaryError::kIoError);
+}
+#endif
@@ -0,0 +1,112 @@
+#include <catch2/catch.hpp>
+#include <bt/blackboard.hpp>
+
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kAgents = 150;
+
+struct Crowd {
+  bt::Column<float, kAgents> health;
+  bt::Column<int32_t, kAgents> ammo;
+};
+
+using AgentCtx = bt::AgentContext<Crowd>;
+
+bt::Status LowHealth(AgentCtx& c) {
+  return (c.at(&Crowd::health) < 20.0F) ? bt::Status::kSuccess
+                                        : bt::Status::kFailure;
+}
+
+bt::Status HasAmmo(AgentCtx& c) {
+  return (c.at(&Crowd::ammo) > 0) ? bt::Status::kSuccess
+                                  : bt::Status::kFailure;
+}
+
+}  // namespace
+
+TEST_CASE("Column is aligned, padded and zeroed", "[blackboard]") {
+  Crowd crowd;
+  REQUIRE(bt::Column<float, kAgents>::kPaddedSize == 192U);
+  REQUIRE((reinterpret_cast<uintptr_t>(crowd.health.data()) % 64U) == 0U);
+  REQUIRE(crowd.health.data()[kAgents + 10] == 0.0F);
+
+  crowd.ammo.Fill(7);
+  crowd.ammo[3] = 1;
+  REQUIRE(crowd.ammo[0] == 7);
+  REQUIRE(crowd.ammo.data()[3] == 1);
+}
+
+TEST_CASE("AgentContext reads the agent's column slot", "[blackboard]") {
+  Crowd crowd;
+  crowd.health[42] = 5.0F;
+  AgentCtx ctx{&crowd, 42U};
+  REQUIRE(ctx.at(&Crowd::health) == 5.0F);
+
+  ctx.at(&Crowd::health) = 6.0F;
+  REQUIRE(crowd.health[42] == 6.0F);
+}
+
+TEST_CASE("LaneMask set, test and count", "[blackboard]") {
+  bt::LaneMask<kAgents> mask;
+  REQUIRE(bt::LaneMask<kAgents>::kWordCount == 3U);
+  mask.Set(0, true);
+  mask.Set(63, true);
+  mask.Set(64, true);
+  mask.Set(149, true);
+  REQUIRE(mask.Test(63));
+  REQUIRE(!mask.Test(62));
+  REQUIRE(mask.Count() == 4U);
+  REQUIRE(mask.Count(64) == 2U);
+
+  mask.Set(63, false);
+  REQUIRE(!mask.Test(63));
+  mask.Clear();
+  REQUIRE(mask.Count() == 0U);
+}
+
+TEST_CASE("ForEachLane visits set agents in order", "[blackboard]") {
+  bt::LaneMask<kAgents> mask;
+  mask.Set(2, true);
+  mask.Set(70, true);
+  mask.Set(130, true);
+  mask.Set(149, true);
+
+  std::vector<uint32_t> seen;
+  bt::ForEachLane(mask, 140U, [&seen](uint32_t a) { seen.push_back(a); });
+  REQUIRE(seen == std::vector<uint32_t>{2, 70, 130});
+}
+
+TEST_CASE("TickBatch evaluates a guard for all agents", "[blackboard]") {
+  Crowd crowd;
+  for (uint32_t i = 0; i < kAgents; ++i) {
+    crowd.health[i] = static_cast<float>(i % 40U);
+    crowd.ammo[i] = static_cast<int32_t>(i % 3U);
+  }
+
+  // Flee = LowHealth AND HasAmmo, one shared tree for all agents
+  bt::Node<AgentCtx> low("LowHealth"), ammo("HasAmmo"), flee("Flee");
+  bt::factory::MakeCondition(low, LowHealth);
+  bt::factory::MakeCondition(ammo, HasAmmo);
+  flee.set_type(bt::NodeType::kSequence).AddChild(low).AddChild(ammo);
+
+  bt::LaneMask<kAgents> result;
+  const uint32_t n = bt::TickBatch(flee, crowd, kAgents, result);
+
+  uint32_t expected = 0;
+  for (uint32_t i = 0; i < kAgents; ++i) {
+    const bool pass = (crowd.health[i] < 20.0F) && (crowd.ammo[i] > 0);
+    REQUIRE(result.Test(i) == pass);
+    expected += pass ? 1U : 0U;
+  }
+  REQUIRE(n == expected);
+  REQUIRE(result.Count() == expected);
+}
+
+TEST_CASE("ValidLanes masks the tail block", "[blackboard]") {
+  REQUIRE(bt::ValidLanes(150, 0) == ~static_cast<uint64_t>(0));
+  REQUIRE(bt::ValidLanes(150, 2) == ((static_cast<uint64_t>(1) << 22) - 1U));
+  REQUIRE(bt::ValidLanes(128, 2) == 0U);
+  REQUIRE(bt::LaneWords(129) == 3U);
+}
@@ -0,0 +1,129 @@
+#include <catch2/catch.hpp>
+#include <bt/chrome_trace.hpp>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+struct ChromeCtx {
+  int ticks = 0;
+};
+
+using NodeT = bt::Node<ChromeCtx>;
+
+bt::Status Ok(ChromeCtx& /*ctx*/) { return bt::Status::kSuccess; }
+
+/* RUNNING on the first tick, SUCCESS on the second. */
+bt::Status Twice(ChromeCtx& ctx) {
+  return ((++ctx.ticks % 2) != 0) ? bt::Status::kRunning
+                                  : bt::Status::kSuccess;
+}
+
+uint64_t g_clock = 0;
+
+/* Advances 1.5 us per read. */
+uint64_t FakeClock() {
+  g_clock += 1500U;
+  return g_clock;
+}
+
+std::string ReadAll(std::FILE* f) {
+  std::string out;
+  std::rewind(f);
+  char buf[256];
+  size_t n = 0;
+  while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0U) {
+    out.append(buf, n);
+  }
+  return out;
+}
+
+size_t Count(const std::string& s, const std::string& needle) {
+  size_t n = 0;
+  for (size_t pos = s.find(needle); pos != std::string::npos;
+       pos = s.find(needle, pos + 1U)) {
+    ++n;
+  }
+  return n;
+}
+
+}  // namespace
+
+TEST_CASE("CollectNodeNames maps ids to names", "[chrome_trace]") {
+  NodeT root("Root"), a("A"), b("B");
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(b);
+  bt::AssignNodeIds(root);
+
+  const char* names[2] = {nullptr, nullptr};
+  bt::CollectNodeNames(root, names, 2);
+  REQUIRE(std::string(names[0]) == "Root");
+  REQUIRE(std::string(names[1]) == "A");
+}
+
+TEST_CASE("Chrome trace has nested and async events", "[chrome_trace]") {
+  NodeT root("Root"), a("A"), b("Wait \"slow\"");
+  bt::factory::MakeAction(a, Ok);
+  bt::factory::MakeAction(b, Twice);
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(b);
+  bt::AssignNodeIds(root);
+  const char* names[3] = {};
+  bt::CollectNodeNames(root, names, 3);
+
+  bt::TraceEvent storage[16];
+  g_clock = 0;
+  bt::TickTracer tracer(storage, 16, FakeClock);
+  ChromeCtx ctx;
+  bt::BehaviorTree<ChromeCtx> tree(root, ctx);
+  tree.set_tracer(&tracer);
+  tree.Tick();
+  tree.Tick();
+
+  std::FILE* f = std::tmpfile();
+  REQUIRE(f != nullptr);
+  bt::ChromeTraceWriter writer(f);
+  writer.NameTrack(7, "npc");
+  REQUIRE(writer.Drain(tracer, 7, names, 2) == 5U);  // B has no name entry
+  REQUIRE(writer.events() == 5U);
+  REQUIRE(writer.Finish());
+  const std::string json = ReadAll(f);
+  std::fclose(f);
+
+  REQUIRE(json.compare(0, 16, "{\"traceEvents\":[") == 0);
+  REQUIRE(json.find("]}") != std::string::npos);
+  REQUIRE(json.find("\"thread_name\",\"args\":{\"name\":\"npc\"}") !=
+          std::string::npos);
+  REQUIRE(Count(json, "\"ph\":\"X\"") == 5U);
+  REQUIRE(Count(json, "\"tid\":7") == 10U);  // name + 5 X + 4 async
+  REQUIRE(Count(json, "\"name\":\"Root\"") == 4U);  // 2 ticks + async b/e
+  REQUIRE(Count(json, "\"name\":\"node 2\"") == 4U);
+
+  // A is written first (origin) and lasts one clock read; Root, its
+  // parent, started 1.5 us earlier
+  REQUIRE(json.find("\"ts\":0.000,\"dur\":1.500,\"name\":\"A\"") !=
+          std::string::npos);
+  REQUIRE(json.find("\"ts\":-1.500,\"dur\":") != std::string::npos);
+  // One RUNNING span each for B and Root
+  REQUIRE(Count(json, "\"ph\":\"b\"") == 2U);
+  REQUIRE(Count(json, "\"ph\":\"e\"") == 2U);
+  REQUIRE(json.find("\"id\":\"7.2\"") != std::string::npos);
+}
+
+TEST_CASE("Chrome trace escapes names and spans buffers", "[chrome_trace]") {
+  std::FILE* f = std::tmpfile();
+  REQUIRE(f != nullptr);
+  bt::ChromeTraceWriter writer(f);
+  const char* names[1] = {"a\"b\\c\n"};
+  bt::TraceEvent e{1000000U, 2500U, 0U, bt::Status::kFailure,
+                   bt::Status::kSuccess};
+  for (int i = 0; i < 500; ++i) {
+    writer.Write(&e, 1, 1, names, 1);
+  }
+  REQUIRE(writer.Finish());
+  const std::string json = ReadAll(f);
+  std::fclose(f);
+
+  REQUIRE(Count(json, "\"name\":\"a\\\"b\\\\c\\u000a\"") == 500U);
+  REQUIRE(Count(json, "\"dur\":2.500") == 500U);
+  REQUIRE(json.find("\"ts\":0.000") != std::string::npos);
+}
@@ -0,0 +1,147 @@
+#include <catch2/catch.hpp>
+#include <bt/flame_graph.hpp>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+struct FlameCtx {};
+
+using NodeT = bt::Node<FlameCtx>;
+
+uint64_t g_clock = 0;
+
+/* Advances 1 unit per read; leaves add their own cost. */
+uint64_t FakeClock() { return ++g_clock; }
+
+bt::Status Cost10(FlameCtx& /*ctx*/) {
+  g_clock += 10U;
+  return bt::Status::kSuccess;
+}
+
+bt::Status Cost100(FlameCtx& /*ctx*/) {
+  g_clock += 100U;
+  return bt::Status::kFailure;
+}
+
+std::string ReadAll(std::FILE* f) {
+  std::string out;
+  std::rewind(f);
+  char buf[256];
+  size_t n = 0;
+  while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0U) {
+    out.append(buf, n);
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST_CASE("Folded stacks follow tree paths", "[flame_graph]") {
+  // Root(Sel) -> [Check(Seq) -> [Read;Sensor, Slow], Idle]
+  NodeT root("Root"), check("Check"), read("Read;Sensor"), slow("Slow"),
+      idle("Idle");
+  bt::factory::MakeAction(read, Cost10);
+  bt::factory::MakeAction(slow, Cost100);
+  bt::factory::MakeAction(idle, Cost10);
+  check.set_type(bt::NodeType::kSequence).AddChild(read).AddChild(slow);
+  root.set_type(bt::NodeType::kSelector).AddChild(check).AddChild(idle);
+  bt::AssignNodeIds(root);
+  const char* names[4] = {};
+  bt::CollectNodeNames(root, names, 4);  // Idle (id 4) stays unnamed
+
+  bt::NodeProfile nodes[5];
+  bt::PathSlot paths[16];
+  g_clock = 0;
+  bt::TickProfiler profiler(nodes, 5, FakeClock);
+  REQUIRE(profiler.paths() == nullptr);
+  profiler.set_paths(paths, 16);
+  REQUIRE(profiler.path_capacity() == 16U);
+
+  FlameCtx ctx;
+  bt::BehaviorTree<FlameCtx> tree(root, ctx);
+  tree.set_profiler(&profiler);
+  for (int i = 0; i < 3; ++i) {
+    tree.Tick();
+  }
+  REQUIRE(profiler.path_overflow() == 0U);
+
+  std::FILE* f = std::tmpfile();
+  REQUIRE(f != nullptr);
+  REQUIRE(bt::WriteFoldedStacks(profiler, names, 4, f) == 5U);
+  const std::string folded = ReadAll(f);
+  std::fclose(f);
+
+  // Leaf weights are own cost + 1 clock read, times 3 ticks
+  REQUIRE(folded.find("Root;Check;Read:Sensor 33\n") != std::string::npos);
+  REQUIRE(folded.find("Root;Check;Slow 303\n") != std::string::npos);
+  REQUIRE(folded.find("Root;node 4 33\n") != std::string::npos);
+  REQUIRE(folded.find("Root;Check 9\n") != std::string::npos);
+  REQUIRE(folded.find("Root 9\n") != std::string::npos);
+
+  // Path weights add up to the root's inclusive time
+  const uint64_t total = 33U + 303U + 33U + 9U + 9U;
+  REQUIRE(profiler.node(0)->inclusive == total);
+
+  profiler.Reset();
+  f = std::tmpfile();
+  REQUIRE(bt::WriteFoldedStacks(profiler, names, 4, f) == 0U);
+  std::fclose(f);
+}
+
+TEST_CASE("Same node under two parents is two paths", "[flame_graph]") {
+  NodeT root("Root"), a("A"), b("B"), leaf1("Leaf"), leaf2("Leaf");
+  bt::factory::MakeAction(leaf1, Cost10);
+  bt::factory::MakeAction(leaf2, Cost10);
+  bt::factory::MakeInverter(a, leaf1);
+  bt::factory::MakeInverter(b, leaf2);
+  root.set_type(bt::NodeType::kParallel).AddChild(a).AddChild(b);
+  bt::AssignNodeIds(root);
+  leaf2.set_id(leaf1.id());  // one template node used twice
+
+  bt::NodeProfile nodes[8];
+  bt::PathSlot paths[8];
+  bt::TickProfiler profiler(nodes, 8, FakeClock);
+  profiler.set_paths(paths, 8);
+  {
+    const bt::TickProfiler::Scope scope(&profiler);
+    FlameCtx ctx;
+    root.Tick(ctx);
+  }
+  REQUIRE(nodes[leaf1.id()].calls == 2U);
+  uint32_t leaf_paths = 0;
+  for (const bt::PathSlot& p : paths) {
+    leaf_paths += ((p.key != 0U) && (p.node_id == leaf1.id())) ? 1U : 0U;
+  }
+  REQUIRE(leaf_paths == 2U);
+}
+
+TEST_CASE("A full path table counts overflow", "[flame_graph]") {
+  NodeT root("Root"), a("A"), b("B"), c("C");
+  bt::factory::MakeAction(a, Cost10);
+  bt::factory::MakeAction(b, Cost10);
+  bt::factory::MakeAction(c, Cost10);
+  root.set_type(bt::NodeType::kParallel).AddChild(a).AddChild(b).AddChild(c);
+  bt::AssignNodeIds(root);
+
+  bt::NodeProfile nodes[4];
+  bt::PathSlot paths[3];
+  bt::TickProfiler profiler(nodes, 4, FakeClock);
+  profiler.set_paths(paths, 3);
+  REQUIRE(profiler.path_capacity() == 2U);
+  {
+    const bt::TickProfiler::Scope scope(&profiler);
+    FlameCtx ctx;
+    root.Tick(ctx);
+  }
+  REQUIRE(profiler.path_overflow() == 2U);  // 4 paths, 2 slots
+  REQUIRE(nodes[0].calls == 1U);            // per-node data is unaffected
+
+  // Stacks whose ancestors were not recorded are cut at the gap
+  std::FILE* f = std::tmpfile();
+  REQUIRE(bt::WriteFoldedStacks(profiler, nullptr, 0, f) == 2U);
+  const std::string folded = ReadAll(f);
+  std::fclose(f);
+  REQUIRE(folded.find("node 1 11\n") != std::string::npos);
+}
@@ -0,0 +1,166 @@
+#include <catch2/catch.hpp>
+#include <bt/batch_condition.hpp>
+#include <bt/guard_program.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kAgents = 300;
+
+struct Crowd {
+  bt::FlagColumn<kAgents> alive;
+  bt::FlagColumn<kAgents> armed;
+  bt::FlagColumn<kAgents> hidden;
+  bt::FlagColumn<kAgents> panicked;
+};
+
+using CrowdCtx = bt::AgentContext<Crowd>;
+
+void Seed(Crowd& c) {
+  uint32_t x = 12345U;
+  for (uint32_t i = 0; i < kAgents; ++i) {
+    x = x * 1103515245U + 12345U;
+    c.alive.Set(i, ((x >> 16) & 1U) != 0U);
+    c.armed.Set(i, ((x >> 17) & 1U) != 0U);
+    c.hidden.Set(i, ((x >> 18) & 1U) != 0U);
+    c.panicked.Set(i, ((x >> 19) & 3U) == 0U);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("GuardProgram matches per-agent ticking", "[guard]") {
+  Crowd crowd;
+  Seed(crowd);
+
+  /*
+   * Selector
+   * +-- Sequence
+   * |   +-- Alive
+   * |   +-- Armed
+   * |   +-- Inverter
+   * |       +-- Hidden
+   * +-- Panicked
+   */
+  bt::Node<CrowdCtx> alive("Alive"), armed("Armed"), hidden("Hidden"),
+      panicked("Panicked"), not_hidden("NotHidden"), seq("Seq"), sel("Sel");
+  bt::factory::MakeCondition(alive,
+                             bt::MaskCondition<Crowd, kAgents, &Crowd::alive>);
+  bt::factory::MakeCondition(armed,
+                             bt::MaskCondition<Crowd, kAgents, &Crowd::armed>);
+  bt::factory::MakeCondition(
+      hidden, bt::MaskCondition<Crowd, kAgents, &Crowd::hidden>);
+  bt::factory::MakeCondition(
+      panicked, bt::MaskCondition<Crowd, kAgents, &Crowd::panicked>);
+  bt::factory::MakeInverter(not_hidden, hidden);
+  seq.set_type(bt::NodeType::kSequence)
+      .AddChild(alive)
+      .AddChild(armed)
+      .AddChild(not_hidden);
+  sel.set_type(bt::NodeType::kSelector).AddChild(seq).AddChild(panicked);
+
+  const bt::FlagBinding flags[] = {{"Alive", crowd.alive.words()},
+                                   {"Armed", crowd.armed.words()},
+                                   {"Hidden", crowd.hidden.words()},
+                                   {"Panicked", crowd.panicked.words()}};
+  bt::GuardProgram<CrowdCtx> program;
+  REQUIRE(program.Compile(sel, flags, 4) == bt::GuardError::kNone);
+  REQUIRE(program.size() == 7U);  // one instruction per node
+
+  bt::LaneMask<kAgents> batch;
+  const uint32_t passed = program.Evaluate(kAgents, batch);
+
+  bt::LaneMask<kAgents> reference;
+  REQUIRE(bt::TickBatch(sel, crowd, kAgents, reference) == passed);
+  for (uint32_t w = 0; w < bt::LaneWords(kAgents); ++w) {
+    REQUIRE(batch.words()[w] == reference.words()[w]);
+  }
+}
+
+TEST_CASE("GuardProgram parallel policies and empty composites", "[guard]") {
+  Crowd crowd;
+  Seed(crowd);
+  const bt::FlagBinding flags[] = {{"Alive", crowd.alive.words()},
+                                   {"Armed", crowd.armed.words()}};
+
+  bt::Node<CrowdCtx> alive("Alive"), armed("Armed"), all("All"), one("One");
+  alive.set_type(bt::NodeType::kCondition);
+  armed.set_type(bt::NodeType::kCondition);
+  all.set_type(bt::NodeType::kParallel).AddChild(alive).AddChild(armed);
+
+  bt::GuardProgram<CrowdCtx> program;
+  REQUIRE(program.Compile(all, flags, 2) == bt::GuardError::kNone);
+  REQUIRE(program.EvaluateWord(1) ==
+          (crowd.alive.words()[1] & crowd.armed.words()[1]));
+
+  one.set_type(bt::NodeType::kParallel)
+      .set_parallel_policy(bt::ParallelPolicy::kRequireOne)
+      .AddChild(alive)
+      .AddChild(armed);
+  REQUIRE(program.Compile(one, flags, 2) == bt::GuardError::kNone);
+  REQUIRE(program.EvaluateWord(2) ==
+          (crowd.alive.words()[2] | crowd.armed.words()[2]));
+
+  bt::Node<CrowdCtx> empty_seq("EmptySeq"), empty_sel("EmptySel");
+  empty_seq.set_type(bt::NodeType::kSequence);
+  empty_sel.set_type(bt::NodeType::kSelector);
+  REQUIRE(program.Compile(empty_seq, flags, 2) == bt::GuardError::kNone);
+  REQUIRE(program.EvaluateWord(0) == ~static_cast<uint64_t>(0));
+  REQUIRE(program.Compile(empty_sel, flags, 2) == bt::GuardError::kNone);
+  REQUIRE(program.EvaluateWord(0) == 0U);
+}
+
+TEST_CASE("GuardProgram rejects non-guard subtrees", "[guard]") {
+  Crowd crowd;
+  const bt::FlagBinding flags[] = {{"Alive", crowd.alive.words()}};
+  bt::GuardProgram<CrowdCtx> program;
+
+  bt::Node<CrowdCtx> alive("Alive"), unknown("Unknown"), act("Act"),
+      seq("Seq");
+  alive.set_type(bt::NodeType::kCondition);
+  unknown.set_type(bt::NodeType::kCondition);
+  act.set_type(bt::NodeType::kAction);
+
+  seq.set_type(bt::NodeType::kSequence).AddChild(alive).AddChild(unknown);
+  REQUIRE(program.Compile(seq, flags, 1) ==
+          bt::GuardError::kUnboundCondition);
+  REQUIRE(program.empty());
+
+  seq.SetChild(act);
+  REQUIRE(program.Compile(seq, flags, 1) == bt::GuardError::kUnsupportedNode);
+
+  seq.SetChild(alive);
+  seq.set_on_enter([](CrowdCtx&) {});
+  REQUIRE(program.Compile(seq, flags, 1) == bt::GuardError::kUnsupportedNode);
+}
+
+TEST_CASE("GuardProgram gates per-agent ticking", "[guard]") {
+  Crowd crowd;
+  Seed(crowd);
+  const bt::FlagBinding flags[] = {{"Alive", crowd.alive.words()}};
+
+  bt::Node<CrowdCtx> alive("Alive");
+  alive.set_type(bt::NodeType::kCondition);
+  bt::GuardProgram<CrowdCtx> program;
+  REQUIRE(program.Compile(alive, flags, 1) == bt::GuardError::kNone);
+
+  bt::LaneMask<kAgents> lanes;
+  const uint32_t n = program.Evaluate(kAgents, lanes);
+
+  std::vector<uint32_t> ticked;
+  bt::ForEachLane(lanes, kAgents,
+                  [&ticked](uint32_t a) { ticked.push_back(a); });
+  REQUIRE(ticked.size() == n);
+  for (uint32_t a : ticked) {
+    REQUIRE(crowd.alive.Test(a));
+  }
+}
+
+TEST_CASE("GuardErrorToString", "[guard]") {
+  REQUIRE(std::string(bt::GuardErrorToString(bt::GuardError::kNone)) ==
+          "NONE");
+  REQUIRE(std::string(bt::GuardErrorToString(
+              bt::GuardError::kUnboundCondition)) == "UNBOUND_CONDITION");
+}
@@ -0,0 +1,268 @@
+#include <catch2/catch.hpp>
+#include <bt/hot_reload.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+struct ReloadCtx {
+  int enters = 0;
+  int exits = 0;
+  int ticks = 0;
+  bool finish = false;
+};
+
+bt::Status Busy(ReloadCtx& ctx) {
+  ++ctx.ticks;
+  return ctx.finish ? bt::Status::kSuccess : bt::Status::kRunning;
+}
+
+bt::Status Ok(ReloadCtx& /*ctx*/) { return bt::Status::kSuccess; }
+
+void Enter(ReloadCtx& ctx) { ++ctx.enters; }
+void Exit(ReloadCtx& ctx) { ++ctx.exits; }
+
+#if (BT_NODE_STATE_SIZE > 0)
+bt::Status CountTo5(ReloadCtx& ctx, bt::NodeState& state) {
+  ++ctx.ticks;
+  int& n = state.as<int>();
+  return (++n < 5) ? bt::Status::kRunning : bt::Status::kSuccess;
+}
+#endif
+
+/** Sequence "Root" -> [Check, Work (running, enter/exit)] */
+struct Version {
+  bt::Node<ReloadCtx> root{"Root"}, check{"Check"}, work{"Work"};
+
+  Version() {
+    root.set_type(bt::NodeType::kSequence);
+    bt::factory::MakeCondition(check, Ok);
+    bt::factory::MakeAction(work, Busy).set_on_enter(Enter).set_on_exit(Exit);
+    root.AddChild(check).AddChild(work);
+  }
+};
+
+}  // namespace
+
+TEST_CASE("ReloadableTree swaps at the next tick boundary", "[reload]") {
+  ReloadCtx ctx;
+  Version v1, v2;
+  bt::ReloadableTree<ReloadCtx> tree(v1.root, ctx);
+
+  REQUIRE(tree.Tick() == bt::Status::kRunning);
+  REQUIRE(tree.Publish(v2.root) == bt::ReloadError::kNone);
+  REQUIRE(tree.has_pending());
+  REQUIRE(&tree.root() == &v1.root);  // not yet swapped
+  REQUIRE(tree.TakeRetired() == nullptr);
+
+  REQUIRE(tree.Tick() == bt::Status::kRunning);
+  REQUIRE(&tree.root() == &v2.root);
+  REQUIRE(tree.reload_count() == 1U);
+  REQUIRE_FALSE(tree.has_pending());
+  REQUIRE(tree.TakeRetired() == &v1.root);
+  REQUIRE(tree.TakeRetired() == nullptr);
+}
+
+TEST_CASE("ReloadPolicy::kHalt exits running nodes", "[reload]") {
+  ReloadCtx ctx;
+  Version v1, v2;
+  bt::ReloadableTree<ReloadCtx> tree(v1.root, ctx, bt::ReloadPolicy::kHalt);
+
+  tree.Tick();
+  tree.Tick();
+  REQUIRE(ctx.enters == 1);
+  REQUIRE(ctx.exits == 0);
+
+  REQUIRE(tree.Publish(v2.root) == bt::ReloadError::kNone);
+  tree.Tick();
+  // Old Work halted (exit), new Work entered fresh
+  REQUIRE(ctx.exits == 1);
+  REQUIRE(ctx.enters == 2);
+  REQUIRE(v1.root.status() == bt::Status::kFailure);
+  REQUIRE(v2.work.is_running());
+}
+
+TEST_CASE("ReloadPolicy::kMapState carries running state over", "[reload]") {
+  ReloadCtx ctx;
+  Version v1, v2;
+  bt::ReloadableTree<ReloadCtx> tree(v1.root, ctx,
+                                     bt::ReloadPolicy::kMapState);
+
+  tree.Tick();
+  REQUIRE(tree.Publish(v2.root) == bt::ReloadError::kNone);
+  tree.Tick();
+  // Work continues: neither exited nor re-entered
+  REQUIRE(ctx.enters == 1);
+  REQUIRE(ctx.exits == 0);
+  REQUIRE(v2.root.is_running());
+  REQUIRE(v2.root.current_child_index() == 1U);
+
+  ctx.finish = true;
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  REQUIRE(ctx.exits == 1);
+}
+
+TEST_CASE("ReloadPolicy::kMapState halts nodes without a counterpart",
+          "[reload]") {
+  ReloadCtx ctx;
+  Version v1;
+  bt::ReloadableTree<ReloadCtx> tree(v1.root, ctx,
+                                     bt::ReloadPolicy::kMapState);
+  tree.Tick();
+
+  // Work renamed: no match, so the old one is exited and the new one entered
+  bt::Node<ReloadCtx> root("Root"), check("Check"), work("Work2");
+  root.set_type(bt::NodeType::kSequence);
+  bt::factory::MakeCondition(check, Ok);
+  bt::factory::MakeAction(work, Busy).set_on_enter(Enter).set_on_exit(Exit);
+  root.AddChild(check).AddChild(work);
+
+  REQUIRE(tree.Publish(root) == bt::ReloadError::kNone);
+  tree.Tick();
+  REQUIRE(ctx.exits == 1);
+  REQUIRE(ctx.enters == 2);
+  // The old tree is halted and left idle, matched or not
+  REQUIRE_FALSE(v1.work.is_running());
+  REQUIRE_FALSE(v1.root.is_running());
+  REQUIRE(v1.root.current_child_index() == 0U);
+}
+
+TEST_CASE("ReloadPolicy::kMapState exits an unmatched parent only",
+          "[reload]") {
+  ReloadCtx ctx;
+  // Old: Root -> Group(Seq) -> Work; new: Root -> Other(Seq) -> Work
+  bt::Node<ReloadCtx> a_root("Root"), a_group("Group"), a_work("Work");
+  a_group.set_type(bt::NodeType::kSequence).set_on_exit(Exit);
+  bt::factory::MakeAction(a_work, Busy).set_on_enter(Enter).set_on_exit(Exit);
+  a_group.AddChild(a_work);
+  a_root.set_type(bt::NodeType::kSequence).AddChild(a_group);
+
+  bt::Node<ReloadCtx> b_root("Root"), b_other("Other"), b_work("Work");
+  b_other.set_type(bt::NodeType::kSequence);
+  bt::factory::MakeAction(b_work, Busy).set_on_enter(Enter).set_on_exit(Exit);
+  b_other.AddChild(b_work);
+  b_root.set_type(bt::NodeType::kSequence).AddChild(b_other);
+
+  bt::ReloadableTree<ReloadCtx> tree(a_root, ctx,
+                                     bt::ReloadPolicy::kMapState);
+  tree.Tick();
+  REQUIRE(tree.Publish(b_root) == bt::ReloadError::kNone);
+  tree.Tick();
+  // Group exits; Work moved to the new tree and is neither exited nor
+  // re-entered
+  REQUIRE(ctx.exits == 1);
+  REQUIRE(ctx.enters == 1);
+  REQUIRE_FALSE(a_group.is_running());
+  REQUIRE_FALSE(a_work.is_running());
+  REQUIRE(b_work.is_running());
+}
+
+TEST_CASE("ReloadPolicy::kMapState falls back to kHalt for big trees",
+          "[reload]") {
+  ReloadCtx ctx;
+  Version v1;
+  bt::ReloadableTree<ReloadCtx, 4U> tree(v1.root, ctx,
+                                         bt::ReloadPolicy::kMapState);
+  tree.Tick();
+
+  // Five nodes: more than kMaxNodes, although the old tree fits
+  bt::Node<ReloadCtx> root("Root"), check("Check"), work("Work"), c2("C2"),
+      c3("C3");
+  root.set_type(bt::NodeType::kSequence);
+  bt::factory::MakeCondition(check, Ok);
+  bt::factory::MakeCondition(c2, Ok);
+  bt::factory::MakeCondition(c3, Ok);
+  bt::factory::MakeAction(work, Busy).set_on_enter(Enter).set_on_exit(Exit);
+  root.AddChild(check).AddChild(c2).AddChild(c3).AddChild(work);
+
+  REQUIRE(tree.Publish(root) == bt::ReloadError::kNone);
+  tree.Tick();
+  REQUIRE(ctx.exits == 1);   // old Work halted
+  REQUIRE(ctx.enters == 2);  // new Work entered fresh
+  REQUIRE(work.is_running());
+}
+
+#if (BT_NODE_STATE_SIZE > 0)
+TEST_CASE("ReloadPolicy::kMapState carries NodeState", "[reload]") {
+  ReloadCtx ctx;
+  bt::Node<ReloadCtx> a_root("Root"), a_count("Count");
+  a_root.set_type(bt::NodeType::kSequence).AddChild(a_count);
+  bt::factory::MakeStatefulAction(a_count, CountTo5);
+
+  // New version inserts a condition before Count
+  bt::Node<ReloadCtx> b_root("Root"), b_check("Check"), b_count("Count");
+  bt::factory::MakeCondition(b_check, Ok);
+  bt::factory::MakeStatefulAction(b_count, CountTo5);
+  b_root.set_type(bt::NodeType::kSequence).AddChild(b_check).AddChild(b_count);
+
+  bt::ReloadableTree<ReloadCtx> tree(a_root, ctx,
+                                     bt::ReloadPolicy::kMapState);
+  tree.Tick();
+  tree.Tick();
+  REQUIRE(a_count.state().as<int>() == 2);
+
+  REQUIRE(tree.Publish(b_root) == bt::ReloadError::kNone);
+  // Root's child count changed, so Root restarts; Count keeps its counter
+  REQUIRE(tree.Tick() == bt::Status::kRunning);
+  REQUIRE(b_count.state().as<int>() == 3);
+  tree.Tick();
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  REQUIRE(ctx.ticks == 5);
+}
+#endif
+
+TEST_CASE("ReloadableTree::Publish rejects invalid and overlapping publishes",
+          "[reload]") {
+  ReloadCtx ctx;
+  Version v1, v2, v3;
+  bt::ReloadableTree<ReloadCtx> tree(v1.root, ctx);
+
+  bt::Node<ReloadCtx> broken("Broken");
+  broken.set_type(bt::NodeType::kAction);  // no tick
+  REQUIRE(tree.Publish(broken) == bt::ReloadError::kInvalidTree);
+
+  REQUIRE(tree.Publish(v2.root) == bt::ReloadError::kNone);
+  REQUIRE(tree.Publish(v3.root) == bt::ReloadError::kBusy);  // pending
+  tree.Tick();
+  REQUIRE(tree.Publish(v3.root) == bt::ReloadError::kBusy);  // not retired
+  REQUIRE(tree.TakeRetired() == &v1.root);
+  REQUIRE(tree.Publish(v3.root) == bt::ReloadError::kNone);
+}
+
+TEST_CASE("ReloadableTree reloads from a builder thread while ticking",
+          "[reload]") {
+  ReloadCtx ctx;
+  Version versions[2];
+  bt::ReloadableTree<ReloadCtx> tree(versions[0].root, ctx,
+                                     bt::ReloadPolicy::kMapState);
+  constexpr uint32_t kReloads = 200;
+  std::atomic<bool> done{false};
+
+  std::thread builder([&] {
+    uint32_t next = 1;
+    for (uint32_t i = 0; i < kReloads; ++i) {
+      // The idle version was retired, so it may be rebuilt in place
+      while (tree.Publish(versions[next].root) != bt::ReloadError::kNone) {
+        std::this_thread::yield();
+      }
+      while (tree.TakeRetired() == nullptr) {
+        std::this_thread::yield();
+      }
+      next ^= 1U;
+    }
+    done.store(true);
+  });
+
+  uint32_t unexpected = 0;
+  while (!done.load()) {
+    if (tree.Tick() != bt::Status::kRunning) {
+      ++unexpected;
+    }
+  }
+  builder.join();
+  REQUIRE(unexpected == 0U);
+  REQUIRE(tree.reload_count() == kReloads);
+  REQUIRE(ctx.enters == 1);  // state mapped across every reload
+  REQUIRE(ctx.exits == 0);
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+#include <bt/behavior_tree.hpp>
+
+#include <type_traits>
+
+struct InplaceCtx {
+  int value = 0;
+};
+
+using TickFn = bt::InplaceFunction<bt::Status(InplaceCtx&)>;
+using VoidFn = bt::InplaceFunction<void(InplaceCtx&)>;
+
+static bt::Status FreeTick(InplaceCtx& ctx) {
+  ctx.value += 10;
+  return bt::Status::kSuccess;
+}
+
+TEST_CASE("InplaceFunction default is empty", "[inplace]") {
+  TickFn fn;
+  REQUIRE(fn == nullptr);
+  REQUIRE(!fn);
+
+  TickFn null_fn(nullptr);
+  REQUIRE(null_fn == nullptr);
+}
+
+TEST_CASE("InplaceFunction wraps function pointer", "[inplace]") {
+  TickFn fn(FreeTick);
+  REQUIRE(fn != nullptr);
+
+  InplaceCtx ctx;
+  REQUIRE(fn(ctx) == bt::Status::kSuccess);
+  REQUIRE(ctx.value == 10);
+}
+
+TEST_CASE("InplaceFunction null function pointer is empty", "[inplace]") {
+  bt::Status (*raw)(InplaceCtx&) = nullptr;
+  TickFn fn(raw);
+  REQUIRE(fn == nullptr);
+}
+
+TEST_CASE("InplaceFunction stores captures inline", "[inplace]") {
+  int calls = 0;
+  const int step = 3;
+  VoidFn fn([&calls, step](InplaceCtx& c) {
+    ++calls;
+    c.value += step;
+  });
+
+  InplaceCtx ctx;
+  fn(ctx);
+  fn(ctx);
+  REQUIRE(calls == 2);
+  REQUIRE(ctx.value == 6);
+}
+
+TEST_CASE("InplaceFunction mutable lambda keeps its state", "[inplace]") {
+  VoidFn fn([n = 0](InplaceCtx& c) mutable { c.value = ++n; });
+
+  InplaceCtx ctx;
+  fn(ctx);
+  fn(ctx);
+  REQUIRE(ctx.value == 2);
+}
+
+TEST_CASE("InplaceFunction copy is independent", "[inplace]") {
+  VoidFn a([n = 0](InplaceCtx& c) mutable { c.value = ++n; });
+  InplaceCtx ctx;
+  a(ctx);
+
+  VoidFn b = a;
+  b(ctx);
+  REQUIRE(ctx.value == 2);
+  a(ctx);
+  REQUIRE(ctx.value == 2);  // a continues from its own copy
+
+  b = nullptr;
+  REQUIRE(b == nullptr);
+  REQUIRE(a != nullptr);
+}
+
+TEST_CASE("InplaceFunction is trivially copyable", "[inplace]") {
+  REQUIRE(std::is_trivially_copyable<TickFn>::value);
+  REQUIRE(std::is_trivially_destructible<TickFn>::value);
+  REQUIRE(TickFn::kCapacity ==
+          static_cast<size_t>(BT_INPLACE_FUNCTION_SIZE));
+}
+
+TEST_CASE("InplaceFunction custom capacity", "[inplace]") {
+  struct Big {
+    int64_t a, b, c, d, e;
+  };
+  Big big{1, 2, 3, 4, 5};
+  bt::InplaceFunction<int64_t(), 48> fn([big]() {
+    return big.a + big.b + big.c + big.d + big.e;
+  });
+  REQUIRE(fn() == 15);
+}
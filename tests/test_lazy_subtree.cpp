@@ -0,0 +1,283 @@
+#include <catch2/catch.hpp>
+#include <bt/lazy_subtree.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct LazyCtx {
+  bool primary_ok = true;
+  int steps = 0;
+  int built = 0;
+};
+
+using NodeT = bt::Node<LazyCtx>;
+using ArenaT = bt::NodeArena<LazyCtx>;
+
+bt::Status Primary(LazyCtx& ctx) {
+  return ctx.primary_ok ? bt::Status::kSuccess : bt::Status::kFailure;
+}
+
+/* Succeeds on the third tick of each run. */
+bt::Status Step(LazyCtx& ctx) {
+  ++ctx.steps;
+  return ((ctx.steps % 3) == 0) ? bt::Status::kSuccess : bt::Status::kRunning;
+}
+
+bt::Status Ok(LazyCtx& /*ctx*/) { return bt::Status::kSuccess; }
+
+/* Descriptor: number of Step actions in a sequence. */
+NodeT* BuildSteps(ArenaT& arena, const void* descriptor) {
+  const int count = *static_cast<const int*>(descriptor);
+  NodeT* root = arena.Create("Steps");
+  if (root == nullptr) {
+    return nullptr;
+  }
+  root->set_type(bt::NodeType::kSequence);
+  for (int i = 0; i < count; ++i) {
+    NodeT* step = arena.Create("Step");
+    if (step == nullptr) {
+      return nullptr;
+    }
+    root->AddChild(bt::factory::MakeAction(*step, Step));
+  }
+  return root;
+}
+
+/* Descriptor: length of a chain of single-child sequences. */
+NodeT* BuildChain(ArenaT& arena, const void* descriptor) {
+  const int length = *static_cast<const int*>(descriptor);
+  NodeT* root = arena.Create("Chain");
+  NodeT* tail = root;
+  for (int i = 1; (i < length) && (tail != nullptr); ++i) {
+    NodeT* next = arena.Create("Link");
+    if (next != nullptr) {
+      tail->set_type(bt::NodeType::kSequence).AddChild(*next);
+    }
+    tail = next;
+  }
+  if (tail == nullptr) {
+    return nullptr;
+  }
+  bt::factory::MakeAction(*tail, Step);
+  return root;
+}
+
+NodeT* BuildNothing(ArenaT& /*arena*/, const void* /*descriptor*/) {
+  return nullptr;
+}
+
+NodeT* BuildInvalid(ArenaT& arena, const void* /*descriptor*/) {
+  return arena.Create("NoTick");  // action without tick
+}
+
+struct Pool {
+  std::vector<unsigned char> buffer;
+  bt::SubtreePool<LazyCtx> pool;
+  Pool(uint32_t blocks, size_t block_bytes)
+      : buffer(blocks * block_bytes + 64U),
+        pool(buffer.data(), buffer.size(), block_bytes) {}
+};
+
+}  // namespace
+
+TEST_CASE("Lazy subtree is built on first entry only", "[lazy]") {
+  Pool p(4, 2048);
+  REQUIRE(p.pool.block_count() == 4U);
+  const int one = 1;
+  bt::LazySubtree<LazyCtx> backup(p.pool, BuildSteps, &one);
+
+  NodeT root("Root"), primary("Primary"), fallback("Fallback");
+  bt::factory::MakeCondition(primary, Primary);
+  backup.Attach(fallback);
+  root.set_type(bt::NodeType::kSelector).AddChild(primary).AddChild(fallback);
+  REQUIRE(root.ValidateTree() == bt::ValidateError::kNone);
+  REQUIRE(fallback.type() == bt::NodeType::kSubtree);
+
+  LazyCtx ctx;
+  bt::BehaviorTree<LazyCtx> tree(root, ctx);
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  REQUIRE_FALSE(backup.resident());
+  REQUIRE(p.pool.resident_count() == 0U);
+
+  ctx.primary_ok = false;
+  REQUIRE(tree.Tick() == bt::Status::kRunning);
+  REQUIRE(backup.resident());
+  REQUIRE(backup.root() != nullptr);
+  REQUIRE(backup.arena()->node_count() == 2U);
+  REQUIRE(fallback.children_count() == 1U);
+  REQUIRE(p.pool.resident_count() == 1U);
+  REQUIRE(tree.Tick() == bt::Status::kRunning);
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  REQUIRE(p.pool.instantiate_count() == 1U);
+  REQUIRE(std::string(bt::NodeTypeToString(fallback.type())) == "SUBTREE");
+}
+
+TEST_CASE("Idle subtrees are released by Sweep and rebuilt on re-entry",
+          "[lazy]") {
+  Pool p(2, 2048);
+  const int two = 2;
+  bt::LazySubtree<LazyCtx> lazy(p.pool, BuildSteps, &two);
+  NodeT node("Contingency");
+  lazy.Attach(node);
+  LazyCtx ctx;
+
+  // RUNNING subtrees are kept however long they run
+  REQUIRE(node.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(p.pool.Sweep(0) == 0U);
+  REQUIRE(node.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(node.Tick(ctx) == bt::Status::kRunning);  // second step starts
+  REQUIRE(lazy.Release() == false);
+  for (int i = 0; i < 2; ++i) {
+    REQUIRE(node.Tick(ctx) != bt::Status::kError);
+    REQUIRE(p.pool.Sweep(2) == 0U);
+  }
+  REQUIRE(node.status() == bt::Status::kSuccess);
+
+  // Finished: released after more than two ticks without entry
+  REQUIRE(p.pool.Sweep(2) == 0U);
+  REQUIRE(lazy.resident());
+  REQUIRE(p.pool.Sweep(2) == 1U);
+  REQUIRE_FALSE(lazy.resident());
+  REQUIRE(node.children_count() == 0U);
+  REQUIRE(p.pool.free_blocks() == 2U);
+  REQUIRE(p.pool.release_count() == 1U);
+
+  // Re-entry rebuilds a fresh instance
+  REQUIRE(node.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(lazy.resident());
+  REQUIRE(p.pool.instantiate_count() == 2U);
+  REQUIRE(lazy.Release() == false);
+  node.Reset();
+  REQUIRE(lazy.Release());
+  REQUIRE(p.pool.resident_count() == 0U);
+}
+
+TEST_CASE("Lazy subtree failures surface as ERROR", "[lazy]") {
+  Pool p(1, 2048);
+  const int one = 1;
+  const int many = 100;  // does not fit in a block
+  bt::LazySubtree<LazyCtx> a(p.pool, BuildSteps, &one);
+  bt::LazySubtree<LazyCtx> b(p.pool, BuildSteps, &one);
+  bt::LazySubtree<LazyCtx> big(p.pool, BuildChain, &many);
+  bt::LazySubtree<LazyCtx> none(p.pool, BuildNothing);
+  bt::LazySubtree<LazyCtx> invalid(p.pool, BuildInvalid);
+  NodeT na, nb, nbig, nnone, ninvalid;
+  a.Attach(na);
+  b.Attach(nb);
+  big.Attach(nbig);
+  none.Attach(nnone);
+  invalid.Attach(ninvalid);
+  LazyCtx ctx;
+
+  REQUIRE(na.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(nb.Tick(ctx) == bt::Status::kError);  // pool exhausted
+  REQUIRE(p.pool.failure_count() == 1U);
+  REQUIRE(a.Release() == false);
+  na.Reset();
+  REQUIRE(a.Release());
+
+  REQUIRE(nbig.Tick(ctx) == bt::Status::kError);
+  REQUIRE(nnone.Tick(ctx) == bt::Status::kError);
+  REQUIRE(ninvalid.Tick(ctx) == bt::Status::kError);
+  REQUIRE(p.pool.failure_count() == 4U);
+  REQUIRE(p.pool.free_blocks() == 1U);  // failed builds give the block back
+  REQUIRE(nb.Tick(ctx) == bt::Status::kRunning);
+
+  NodeT orphan("Orphan");
+  orphan.set_type(bt::NodeType::kSubtree);
+  REQUIRE(orphan.Validate() == bt::ValidateError::kInvalidSubtree);
+  REQUIRE(orphan.Tick(ctx) == bt::Status::kError);
+  REQUIRE(std::string(bt::ValidateErrorToString(
+              bt::ValidateError::kInvalidSubtree)) == "INVALID_SUBTREE");
+
+  unsigned char small[256];
+  bt::SubtreePool<LazyCtx> tiny(small, sizeof(small), 8);
+  REQUIRE(tiny.block_count() == 0U);
+}
+
+namespace {
+
+/* Descriptor of an outer subtree holding an inner lazy one. */
+struct Nested {
+  bt::LazySubtree<LazyCtx>* inner;
+};
+
+NodeT* BuildOuter(ArenaT& arena, const void* descriptor) {
+  const Nested& nested = *static_cast<const Nested*>(descriptor);
+  NodeT* root = arena.Create("Outer");
+  NodeT* guard = arena.Create("Guard");
+  NodeT* slot = arena.Create("InnerSlot");
+  if ((root == nullptr) || (guard == nullptr) || (slot == nullptr)) {
+    return nullptr;
+  }
+  bt::factory::MakeCondition(*guard, Ok);
+  nested.inner->Attach(*slot);
+  root->set_type(bt::NodeType::kSequence).AddChild(*guard).AddChild(*slot);
+  return root;
+}
+
+}  // namespace
+
+TEST_CASE("Releasing an outer subtree releases nested ones", "[lazy]") {
+  Pool p(3, 2048);
+  const int one = 1;
+  bt::LazySubtree<LazyCtx> inner(p.pool, BuildSteps, &one);
+  Nested nested{&inner};
+  bt::LazySubtree<LazyCtx> outer(p.pool, BuildOuter, &nested);
+  NodeT node("Outer");
+  outer.Attach(node);
+  LazyCtx ctx;
+
+  REQUIRE(node.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(p.pool.resident_count() == 2U);
+  REQUIRE(node.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(node.Tick(ctx) == bt::Status::kSuccess);
+
+  REQUIRE(p.pool.Sweep(0) == 2U);
+  REQUIRE(p.pool.resident_count() == 0U);
+
+  REQUIRE(node.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(p.pool.resident_count() == 2U);
+  node.Halt(ctx);
+  REQUIRE(outer.Release());
+  REQUIRE_FALSE(inner.resident());
+  REQUIRE(p.pool.free_blocks() == 3U);
+  REQUIRE(p.pool.release_count() == 4U);
+}
+
+TEST_CASE("Resident memory follows the active contingencies", "[lazy]") {
+  constexpr uint32_t kContingencies = 200;
+  Pool p(4, 2048);
+  const int one = 1;
+  std::vector<std::unique_ptr<bt::LazySubtree<LazyCtx>>> lazies;
+  std::unique_ptr<NodeT[]> nodes(new NodeT[kContingencies]);
+  for (uint32_t i = 0; i < kContingencies; ++i) {
+    lazies.emplace_back(
+        new bt::LazySubtree<LazyCtx>(p.pool, BuildSteps, &one));
+    lazies.back()->Attach(nodes[i]);
+  }
+  LazyCtx ctx;
+
+  // Only a few contingencies are ever entered at once
+  uint32_t peak = 0;
+  for (uint32_t round = 0; round < 10; ++round) {
+    for (uint32_t k = 0; k < 3; ++k) {
+      NodeT& active = nodes[(round * 37U + k * 11U) % kContingencies];
+      do {
+        active.Tick(ctx);
+        peak = std::max(peak, p.pool.resident_count());
+      } while (active.status() == bt::Status::kRunning);
+      REQUIRE(active.status() == bt::Status::kSuccess);
+    }
+    p.pool.Sweep(0);
+  }
+  REQUIRE(peak <= 3U);
+  REQUIRE(p.pool.resident_count() == 0U);
+  REQUIRE(p.pool.instantiate_count() == 30U);
+  REQUIRE(p.pool.failure_count() == 0U);
+  lazies.clear();
+}
@@ -0,0 +1,295 @@
+#include <catch2/catch.hpp>
+#include <bt/xml_loader.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct LoadCtx {
+  int ready = 1;
+  int steps = 0;
+  int enters = 0;
+  int exits = 0;
+};
+
+bt::Status IsReady(LoadCtx& ctx) {
+  return (ctx.ready != 0) ? bt::Status::kSuccess : bt::Status::kFailure;
+}
+
+bt::Status Step(LoadCtx& ctx) {
+  ++ctx.steps;
+  return bt::Status::kSuccess;
+}
+
+bt::Status Fail(LoadCtx& /*ctx*/) { return bt::Status::kFailure; }
+
+void OnEnter(LoadCtx& ctx) { ++ctx.enters; }
+void OnExit(LoadCtx& ctx) { ++ctx.exits; }
+
+using Registry = bt::Registry<LoadCtx>;
+using Arena = bt::NodeArena<LoadCtx>;
+
+void RegisterAll(Registry& reg) {
+  REQUIRE(reg.RegisterTick("IsReady", IsReady));
+  REQUIRE(reg.RegisterTick("Step", Step));
+  REQUIRE(reg.RegisterTick("Fail", Fail));
+  REQUIRE(reg.RegisterCallback("OnEnter", OnEnter));
+  REQUIRE(reg.RegisterCallback("OnExit", OnExit));
+}
+
+bt::LoadResult<LoadCtx> Load(const std::string& xml, const Registry& reg,
+                             Arena& arena) {
+  return bt::LoadXml(xml.data(), xml.size(), reg, arena);
+}
+
+}  // namespace
+
+// ============================================================================
+// Registry
+// ============================================================================
+
+TEST_CASE("Registry resolves names and assigns dense IDs", "[loader]") {
+  Registry reg;
+  RegisterAll(reg);
+  REQUIRE(reg.size() == 5U);
+
+  const Registry::Entry* e = reg.Find("Step");
+  REQUIRE(e != nullptr);
+  REQUIRE(e->kind == Registry::Kind::kTick);
+  REQUIRE(e->id == 1U);
+  REQUIRE(reg.FindById(1U) == e);
+  REQUIRE(reg.FindById(5U) == nullptr);
+
+  // Length-delimited lookup must not match prefixes
+  REQUIRE(reg.Find("StepX", 4U) == e);
+  REQUIRE(reg.Find("Ste", 3U) == nullptr);
+  REQUIRE(reg.Find("Missing") == nullptr);
+
+  REQUIRE(reg.Find("OnExit")->kind == Registry::Kind::kCallback);
+  REQUIRE_FALSE(reg.RegisterTick("Step", Fail));  // duplicate
+}
+
+TEST_CASE("Registry rejects inserts when full", "[loader]") {
+  bt::Registry<LoadCtx, 4> reg;
+  REQUIRE(reg.RegisterTick("A", Step));
+  REQUIRE(reg.RegisterTick("B", Step));
+  REQUIRE(reg.RegisterTick("C", Step));
+  REQUIRE(reg.RegisterTick("D", Step));
+  REQUIRE_FALSE(reg.RegisterTick("E", Step));
+  REQUIRE(reg.Find("D") != nullptr);
+  REQUIRE(reg.Find("E") == nullptr);
+}
+
+TEST_CASE("HashName is usable at compile time", "[loader]") {
+  static_assert(bt::HashName("", 0) == 2166136261U, "FNV offset basis");
+  constexpr uint32_t h = bt::HashName("Step", 4);
+  REQUIRE(h == bt::HashName("Step", bt::NameLength("Step")));
+}
+
+// ============================================================================
+// NodeArena
+// ============================================================================
+
+TEST_CASE("NodeArena places nodes contiguously and pools strings",
+          "[loader]") {
+  alignas(64) static unsigned char buffer[4096];
+  Arena arena(buffer, sizeof(buffer));
+
+  bt::Node<LoadCtx>* a = arena.Create("A");
+  bt::Node<LoadCtx>* b = arena.Create("B");
+  REQUIRE(a != nullptr);
+  REQUIRE(b == a + 1);
+  REQUIRE(&arena.node(1) == b);
+  REQUIRE(arena.node_count() == 2U);
+
+  const char* name = arena.StoreString("Hello world", 5);
+  REQUIRE(std::strcmp(name, "Hello") == 0);
+
+  const size_t before = arena.free_bytes();
+  arena.Clear();
+  REQUIRE(arena.node_count() == 0U);
+  REQUIRE(arena.free_bytes() > before);
+}
+
+TEST_CASE("NodeArena returns nullptr when exhausted", "[loader]") {
+  alignas(64) static unsigned char buffer[sizeof(bt::Node<LoadCtx>) * 2];
+  Arena arena(buffer, sizeof(buffer));
+  REQUIRE(arena.Create() != nullptr);
+  REQUIRE(arena.Create() != nullptr);
+  REQUIRE(arena.Create() == nullptr);
+  REQUIRE(arena.StoreString("x", 1) == nullptr);
+}
+
+// ============================================================================
+// XML loader
+// ============================================================================
+
+TEST_CASE("LoadXml builds a tickable tree", "[loader]") {
+  Registry reg;
+  RegisterAll(reg);
+  static unsigned char buffer[16384];
+  Arena arena(buffer, sizeof(buffer));
+
+  const std::string xml = R"(<?xml version="1.0"?>
+<!-- mission -->
+<BehaviorTree>
+  <Sequence name="Root" on_enter="OnEnter" on_exit="OnExit">
+    <Condition tick="IsReady"/>
+    <Parallel name="Work" policy="RequireOne">
+      <Action name="Step1" tick="Step"/>
+      <Action tick='Step'></Action>
+    </Parallel>
+    <Inverter>
+      <Condition tick="Fail"/>
+    </Inverter>
+  </Sequence>
+</BehaviorTree>
+)";
+  const bt::LoadResult<LoadCtx> r = Load(xml, reg, arena);
+  REQUIRE(r.error == bt::LoadError::kNone);
+  REQUIRE(r.node_count == 7U);
+  REQUIRE(r.root == &arena.node(0));  // pre-order placement
+  REQUIRE(r.root->ValidateTree() == bt::ValidateError::kNone);
+
+  REQUIRE(std::strcmp(r.root->name(), "Root") == 0);
+  REQUIRE(std::strcmp(arena.node(1).name(), "IsReady") == 0);
+  REQUIRE(arena.node(2).parallel_policy() == bt::ParallelPolicy::kRequireOne);
+  REQUIRE(std::strcmp(arena.node(3).name(), "Step1") == 0);
+  REQUIRE(arena.node(5).type() == bt::NodeType::kInverter);
+
+  LoadCtx ctx;
+  bt::BehaviorTree<LoadCtx> tree(*r.root, ctx);
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  REQUIRE(ctx.steps == 2);
+  REQUIRE(ctx.enters == 1);
+  REQUIRE(ctx.exits == 1);
+
+  ctx.ready = 0;
+  REQUIRE(tree.Tick() == bt::Status::kFailure);
+}
+
+TEST_CASE("LoadXml reports errors with their line", "[loader]") {
+  Registry reg;
+  RegisterAll(reg);
+  static unsigned char buffer[16384];
+  Arena arena(buffer, sizeof(buffer));
+
+  struct Case {
+    const char* xml;
+    bt::LoadError error;
+    uint32_t line;
+  };
+  const Case cases[] = {
+      {"<Sequence>\n  <Action tick=\"Nope\"/>\n</Sequence>",
+       bt::LoadError::kUnknownFunction, 2},
+      {"<Sequence>\n</Selector>", bt::LoadError::kMismatchedTag, 2},
+      {"<Sequence>\n  <Loop/>\n</Sequence>", bt::LoadError::kUnknownElement,
+       2},
+      {"<Action name=\"x\"/>", bt::LoadError::kMissingTick, 1},
+      {"<Action tick=\"OnEnter\"/>", bt::LoadError::kWrongFunctionKind, 1},
+      {"<Sequence on_exit=\"Step\"/>", bt::LoadError::kWrongFunctionKind, 1},
+      {"<Parallel policy=\"Any\"/>", bt::LoadError::kInvalidPolicy, 1},
+      {"<Sequence color=\"red\"/>", bt::LoadError::kUnknownAttribute, 1},
+      {"<Sequence>\n\n<Inverter>\n</Inverter></Sequence>",
+       bt::LoadError::kInvalidNode, 4},
+      {"<Action tick=\"Step\"><Action tick=\"Step\"/></Action>",
+       bt::LoadError::kSyntax, 1},
+      {"<Sequence/><Sequence/>", bt::LoadError::kMultipleRoots, 1},
+      {"<Sequence>", bt::LoadError::kSyntax, 1},
+      {"<Sequence>text</Sequence>", bt::LoadError::kSyntax, 1},
+      {"<!-- nothing -->", bt::LoadError::kNoRoot, 1},
+  };
+  for (const Case& c : cases) {
+    arena.Clear();
+    const bt::LoadResult<LoadCtx> r = Load(c.xml, reg, arena);
+    INFO(c.xml);
+    REQUIRE(r.error == c.error);
+    REQUIRE(r.line == c.line);
+    REQUIRE(r.root == nullptr);
+  }
+}
+
+TEST_CASE("LoadXml enforces structural limits", "[loader]") {
+  Registry reg;
+  RegisterAll(reg);
+  alignas(64) static unsigned char buffer[65536];
+
+  SECTION("too many children") {
+    Arena arena(buffer, sizeof(buffer));
+    std::string xml = "<Sequence>";
+    for (uint16_t i = 0; i <= bt::Node<LoadCtx>::kMaxChildren; ++i) {
+      xml += "<Action tick=\"Step\"/>";
+    }
+    xml += "</Sequence>";
+    REQUIRE(Load(xml, reg, arena).error == bt::LoadError::kTooManyChildren);
+  }
+
+  SECTION("nesting too deep") {
+    Arena arena(buffer, sizeof(buffer));
+    std::string xml;
+    for (int i = 0; i <= BT_LOADER_MAX_DEPTH; ++i) {
+      xml += "<Sequence>";
+    }
+    REQUIRE(Load(xml, reg, arena).error == bt::LoadError::kTooDeep);
+  }
+
+  SECTION("arena exhausted") {
+    Arena arena(buffer, sizeof(bt::Node<LoadCtx>) * 2);
+    const std::string xml =
+        "<Sequence><Action tick=\"Step\"/><Action tick=\"Step\"/></Sequence>";
+    const bt::LoadResult<LoadCtx> r = Load(xml, reg, arena);
+    REQUIRE(r.error == bt::LoadError::kArenaFull);
+    REQUIRE(r.node_count == 2U);
+  }
+}
+
+namespace {
+
+// Alternating Sequence / Selector levels with kFanout children each
+constexpr uint32_t kFanout = 7;
+constexpr uint32_t kLevels = 5;
+
+void AppendSubtree(std::string& xml, uint32_t level) {
+  if (level == kLevels) {
+    xml += "<Action name=\"Leaf\" tick=\"Step\"/>\n";
+    return;
+  }
+  const char* tag = ((level % 2U) == 0U) ? "Sequence" : "Selector";
+  xml += std::string("<") + tag + " name=\"L" + std::to_string(level) +
+         "\">\n";
+  for (uint32_t i = 0; i < kFanout; ++i) {
+    AppendSubtree(xml, level + 1U);
+  }
+  xml += std::string("</") + tag + ">\n";
+}
+
+}  // namespace
+
+TEST_CASE("LoadXml loads a 20000-node tree", "[loader]") {
+  static_assert(kFanout <= BT_MAX_CHILDREN, "fanout exceeds BT_MAX_CHILDREN");
+  Registry reg;
+  RegisterAll(reg);
+
+  std::string xml = "<BehaviorTree>\n";
+  AppendSubtree(xml, 0);
+  xml += "</BehaviorTree>\n";
+  const uint32_t expected = 19608U;  // sum of 7^k, k = 0..5
+
+  std::vector<unsigned char> buffer(expected *
+                                    (sizeof(bt::Node<LoadCtx>) + 8U) + 64U);
+  Arena arena(buffer.data(), buffer.size());
+
+  const bt::LoadResult<LoadCtx> r = Load(xml, reg, arena);
+
+  REQUIRE(r.error == bt::LoadError::kNone);
+  REQUIRE(r.node_count == expected);
+  REQUIRE(r.root->ValidateTree() == bt::ValidateError::kNone);
+
+  // Sequences tick every child, selectors stop at the first success
+  LoadCtx ctx;
+  bt::BehaviorTree<LoadCtx> tree(*r.root, ctx);
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  REQUIRE(ctx.steps == 343);
+}
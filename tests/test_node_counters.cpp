@@ -0,0 +1,175 @@
+#include <catch2/catch.hpp>
+#include <bt/behavior_tree.hpp>
+
+#include <atomic>
+#include <thread>
+
+#if !defined(BT_COUNTERS)
+#error "test_node_counters.cpp is built with BT_COUNTERS (bt_tests_trace)"
+#endif
+
+namespace {
+
+struct CountCtx {
+  int ticks = 0;
+  bt::BehaviorTree<CountCtx>* inner = nullptr;
+};
+
+using NodeT = bt::Node<CountCtx>;
+using Snapshot = bt::NodeCountSnapshot<8>;
+
+bt::Status Fail(CountCtx& /*ctx*/) { return bt::Status::kFailure; }
+
+/* RUNNING twice, then SUCCESS. */
+bt::Status Thrice(CountCtx& ctx) {
+  return ((++ctx.ticks % 3) != 0) ? bt::Status::kRunning
+                                  : bt::Status::kSuccess;
+}
+
+bt::Status TickInner(CountCtx& ctx) { return ctx.inner->Tick(); }
+
+}  // namespace
+
+TEST_CASE("Counters split ticks by result and count entries", "[counters]") {
+  // Root(Sel) -> [F, W]
+  NodeT root("Root"), f("F"), w("W");
+  bt::factory::MakeAction(f, Fail);
+  bt::factory::MakeAction(w, Thrice);
+  root.set_type(bt::NodeType::kSelector).AddChild(f).AddChild(w);
+  bt::AssignNodeIds(root);  // Root 0, F 1, W 2
+
+  static bt::NodeCounterBlock<8> counters;
+  counters.Reset();
+  REQUIRE(counters.capacity() == 8U);
+  CountCtx ctx;
+  bt::BehaviorTree<CountCtx> tree(root, ctx);
+  tree.set_counters(&counters);
+  REQUIRE(tree.counters() == &counters);
+
+  Snapshot before;
+  counters.Snapshot(before);
+  for (int i = 0; i < 6; ++i) {
+    tree.Tick();
+  }
+  Snapshot after;
+  counters.Snapshot(after);
+  REQUIRE(after.tree_ticks == 6U);
+
+  // W: R R S R R S -> 4 running ticks, 2 successes, 2 entries
+  REQUIRE(after.get(bt::CounterColumn::kRunningTicks, 2) == 4U);
+  REQUIRE(after.get(bt::CounterColumn::kSuccesses, 2) == 2U);
+  REQUIRE(after.get(bt::CounterColumn::kEntries, 2) == 2U);
+  REQUIRE(after.ticks(2) == 6U);
+  // F only runs when the selector starts over
+  REQUIRE(after.get(bt::CounterColumn::kFailures, 1) == 2U);
+  REQUIRE(after.get(bt::CounterColumn::kEntries, 1) == 2U);
+  REQUIRE(after.ticks(0) == 6U);
+  REQUIRE(after.get(bt::CounterColumn::kErrors, 0) == 0U);
+
+  Snapshot d = after.Delta(before);
+  REQUIRE(d.ticks(2) == 6U);
+  tree.Tick();
+  Snapshot later;
+  counters.Snapshot(later);
+  d = later.Delta(after);
+  REQUIRE(d.tree_ticks == 1U);
+  REQUIRE(d.ticks(0) == 1U);
+  REQUIRE(d.get(bt::CounterColumn::kFailures, 1) == 1U);
+  REQUIRE(d.get(bt::CounterColumn::kEntries, 2) == 1U);
+
+  counters.Reset();
+  counters.Snapshot(later);
+  REQUIRE(later.ticks(0) == 0U);
+  REQUIRE(later.tree_ticks == 0U);
+
+  tree.set_counters(nullptr);
+  tree.Tick();
+  counters.Snapshot(later);
+  REQUIRE(later.ticks(0) == 0U);
+  REQUIRE(bt::NodeCounters::Active() == nullptr);
+}
+
+TEST_CASE("Tree halts count as failures, not ticks", "[counters]") {
+  // Root(Sel) -> [F, W]
+  NodeT root("Root"), f("F"), w("W");
+  bt::factory::MakeAction(f, Fail);
+  bt::factory::MakeAction(w, Thrice);
+  root.set_type(bt::NodeType::kSelector).AddChild(f).AddChild(w);
+  bt::AssignNodeIds(root);  // Root 0, F 1, W 2
+
+  static bt::NodeCounterBlock<8> counters;
+  counters.Reset();
+  CountCtx ctx;
+  bt::BehaviorTree<CountCtx> tree(root, ctx);
+  tree.set_counters(&counters);
+
+  tree.Tick();
+  tree.Halt();
+  Snapshot s;
+  counters.Snapshot(s);
+  REQUIRE(s.tree_ticks == 1U);
+  REQUIRE(s.get(bt::CounterColumn::kFailures, 2) == 1U);
+  REQUIRE(s.get(bt::CounterColumn::kFailures, 0) == 1U);
+  REQUIRE(s.get(bt::CounterColumn::kRunningTicks, 2) == 1U);
+  REQUIRE(s.get(bt::CounterColumn::kEntries, 2) == 1U);
+  REQUIRE_FALSE(root.is_running());
+}
+
+TEST_CASE("Nested trees may share a counter block", "[counters]") {
+  NodeT outer_root("Outer"), inner_root("Inner");
+  bt::factory::MakeAction(outer_root, TickInner);
+  bt::factory::MakeAction(inner_root, Fail);
+  outer_root.set_id(0);
+  inner_root.set_id(9);  // past capacity: ignored
+
+  static bt::NodeCounterBlock<8> counters;
+  counters.Reset();
+  CountCtx ctx;
+  bt::BehaviorTree<CountCtx> outer(outer_root, ctx);
+  bt::BehaviorTree<CountCtx> inner(inner_root, ctx);
+  ctx.inner = &inner;
+  outer.set_counters(&counters);
+  inner.set_counters(&counters);
+
+  outer.Tick();
+  Snapshot s;
+  counters.Snapshot(s);  // would spin forever if seq were left odd
+  REQUIRE(s.tree_ticks == 2U);
+  REQUIRE(s.get(bt::CounterColumn::kFailures, 0) == 1U);
+}
+
+TEST_CASE("Snapshots from another thread are consistent", "[counters]") {
+  NodeT root("Root"), a("A"), b("B");
+  bt::factory::MakeAction(a, Fail);
+  bt::factory::MakeAction(b, Fail);
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(b);
+  bt::AssignNodeIds(root);
+
+  static bt::NodeCounterBlock<8> counters;
+  counters.Reset();
+  CountCtx ctx;
+  bt::BehaviorTree<CountCtx> tree(root, ctx);
+  tree.set_counters(&counters);
+
+  std::atomic<bool> stop(false);
+  bool consistent = true;
+  uint32_t reads = 0;
+  std::thread reader([&] {
+    Snapshot s;
+    while (!stop.load(std::memory_order_acquire)) {
+      counters.Snapshot(s);
+      // Every tree tick ticks Root and A exactly once
+      consistent = consistent && (s.ticks(0) == s.tree_ticks) &&
+                   (s.ticks(1) == s.tree_ticks) && (s.ticks(2) == 0U);
+      ++reads;
+    }
+  });
+  for (int i = 0; i < 200000; ++i) {
+    tree.Tick();
+  }
+  stop.store(true, std::memory_order_release);
+  reader.join();
+
+  REQUIRE(consistent);
+  REQUIRE(reads > 0U);
+}
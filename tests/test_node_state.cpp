@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+#include <bt/behavior_tree.hpp>
+
+#if (BT_NODE_STATE_SIZE > 0)
+
+struct StateCtx {
+  int total = 0;
+};
+
+struct Progress {
+  uint32_t ticks;
+  uint32_t target;
+};
+
+static bt::Status CountToThree(StateCtx& ctx, bt::NodeState& state) {
+  Progress& p = state.as<Progress>();
+  ++p.ticks;
+  ++ctx.total;
+  return (p.ticks >= 3U) ? bt::Status::kSuccess : bt::Status::kRunning;
+}
+
+TEST_CASE("NodeState is zero-initialized", "[node_state]") {
+  bt::Node<StateCtx> n("N");
+  REQUIRE(n.state().as<Progress>().ticks == 0U);
+  REQUIRE(n.state().as<Progress>().target == 0U);
+  REQUIRE(n.has_state_tick() == false);
+}
+
+TEST_CASE("Stateful tick keeps per-node state across ticks", "[node_state]") {
+  bt::Node<StateCtx> a("A"), b("B");
+  bt::factory::MakeStatefulAction(a, CountToThree);
+  bt::factory::MakeStatefulAction(b, CountToThree);
+
+  REQUIRE(a.has_tick() == true);
+  REQUIRE(a.has_state_tick() == true);
+  REQUIRE(a.Validate() == bt::ValidateError::kNone);
+
+  StateCtx ctx;
+  REQUIRE(a.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(a.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(b.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(a.Tick(ctx) == bt::Status::kSuccess);
+
+  // Each node owns its block: same callback, independent progress
+  REQUIRE(a.state().as<Progress>().ticks == 3U);
+  REQUIRE(b.state().as<Progress>().ticks == 1U);
+  REQUIRE(ctx.total == 4);
+}
+
+TEST_CASE("Reset clears NodeState", "[node_state]") {
+  bt::Node<StateCtx> seq("Seq"), a("A");
+  bt::factory::MakeStatefulAction(a, CountToThree);
+  seq.set_type(bt::NodeType::kSequence).AddChild(a);
+
+  StateCtx ctx;
+  seq.Tick(ctx);
+  REQUIRE(a.state().as<Progress>().ticks == 1U);
+
+  seq.Reset();
+  REQUIRE(a.state().as<Progress>().ticks == 0U);
+}
+
+TEST_CASE("Stateful condition runs lifecycle callbacks", "[node_state]") {
+  bt::Node<StateCtx> c("Cond");
+  int enters = 0;
+  int exits = 0;
+  bt::factory::MakeStatefulCondition(
+      c, [](StateCtx&, bt::NodeState& s) {
+        return (s.as<uint8_t>() != 0U) ? bt::Status::kSuccess
+                                       : bt::Status::kFailure;
+      });
+  c.set_on_enter([&enters](StateCtx&) { ++enters; })
+      .set_on_exit([&exits](StateCtx&) { ++exits; });
+
+  StateCtx ctx;
+  REQUIRE(c.Tick(ctx) == bt::Status::kFailure);
+  c.state().as<uint8_t>() = 1U;
+  REQUIRE(c.Tick(ctx) == bt::Status::kSuccess);
+  REQUIRE(c.type() == bt::NodeType::kCondition);
+  REQUIRE(enters == 2);
+  REQUIRE(exits == 2);
+}
+
+TEST_CASE("Plain tick takes precedence over stateful tick", "[node_state]") {
+  bt::Node<StateCtx> n("N");
+  n.set_tick([](StateCtx&) { return bt::Status::kFailure; })
+      .set_state_tick(CountToThree);
+
+  StateCtx ctx;
+  REQUIRE(n.Tick(ctx) == bt::Status::kFailure);
+  REQUIRE(ctx.total == 0);
+}
+
+TEST_CASE("NodeState block is aligned", "[node_state]") {
+  bt::Node<StateCtx> n("N");
+  const auto addr = reinterpret_cast<uintptr_t>(n.state().data());
+  REQUIRE((addr % bt::NodeState::kAlign) == 0U);
+  REQUIRE(size_t{bt::NodeState::kSize} ==
+          static_cast<size_t>(BT_NODE_STATE_SIZE));
+}
+
+#endif  // BT_NODE_STATE_SIZE > 0
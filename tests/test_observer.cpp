@@ -0,0 +1,204 @@
+#include <catch2/catch.hpp>
+#include <bt/behavior_tree.hpp>
+#include <bt/binary_tree.hpp>
+#include <bt/hot_reload.hpp>
+#include <bt/optimize.hpp>
+#include <bt/tree_check.hpp>
+#include <bt/tree_patch.hpp>
+#include <bt/xml_loader.hpp>
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct ObsCtx {
+  int ticks = 0;
+};
+
+namespace {
+
+std::vector<std::string> g_log;
+
+/* Records every hook as a short string. */
+struct LogObserver : bt::NullObserver {
+  template <typename NodeT>
+  static void OnTick(const NodeT& node) noexcept {
+    g_log.push_back(std::string("tick ") + node.name());
+  }
+
+  template <typename NodeT>
+  static void OnStatusChange(const NodeT& node, bt::Status from,
+                             bt::Status to) noexcept {
+    g_log.push_back(std::string(node.name()) + " " +
+                    bt::StatusToString(from) + "->" + bt::StatusToString(to));
+  }
+
+  template <typename TreeT>
+  static void OnTreeTickBegin(const TreeT& tree) noexcept {
+    g_log.push_back("begin " + std::to_string(tree.tick_count()));
+  }
+
+  template <typename TreeT>
+  static void OnTreeTickEnd(const TreeT& /*tree*/, bt::Status result) noexcept {
+    g_log.push_back(std::string("end ") + bt::StatusToString(result));
+  }
+};
+
+/* Overrides a single hook; the rest fall back to NullObserver. */
+struct CountTicks : bt::NullObserver {
+  static int count;
+  template <typename NodeT>
+  static void OnTick(const NodeT& /*node*/) noexcept {
+    ++count;
+  }
+};
+int CountTicks::count = 0;
+
+using LogNode = bt::Node<ObsCtx, LogObserver>;
+
+bt::Status Ok(ObsCtx& /*ctx*/) { return bt::Status::kSuccess; }
+
+/* RUNNING on the first tick, SUCCESS on the second. */
+bt::Status Twice(ObsCtx& ctx) {
+  return ((++ctx.ticks % 2) != 0) ? bt::Status::kRunning
+                                  : bt::Status::kSuccess;
+}
+
+}  // namespace
+
+TEST_CASE("Default observer adds no state", "[observer]") {
+  REQUIRE(sizeof(bt::Node<ObsCtx>) == sizeof(LogNode));
+  REQUIRE(sizeof(bt::BehaviorTree<ObsCtx>) ==
+          sizeof(bt::BehaviorTree<ObsCtx, LogObserver>));
+  REQUIRE(std::is_same<bt::Node<ObsCtx>,
+                       bt::Node<ObsCtx, bt::NullObserver>>::value);
+}
+
+TEST_CASE("Observer sees ticks and status changes in order", "[observer]") {
+  LogNode root("Root"), a("A"), b("B");
+  bt::factory::MakeAction(a, Ok);
+  bt::factory::MakeAction(b, Twice);
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(b);
+
+  ObsCtx ctx;
+  bt::BehaviorTree<ObsCtx, LogObserver> tree(root, ctx);
+  g_log.clear();
+  REQUIRE(tree.Tick() == bt::Status::kRunning);
+  const std::vector<std::string> first = {
+      "begin 1",
+      "tick Root",
+      "tick A",
+      "A FAILURE->SUCCESS",
+      "tick B",
+      "B FAILURE->RUNNING",
+      "Root FAILURE->RUNNING",
+      "end RUNNING"};
+  REQUIRE(g_log == first);
+
+  // Resumed tick: A is skipped, unchanged statuses are not reported
+  g_log.clear();
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  const std::vector<std::string> second = {
+      "begin 2", "tick Root", "tick B", "B RUNNING->SUCCESS",
+      "Root RUNNING->SUCCESS", "end SUCCESS"};
+  REQUIRE(g_log == second);
+}
+
+TEST_CASE("Halting a RUNNING node reports the change", "[observer]") {
+  LogNode root("Root"), b("B");
+  bt::factory::MakeAction(b, Twice);
+  bt::factory::MakeInverter(root, b);
+
+  ObsCtx ctx;
+  REQUIRE(root.Tick(ctx) == bt::Status::kRunning);
+  g_log.clear();
+  root.Halt(ctx);
+  const std::vector<std::string> halted = {"B RUNNING->FAILURE",
+                                           "Root RUNNING->FAILURE"};
+  REQUIRE(g_log == halted);
+
+  g_log.clear();
+  root.Halt(ctx);  // idle: nothing to report
+  REQUIRE(g_log.empty());
+}
+
+TEST_CASE("Observer may override a single hook", "[observer]") {
+  bt::Node<ObsCtx, CountTicks> root("Root"), a("A"), b("B");
+  bt::factory::MakeAction(a, Ok);
+  bt::factory::MakeAction(b, Ok);
+  root.set_type(bt::NodeType::kSelector).AddChild(a).AddChild(b);
+  REQUIRE(root.ValidateTree() == bt::ValidateError::kNone);
+
+  ObsCtx ctx;
+  bt::BehaviorTree<ObsCtx, CountTicks> tree(root, ctx);
+  CountTicks::count = 0;
+  tree.Tick();
+  tree.Tick();
+  REQUIRE(CountTicks::count == 4);  // Root + A per tick
+}
+
+TEST_CASE("Tree helpers accept observer nodes", "[observer]") {
+  bt::Registry<ObsCtx> reg;  // callbacks do not depend on the observer
+  REQUIRE(reg.RegisterTick("Ok", Ok));
+  alignas(64) static unsigned char buffer[8192];
+  bt::NodeArena<ObsCtx, LogObserver> arena(buffer, sizeof(buffer));
+
+  const char* xml = R"(<BehaviorTree>
+  <Sequence name="Root">
+    <Sequence name="Wrap"><Action name="A" tick="Ok"/></Sequence>
+    <Action name="B" tick="Ok"/>
+  </Sequence>
+</BehaviorTree>)";
+  const bt::LoadResult<ObsCtx, LogObserver> loaded =
+      bt::LoadXml(xml, std::strlen(xml), reg, arena);
+  REQUIRE(loaded.error == bt::LoadError::kNone);
+  LogNode& root = *loaded.root;
+
+  const bt::OptimizeResult<ObsCtx, LogObserver> opt = bt::Optimize(root);
+  REQUIRE(opt.root == &root);
+  REQUIRE(opt.single_child == 1U);
+
+  std::vector<unsigned char> scratch(bt::CheckScratchBytes(8U, 8U));
+  const bt::CheckResult<ObsCtx, LogObserver> check =
+      bt::CheckTree(root, scratch.data(), scratch.size(), 8U);
+  REQUIRE(check.error == bt::CheckError::kNone);
+  REQUIRE(check.stats.node_count == 3U);
+
+  alignas(4) unsigned char image[512];
+  REQUIRE(bt::Serialize(root, reg, image, sizeof(image)).error ==
+          bt::BinaryError::kNone);
+
+  bt::TreePatch<ObsCtx, 4U, LogObserver> patch;
+  ObsCtx ctx;
+  patch.Remove(root, 1U);
+  REQUIRE(patch.Apply(ctx) == bt::PatchError::kNone);
+  REQUIRE(root.children_count() == 1U);
+
+  g_log.clear();
+  REQUIRE(root.Tick(ctx) == bt::Status::kSuccess);
+  REQUIRE(g_log.front() == "tick Root");
+}
+
+TEST_CASE("ReloadableTree ticks through BehaviorTree", "[observer]") {
+  LogNode v1("V1"), v2("V2");
+  bt::factory::MakeAction(v1, Ok);
+  bt::factory::MakeAction(v2, Ok);
+
+  ObsCtx ctx;
+  bt::ReloadableTree<ObsCtx, 16U, LogObserver> tree(v1, ctx);
+  g_log.clear();
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  const std::vector<std::string> first = {
+      "begin 1", "tick V1", "V1 FAILURE->SUCCESS", "end SUCCESS"};
+  REQUIRE(g_log == first);
+
+  REQUIRE(tree.Publish(v2) == bt::ReloadError::kNone);
+  g_log.clear();
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  const std::vector<std::string> second = {
+      "begin 2", "tick V2", "V2 FAILURE->SUCCESS", "end SUCCESS"};
+  REQUIRE(g_log == second);
+  REQUIRE(&tree.tree().root() == &v2);
+  REQUIRE(tree.tick_count() == 2U);
+}
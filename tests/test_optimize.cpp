@@ -0,0 +1,190 @@
+#include <catch2/catch.hpp>
+#include <bt/arena.hpp>
+#include <bt/optimize.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+struct OptCtx {
+  uint32_t seed = 1;
+  std::string trace;
+
+  /* Deterministic per-tick, per-leaf outcome. */
+  bt::Status Result(char leaf) const {
+    const uint32_t h = (seed * 2654435761U) ^ (static_cast<uint32_t>(leaf) *
+                                               40503U);
+    const uint32_t pick = (h >> 7) % 4U;
+    return (pick == 0U) ? bt::Status::kRunning
+         : (pick == 1U) ? bt::Status::kFailure
+         : bt::Status::kSuccess;
+  }
+};
+
+using NodeT = bt::Node<OptCtx>;
+using ArenaT = bt::NodeArena<OptCtx>;
+
+template <char kLeaf>
+bt::Status Leaf(OptCtx& ctx) {
+  ctx.trace += kLeaf;
+  return ctx.Result(kLeaf);
+}
+
+void Enter(OptCtx& ctx) { ctx.trace += '<'; }
+
+NodeT& Make(ArenaT& arena, const char* name, bt::NodeType type) {
+  NodeT* node = arena.Create(name);
+  REQUIRE(node != nullptr);
+  return node->set_type(type);
+}
+
+template <char kLeaf>
+NodeT& MakeLeaf(ArenaT& arena) {
+  NodeT* node = arena.Create("Leaf");
+  REQUIRE(node != nullptr);
+  return bt::factory::MakeAction(*node, Leaf<kLeaf>);
+}
+
+/*
+ * Root(Sequence)
+ * +-- Wrap(Sequence) -- A                       single child
+ * +-- Inner(Sequence) -- b, c                   nested sequence
+ * +-- Choice(Selector)
+ * |   +-- InnerSel(Selector)                    nested selector
+ * |   |   +-- Inverter -- Inverter -- D         double inverter
+ * |   |   +-- E
+ * |   +-- F
+ * +-- Inverter -- Inverter -- Solo(Sequence) -- G
+ * +-- Keep(Sequence, on_enter) -- H             kept: has a callback
+ */
+NodeT& BuildGenerated(ArenaT& arena) {
+  using T = bt::NodeType;
+  NodeT& root = Make(arena, "Root", T::kSequence);
+  root.AddChild(
+      Make(arena, "Wrap", T::kSequence).AddChild(MakeLeaf<'A'>(arena)));
+  root.AddChild(Make(arena, "Inner", T::kSequence)
+                    .AddChild(MakeLeaf<'b'>(arena))
+                    .AddChild(MakeLeaf<'c'>(arena)));
+  NodeT& inner_sel = Make(arena, "InnerSel", T::kSelector);
+  inner_sel.AddChild(Make(arena, "Not", T::kInverter)
+                         .AddChild(Make(arena, "NotNot", T::kInverter)
+                                       .AddChild(MakeLeaf<'D'>(arena))));
+  inner_sel.AddChild(MakeLeaf<'E'>(arena));
+  root.AddChild(Make(arena, "Choice", T::kSelector)
+                    .AddChild(inner_sel)
+                    .AddChild(MakeLeaf<'F'>(arena)));
+  NodeT& solo = Make(arena, "Solo", T::kSequence);
+  solo.AddChild(MakeLeaf<'G'>(arena));
+  NodeT& inv2 = Make(arena, "Inv2", T::kInverter).AddChild(solo);
+  root.AddChild(Make(arena, "Inv1", T::kInverter).AddChild(inv2));
+  root.AddChild(Make(arena, "Keep", T::kSequence)
+                    .set_on_enter(Enter)
+                    .AddChild(MakeLeaf<'H'>(arena)));
+  return root;
+}
+
+}  // namespace
+
+TEST_CASE("Optimize removes forwarding nodes and reports savings",
+          "[optimize]") {
+  std::vector<unsigned char> buffer(32U * 1024U);
+  ArenaT arena(buffer.data(), buffer.size());
+  NodeT& root = BuildGenerated(arena);
+
+  const bt::OptimizeResult<OptCtx> r = bt::Optimize(root);
+  REQUIRE(r.error == bt::ValidateError::kNone);
+  REQUIRE(r.root == &root);
+  REQUIRE(r.nodes_before == 19U);
+  REQUIRE(r.nodes_after == 11U);
+  REQUIRE(r.removed() == 8U);
+  REQUIRE(r.flattened == 2U);
+  REQUIRE(r.single_child == 2U);
+  REQUIRE(r.double_inverters == 2U);
+  REQUIRE(r.DispatchReductionPercent() == 42U);
+  REQUIRE(r.root->ValidateTree() == bt::ValidateError::kNone);
+
+  // Root(A, b, c, Choice(D, E, F), G, Keep(H))
+  REQUIRE(root.children_count() == 6U);
+  NodeT& choice = *root.child(3);
+  REQUIRE(std::string(choice.name()) == "Choice");
+  REQUIRE(choice.children_count() == 3U);
+  REQUIRE(choice.child(0)->tick() != nullptr);
+  REQUIRE(std::string(root.child(5)->name()) == "Keep");
+  REQUIRE(root.child(5)->children_count() == 1U);
+
+  // Idempotent
+  const bt::OptimizeResult<OptCtx> again = bt::Optimize(*r.root);
+  REQUIRE(again.removed() == 0U);
+  REQUIRE(again.root == r.root);
+}
+
+TEST_CASE("Optimized tree ticks exactly like the original", "[optimize]") {
+  std::vector<unsigned char> a(32U * 1024U), b(32U * 1024U);
+  ArenaT original_arena(a.data(), a.size());
+  ArenaT optimized_arena(b.data(), b.size());
+  NodeT& original = BuildGenerated(original_arena);
+  NodeT& optimized = *bt::Optimize(BuildGenerated(optimized_arena)).root;
+
+  OptCtx ctx_a, ctx_b;
+  for (uint32_t tick = 0; tick < 500U; ++tick) {
+    ctx_a.seed = ctx_b.seed = tick * 7919U + 13U;
+    REQUIRE(original.Tick(ctx_a) == optimized.Tick(ctx_b));
+    REQUIRE(ctx_a.trace == ctx_b.trace);
+  }
+}
+
+TEST_CASE("Optimize keeps callback nodes and respects child capacity",
+          "[optimize]") {
+  std::vector<unsigned char> buffer(64U * 1024U);
+  ArenaT arena(buffer.data(), buffer.size());
+  using T = bt::NodeType;
+
+  // Single-child root with a callback stays; so does an inverter pair
+  // whose inner half has one
+  NodeT& root = Make(arena, "Root", T::kSequence).set_on_enter(Enter);
+  NodeT& pair = Make(arena, "Outer", T::kInverter);
+  pair.AddChild(Make(arena, "Inner", T::kInverter)
+                    .set_on_enter(Enter)
+                    .AddChild(MakeLeaf<'x'>(arena)));
+  root.AddChild(pair);
+  bt::OptimizeResult<OptCtx> r = bt::Optimize(root);
+  REQUIRE(r.root == &root);
+  REQUIRE(r.removed() == 0U);
+
+  // Splicing a 3-child sequence into a full parent would overflow
+  const uint16_t kMax = NodeT::kMaxChildren;
+  NodeT& wide = Make(arena, "Wide", T::kSequence);
+  for (uint16_t i = 0; i + 1U < kMax; ++i) {
+    wide.AddChild(MakeLeaf<'w'>(arena));
+  }
+  NodeT& nested = Make(arena, "Nested", T::kSequence);
+  nested.AddChild(MakeLeaf<'n'>(arena))
+      .AddChild(MakeLeaf<'n'>(arena))
+      .AddChild(MakeLeaf<'n'>(arena));
+  wide.AddChild(nested);
+  r = bt::Optimize(wide);
+  REQUIRE(r.flattened == 0U);
+  REQUIRE(wide.children_count() == kMax);
+  REQUIRE(wide.child(static_cast<uint16_t>(kMax - 1U)) == &nested);
+
+  // With one slot to spare, a two-child sequence fits exactly
+  NodeT& roomy = Make(arena, "Roomy", T::kSequence);
+  for (uint16_t i = 0; i + 2U < kMax; ++i) {
+    roomy.AddChild(MakeLeaf<'w'>(arena));
+  }
+  NodeT& pair2 = Make(arena, "Pair", T::kSequence);
+  pair2.AddChild(MakeLeaf<'p'>(arena)).AddChild(MakeLeaf<'p'>(arena));
+  roomy.AddChild(pair2);
+  r = bt::Optimize(roomy);
+  REQUIRE(r.flattened == 1U);
+  REQUIRE(roomy.children_count() == kMax);
+
+  // Invalid trees are left alone
+  NodeT& broken = Make(arena, "Broken", T::kSequence);
+  broken.AddChild(Make(arena, "NoTick", T::kAction));
+  r = bt::Optimize(broken);
+  REQUIRE(r.error == bt::ValidateError::kLeafMissingTick);
+  REQUIRE(r.root == &broken);
+  REQUIRE(r.nodes_before == 0U);
+}
@@ -0,0 +1,161 @@
+#include <catch2/catch.hpp>
+#include <bt/perf_counters.hpp>
+
+#include <cstdio>
+
+namespace {
+
+struct PerfCtx {
+  int work = 0;
+};
+
+using PerfNode = bt::Node<PerfCtx, bt::PerfObserver>;
+using PerfTree = bt::BehaviorTree<PerfCtx, bt::PerfObserver>;
+
+bt::Status Work(PerfCtx& ctx) {
+  volatile int sink = 0;
+  for (int i = 0; i < 1000; ++i) {
+    sink = sink + i;
+  }
+  ctx.work += sink & 1;
+  return bt::Status::kSuccess;
+}
+
+bt::Status Check(PerfCtx& /*ctx*/) { return bt::Status::kSuccess; }
+
+/* Every count of the ticks is charged to exactly one node type. */
+void RequireTypesSumToTotal(const bt::PerfMeter& meter) {
+  const bt::NodeType kTypes[] = {bt::NodeType::kAction,
+                                 bt::NodeType::kCondition,
+                                 bt::NodeType::kSequence};
+  uint64_t ns = 0;
+  uint64_t events[bt::kPerfEvents] = {};
+  for (bt::NodeType t : kTypes) {
+    ns += meter.by_type(t).ns;
+    for (uint32_t e = 0; e < bt::kPerfEvents; ++e) {
+      events[e] += meter.by_type(t).events[e];
+    }
+  }
+  REQUIRE(ns == meter.total().ns);
+  for (uint32_t e = 0; e < bt::kPerfEvents; ++e) {
+    REQUIRE(events[e] == meter.total().events[e]);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Timing-only meter attributes time per tick and node type",
+          "[perf]") {
+  // Root(Seq) -> [C, Inner(Seq) -> [A, B]]
+  PerfNode root("Root"), c("C"), inner("Inner"), a("A"), b("B");
+  bt::factory::MakeCondition(c, Check);
+  bt::factory::MakeAction(a, Work);
+  bt::factory::MakeAction(b, Work);
+  inner.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(b);
+  root.set_type(bt::NodeType::kSequence).AddChild(c).AddChild(inner);
+
+  bt::PerfMeter meter(0U);
+  REQUIRE_FALSE(meter.available());
+  REQUIRE(meter.events() == 0U);
+
+  PerfCtx ctx;
+  PerfTree tree(root, ctx);
+  tree.Tick();  // no active meter: nothing measured
+  REQUIRE(meter.total().calls == 0U);
+  {
+    const bt::PerfMeter::Scope perf(&meter);
+    for (int i = 0; i < 3; ++i) {
+      tree.Tick();
+    }
+  }
+  REQUIRE(bt::PerfMeter::Active() == nullptr);
+  REQUIRE(meter.total().calls == 3U);
+  REQUIRE(meter.last_tick().calls == 1U);
+  REQUIRE(meter.total().ns >= meter.last_tick().ns);
+  REQUIRE(meter.by_type(bt::NodeType::kSequence).calls == 6U);
+  REQUIRE(meter.by_type(bt::NodeType::kAction).calls == 6U);
+  REQUIRE(meter.by_type(bt::NodeType::kCondition).calls == 3U);
+  REQUIRE(meter.total().get(bt::PerfEvent::kCycles) == 0U);
+  RequireTypesSumToTotal(meter);
+
+  meter.Reset();
+  REQUIRE(meter.total().calls == 0U);
+  REQUIRE(meter.by_type(bt::NodeType::kAction).calls == 0U);
+}
+
+TEST_CASE("Tick-boundary mode reads only around the root", "[perf]") {
+  PerfNode root("Root"), a("A");
+  bt::factory::MakeAction(a, Work);
+  root.set_type(bt::NodeType::kSequence).AddChild(a);
+
+  bt::PerfMeter meter(0U);
+  meter.set_node_types(false);
+  PerfCtx ctx;
+  PerfTree tree(root, ctx);
+  const bt::PerfMeter::Scope perf(&meter);
+  tree.Tick();
+  tree.Tick();
+  REQUIRE(meter.total().calls == 2U);
+  REQUIRE(meter.by_type(bt::NodeType::kAction).calls == 2U);
+  REQUIRE(meter.by_type(bt::NodeType::kAction).ns == 0U);
+}
+
+TEST_CASE("Hardware counters when the kernel allows them", "[perf]") {
+  PerfNode root("Root"), a("A"), b("B");
+  bt::factory::MakeAction(a, Work);
+  bt::factory::MakeAction(b, Work);
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(b);
+
+  bt::PerfMeter meter;
+  PerfCtx ctx;
+  PerfTree tree(root, ctx);
+  {
+    const bt::PerfMeter::Scope perf(&meter);
+    for (int i = 0; i < 10; ++i) {
+      tree.Tick();
+    }
+  }
+  REQUIRE(meter.total().calls == 10U);
+  RequireTypesSumToTotal(meter);
+  if (!meter.available()) {
+    WARN("perf_event_open unavailable; timing only");
+    REQUIRE(meter.events() == 0U);
+    return;
+  }
+  REQUIRE((meter.events() & ~bt::kAllPerfEvents) == 0U);
+  if ((meter.events() & bt::PerfEventBit(bt::PerfEvent::kInstructions)) !=
+      0U) {
+    REQUIRE(meter.by_type(bt::NodeType::kAction).get(
+                bt::PerfEvent::kInstructions) > 0U);
+  }
+
+  std::FILE* f = std::tmpfile();
+  REQUIRE(f != nullptr);
+  meter.Report(f);
+  REQUIRE(std::ftell(f) > 0);
+  std::fclose(f);
+}
+
+#if defined(BT_NODE_IDS)
+TEST_CASE("set_subtree measures one subtree only", "[perf]") {
+  PerfNode root("Root"), c("C"), inner("Inner"), a("A");
+  bt::factory::MakeCondition(c, Check);
+  bt::factory::MakeAction(a, Work);
+  inner.set_type(bt::NodeType::kSequence).AddChild(a);
+  root.set_type(bt::NodeType::kSequence).AddChild(c).AddChild(inner);
+  bt::AssignNodeIds(root);  // Root 0, C 1, Inner 2, A 3
+
+  bt::PerfMeter meter(0U);
+  meter.set_subtree(inner.id());
+  PerfCtx ctx;
+  PerfTree tree(root, ctx);
+  const bt::PerfMeter::Scope perf(&meter);
+  tree.Tick();
+  tree.Tick();
+  REQUIRE(meter.total().calls == 2U);
+  REQUIRE(meter.by_type(bt::NodeType::kSequence).calls == 2U);
+  REQUIRE(meter.by_type(bt::NodeType::kCondition).calls == 0U);
+  REQUIRE(meter.by_type(bt::NodeType::kAction).calls == 2U);
+  RequireTypesSumToTotal(meter);
+}
+#endif
@@ -0,0 +1,212 @@
+#include <catch2/catch.hpp>
+#include <bt/static_tree.hpp>
+
+#include <string>
+
+namespace {
+
+struct StCtx {
+  int work_left = 2;
+  bool ready = true;
+  std::string trace;
+};
+
+bt::Status Ready(StCtx& ctx) {
+  ctx.trace += 'r';
+  return ctx.ready ? bt::Status::kSuccess : bt::Status::kFailure;
+}
+
+bt::Status Work(StCtx& ctx) {
+  ctx.trace += 'w';
+  if (ctx.work_left > 0) {
+    --ctx.work_left;
+    return bt::Status::kRunning;
+  }
+  return bt::Status::kSuccess;
+}
+
+bt::Status Fail(StCtx& ctx) {
+  ctx.trace += 'f';
+  return bt::Status::kFailure;
+}
+
+void Enter(StCtx& ctx) { ctx.trace += '<'; }
+void Exit(StCtx& ctx) { ctx.trace += '>'; }
+
+#if (BT_NODE_STATE_SIZE > 0)
+bt::Status Count3(StCtx& ctx, bt::NodeState& state) {
+  ctx.trace += 'c';
+  int& n = state.as<int>();
+  return (++n < 3) ? bt::Status::kRunning : bt::Status::kSuccess;
+}
+#else
+bt::Status Count3(StCtx& ctx) { return Work(ctx); }
+#endif
+
+enum : uint16_t { kReady, kWork, kFail, kCount3, kEnter, kExit };
+
+constexpr bt::StaticFunction<StCtx> kFunctions[] = {Ready, Work,  Fail,
+                                                    Count3, Enter, Exit};
+
+namespace spec = bt::spec;
+
+/* Same shape as the Node tree below (pre-order). */
+constexpr bt::StaticNodeSpec kSpec[] = {
+    spec::Sequence(3).Named("Root").OnEnter(kEnter).OnExit(kExit),
+    spec::Condition(kReady).Named("Ready"),
+    spec::Parallel(2).Named("Par"),
+    spec::Action(kWork).Named("Work").OnEnter(kEnter).OnExit(kExit),
+    spec::Action(kCount3).Named("Count"),
+    spec::Selector(3).Named("Sel"),
+    spec::Inverter().Named("Inv"),
+    spec::Condition(kReady).Named("Ready2"),
+    spec::Action(kFail).Named("Fail"),
+    spec::Parallel(2, bt::ParallelPolicy::kRequireOne).Named("Any"),
+    spec::Action(kWork).Named("Work2"),
+    spec::Action(kFail).Named("Fail2"),
+};
+
+constexpr auto kTree = bt::BuildStaticTree(kSpec, kFunctions);
+BT_STATIC_VALIDATE(kTree);
+static_assert(kTree.error == bt::SpecError::kNone, "sample must build");
+static_assert(kTree.size() == 12U, "one record per entry");
+static_assert(kTree.max_depth == 4U, "Root > Sel > Any > Work2");
+static_assert(kTree.state_size() == 12U * sizeof(bt::FlatSlot), "slot block");
+static_assert(kTree.nodes[0].child_count == 3U, "root children");
+static_assert(kTree.children[kTree.nodes[0].first_child + 2U] == 5U,
+              "third root child is Sel");
+static_assert(kTree.nodes[9].policy == bt::ParallelPolicy::kRequireOne,
+              "policy kept");
+
+constexpr bt::StaticFunctions<StCtx> kTable(kFunctions);
+
+bt::FlatSlot g_slots[kTree.size()];  // constant-initialized, no ctor code
+
+struct NodeTree {
+  bt::Node<StCtx> root{"Root"}, ready{"Ready"}, par{"Par"}, work{"Work"},
+      count{"Count"}, sel{"Sel"}, inv{"Inv"}, ready2{"Ready2"}, fail{"Fail"},
+      any{"Any"}, work2{"Work2"}, fail2{"Fail2"};
+
+  NodeTree() {
+    root.set_type(bt::NodeType::kSequence).set_on_enter(Enter).set_on_exit(
+        Exit);
+    bt::factory::MakeCondition(ready, Ready);
+    par.set_type(bt::NodeType::kParallel);
+    bt::factory::MakeAction(work, Work).set_on_enter(Enter).set_on_exit(Exit);
+#if (BT_NODE_STATE_SIZE > 0)
+    bt::factory::MakeStatefulAction(count, Count3);
+#else
+    bt::factory::MakeAction(count, Count3);
+#endif
+    par.AddChild(work).AddChild(count);
+    sel.set_type(bt::NodeType::kSelector);
+    bt::factory::MakeCondition(ready2, Ready);
+    inv.set_type(bt::NodeType::kInverter).AddChild(ready2);
+    bt::factory::MakeAction(fail, Fail);
+    any.set_type(bt::NodeType::kParallel)
+        .set_parallel_policy(bt::ParallelPolicy::kRequireOne);
+    bt::factory::MakeAction(work2, Work);
+    bt::factory::MakeAction(fail2, Fail);
+    any.AddChild(work2).AddChild(fail2);
+    sel.AddChild(inv).AddChild(fail).AddChild(any);
+    root.AddChild(ready).AddChild(par).AddChild(sel);
+  }
+};
+
+template <uint32_t kNodes>
+constexpr bt::SpecError ErrorOf(const bt::StaticNodeSpec (&list)[kNodes]) {
+  return bt::BuildStaticTree(list, kFunctions).error;
+}
+
+constexpr bt::StaticNodeSpec kShort[] = {spec::Sequence(2),
+                                         spec::Action(kWork)};
+constexpr bt::StaticNodeSpec kTwoRoots[] = {spec::Action(kWork),
+                                            spec::Action(kWork)};
+constexpr bt::StaticNodeSpec kBadIndex[] = {spec::Action(40)};
+constexpr bt::StaticNodeSpec kTickIsCallback[] = {spec::Action(kEnter)};
+constexpr bt::StaticNodeSpec kEnterIsTick[] = {
+    spec::Action(kWork).OnEnter(kFail)};
+constexpr bt::StaticNodeSpec kOverclaimed[] = {spec::Sequence(3),
+                                               spec::Sequence(3),
+                                               spec::Action(kWork)};
+
+static_assert(ErrorOf(kShort) == bt::SpecError::kMissingChildren, "");
+static_assert(ErrorOf(kTwoRoots) == bt::SpecError::kMultipleRoots, "");
+static_assert(ErrorOf(kBadIndex) == bt::SpecError::kUnknownFunction, "");
+static_assert(ErrorOf(kTickIsCallback) == bt::SpecError::kWrongFunctionKind,
+              "");
+static_assert(ErrorOf(kEnterIsTick) == bt::SpecError::kWrongFunctionKind, "");
+static_assert(ErrorOf(kOverclaimed) == bt::SpecError::kMissingChildren, "");
+
+template <uint32_t kNodes>
+constexpr bt::ValidateError RuleOf(const bt::StaticNodeSpec (&list)[kNodes]) {
+  return bt::BuildStaticTree(list, kFunctions).validate_error;
+}
+
+constexpr bt::StaticNodeSpec kNoTick[] = {spec::Action(bt::kNoFunction)};
+constexpr bt::StaticNodeSpec kWideInverter[] = {
+    bt::StaticNodeSpec{bt::NodeType::kInverter, bt::ParallelPolicy::kRequireAll,
+                       2U, bt::kNoFunction, bt::kNoFunction, bt::kNoFunction,
+                       "Inv"},
+    spec::Action(kWork), spec::Action(kWork)};
+constexpr bt::StaticNodeSpec kWide[] = {spec::Parallel(BT_MAX_CHILDREN + 1U)};
+
+static_assert(RuleOf(kNoTick) == bt::ValidateError::kLeafMissingTick, "");
+static_assert(ErrorOf(kNoTick) == bt::SpecError::kInvalidNode, "");
+static_assert(RuleOf(kWideInverter) ==
+                  bt::ValidateError::kInverterNotOneChild, "");
+static_assert(RuleOf(kWide) == bt::ValidateError::kChildrenExceedMax, "");
+static_assert(bt::ValidateSpec(spec::Parallel(33)) ==
+                  ((BT_MAX_CHILDREN >= 33)
+                       ? bt::ValidateError::kParallelExceedsBitmap
+                       : bt::ValidateError::kChildrenExceedMax), "");
+static_assert(bt::ValidateSpec(spec::Inverter()) == bt::ValidateError::kNone,
+              "");
+static_assert(bt::ValidateSpec(bt::StaticNodeSpec{
+                  bt::NodeType::kSubtree, bt::ParallelPolicy::kRequireAll, 0U,
+                  bt::kNoFunction, bt::kNoFunction, bt::kNoFunction, ""}) ==
+                  bt::ValidateError::kInvalidSubtree, "");
+
+}  // namespace
+
+TEST_CASE("Static tree matches Node ticking", "[static]") {
+  NodeTree t;
+  const bt::Node<StCtx>* order[] = {&t.root, &t.ready, &t.par,   &t.work,
+                                    &t.count, &t.sel,  &t.inv,   &t.ready2,
+                                    &t.fail, &t.any,   &t.work2, &t.fail2};
+  StCtx node_ctx, static_ctx;
+  bt::BehaviorTree<StCtx> tree(t.root, node_ctx);
+  auto compiled = kTree.MakeExecutor(kTable, g_slots, static_ctx);
+
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < 8; ++i) {
+      if (i == 4) {
+        node_ctx.ready = static_ctx.ready = (round == 1);
+      }
+      REQUIRE(compiled.Tick() == tree.Tick());
+      REQUIRE(static_ctx.trace == node_ctx.trace);
+      for (uint32_t n = 0; n < kTree.size(); ++n) {
+        REQUIRE(compiled.status(n) == order[n]->status());
+      }
+    }
+    tree.Reset();
+    compiled.Reset();
+    node_ctx = StCtx{};
+    static_ctx = StCtx{};
+  }
+}
+
+TEST_CASE("Static tree keeps names and function table", "[static]") {
+  REQUIRE(std::string(kTree.names[kTree.nodes[6].name]) == "Inv");
+  REQUIRE(kTable.size() == 6U);
+  REQUIRE(kFunctions[kCount3].is_tick());
+  REQUIRE(kFunctions[kExit].is_callback());
+  REQUIRE(kTree.error_node == 0U);
+  REQUIRE(std::string(bt::SpecErrorToString(
+              bt::BuildStaticTree(kShort, kFunctions).error)) ==
+          "MISSING_CHILDREN");
+  REQUIRE(bt::BuildStaticTree(kEnterIsTick, kFunctions).error_node == 0U);
+  REQUIRE(bt::BuildStaticTree(kWideInverter, kFunctions).error_node == 0U);
+  REQUIRE(std::string(bt::SpecErrorToString(bt::SpecError::kInvalidNode)) ==
+          "INVALID_NODE");
+}
@@ -0,0 +1,236 @@
+#include <catch2/catch.hpp>
+#include <bt/behavior_tree.hpp>
+#include <bt/hot_reload.hpp>
+#include <bt/tree_patch.hpp>
+
+#include <vector>
+
+#if !defined(BT_STATUS_STREAM)
+#error "test_status_stream.cpp is built with BT_STATUS_STREAM (bt_tests_trace)"
+#endif
+
+namespace {
+
+struct StreamCtx {
+  int ticks = 0;
+  int period = 3;
+};
+
+using NodeT = bt::Node<StreamCtx>;
+
+bt::Status Ok(StreamCtx& /*ctx*/) { return bt::Status::kSuccess; }
+
+/* RUNNING for period - 1 ticks, then SUCCESS. */
+bt::Status Slow(StreamCtx& ctx) {
+  return ((++ctx.ticks % ctx.period) != 0) ? bt::Status::kRunning
+                                           : bt::Status::kSuccess;
+}
+
+/* Drains and decodes everything in @p stream. */
+std::vector<bt::StatusEvent> DrainAll(bt::StatusStream& stream,
+                                      bt::StatusStreamReader& reader,
+                                      uint32_t* bytes = nullptr) {
+  uint8_t buf[1024];
+  const uint32_t len = stream.Drain(buf, sizeof(buf));
+  if (bytes != nullptr) {
+    *bytes = len;
+  }
+  std::vector<bt::StatusEvent> out;
+  bt::StatusEvent e;
+  uint32_t pos = 0;
+  uint32_t n = 0;
+  while ((n = reader.Decode(buf + pos, len - pos, e)) > 0U) {
+    pos += n;
+    out.push_back(e);
+  }
+  REQUIRE(pos == len);
+  REQUIRE_FALSE(reader.error());
+  return out;
+}
+
+void RequireEvent(const bt::StatusEvent& e, uint64_t tick, uint16_t id,
+                  bt::Status from, bt::Status to) {
+  REQUIRE(e.tick == tick);
+  REQUIRE(e.node_id == id);
+  REQUIRE(e.from == from);
+  REQUIRE(e.to == to);
+}
+
+}  // namespace
+
+TEST_CASE("Status stream skips RUNNING repeats", "[status_stream]") {
+  // Root(Seq) -> [C, W]
+  NodeT root("Root"), c("C"), w("W");
+  bt::factory::MakeCondition(c, Ok);
+  bt::factory::MakeAction(w, Slow);
+  root.set_type(bt::NodeType::kSequence).AddChild(c).AddChild(w);
+  bt::AssignNodeIds(root);  // Root 0, C 1, W 2
+
+  static uint8_t storage[256];
+  bt::StatusStream stream(storage, 256);
+  REQUIRE(stream.capacity() == 256U);
+  StreamCtx ctx;
+  bt::BehaviorTree<StreamCtx> tree(root, ctx);
+  tree.set_status_stream(&stream);
+  REQUIRE(tree.status_stream() == &stream);
+
+  tree.Tick();
+  tree.Tick();  // W and Root stay RUNNING: nothing recorded
+  tree.Tick();
+  REQUIRE(stream.tick() == 3U);
+  REQUIRE(stream.events() == 5U);
+
+  bt::StatusStreamReader reader;
+  uint32_t bytes = 0;
+  auto events = DrainAll(stream, reader, &bytes);
+  REQUIRE(events.size() == 5U);
+  // Sync (3) + same-tick deltas (2 each) + tick delta (3) + one more (2)
+  REQUIRE(bytes == 3U + 2U + 2U + 3U + 2U);
+  const auto F = bt::Status::kFailure;
+  const auto S = bt::Status::kSuccess;
+  const auto R = bt::Status::kRunning;
+  RequireEvent(events[0], 1, 1, F, S);
+  RequireEvent(events[1], 1, 2, F, R);
+  RequireEvent(events[2], 1, 0, F, R);
+  RequireEvent(events[3], 3, 2, R, S);
+  RequireEvent(events[4], 3, 0, R, S);
+
+  // Halting the tree is a change too, children first, stamped with the
+  // preceding tick
+  tree.Tick();
+  DrainAll(stream, reader);
+  tree.Halt();
+  REQUIRE(stream.tick() == 4U);
+  REQUIRE(tree.last_status() == F);
+  events = DrainAll(stream, reader);
+  REQUIRE(events.size() == 2U);
+  RequireEvent(events[0], 4, 2, R, F);
+  RequireEvent(events[1], 4, 0, R, F);
+  tree.Tick();  // the reset tree starts over
+  REQUIRE(DrainAll(stream, reader).size() == 3U);
+
+  tree.set_status_stream(nullptr);
+  tree.Tick();
+  REQUIRE(stream.size() == 0U);
+  REQUIRE(bt::StatusStream::Active() == nullptr);
+}
+
+TEST_CASE("Patches and reloads record their halts", "[status_stream]") {
+  // Root(Seq) -> [C, W]; W2 replaces W, then V2 replaces the whole tree
+  NodeT root("Root"), c("C"), w("W"), w2("W2"), v2("V2");
+  bt::factory::MakeCondition(c, Ok);
+  bt::factory::MakeAction(w, Slow);
+  bt::factory::MakeAction(w2, Slow);
+  bt::factory::MakeAction(v2, Ok);
+  root.set_type(bt::NodeType::kSequence).AddChild(c).AddChild(w);
+  bt::AssignNodeIds(root);  // Root 0, C 1, W 2
+  w2.set_id(3);
+  v2.set_id(4);
+
+  static uint8_t storage[256];
+  bt::StatusStream stream(storage, 256);
+  bt::StatusStreamReader reader;
+  StreamCtx ctx;
+  bt::ReloadableTree<StreamCtx, 16U> tree(root, ctx);
+  tree.tree().set_status_stream(&stream);
+  const auto F = bt::Status::kFailure;
+  const auto R = bt::Status::kRunning;
+
+  tree.Tick();
+  DrainAll(stream, reader);
+  bt::TreePatch<StreamCtx> patch;
+  patch.Replace(root, 1U, w2);
+  REQUIRE(patch.Apply(tree.tree()) == bt::PatchError::kNone);
+  auto events = DrainAll(stream, reader);
+  REQUIRE(events.size() == 1U);
+  RequireEvent(events[0], 1, 2, R, F);
+
+  tree.Tick();  // Root resumes at W2
+  DrainAll(stream, reader);
+  REQUIRE(tree.Publish(v2) == bt::ReloadError::kNone);
+  tree.Tick();  // kHalt: W2 and Root halted before V2 ticks
+  events = DrainAll(stream, reader);
+  REQUIRE(events.size() == 3U);
+  RequireEvent(events[0], 2, 3, R, F);
+  RequireEvent(events[1], 2, 0, R, F);
+  RequireEvent(events[2], 3, 4, F, bt::Status::kSuccess);
+}
+
+TEST_CASE("Long RUNNING actions cost nothing per tick", "[status_stream]") {
+  NodeT root("Root"), w("W");
+  bt::factory::MakeAction(w, Slow);
+  root.set_type(bt::NodeType::kSequence).AddChild(w);
+  bt::AssignNodeIds(root);
+
+  static uint8_t storage[256];
+  bt::StatusStream stream(storage, 256);
+  StreamCtx ctx;
+  ctx.period = 1000;
+  bt::BehaviorTree<StreamCtx> tree(root, ctx);
+  tree.set_status_stream(&stream);
+  for (int i = 0; i < 1000; ++i) {
+    tree.Tick();
+  }
+  // Enter W and Root on tick 1, leave both on tick 1000
+  REQUIRE(stream.events() == 4U);
+  REQUIRE(stream.size() <= 12U);
+
+  bt::StatusStreamReader reader;
+  const auto events = DrainAll(stream, reader);
+  REQUIRE(events.size() == 4U);
+  REQUIRE(events[2].tick == 1000U);
+}
+
+TEST_CASE("Status stream resyncs after a full ring", "[status_stream]") {
+  NodeT root("Root"), a("A"), b("B");
+  bt::factory::MakeAction(a, Ok);
+  bt::factory::MakeAction(b, Ok);
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(b);
+  bt::AssignNodeIds(root);
+
+  static uint8_t storage[16];
+  bt::StatusStream stream(storage, 16);
+  StreamCtx ctx;
+  bt::BehaviorTree<StreamCtx> tree(root, ctx);
+  tree.set_status_stream(&stream);
+  for (int i = 0; i < 5; ++i) {
+    tree.Tick();  // 3 events per tick
+  }
+  REQUIRE(stream.dropped() > 0U);
+
+  bt::StatusStreamReader reader;
+  auto events = DrainAll(stream, reader);
+  REQUIRE_FALSE(events.empty());
+  REQUIRE(events[0].tick == 1U);
+
+  tree.Tick();  // first event after the drop carries absolute values
+  events = DrainAll(stream, reader);
+  REQUIRE(events.size() == 3U);
+  RequireEvent(events[0], 6, 1, bt::Status::kSuccess, bt::Status::kSuccess);
+  RequireEvent(events[2], 6, 0, bt::Status::kSuccess, bt::Status::kSuccess);
+}
+
+TEST_CASE("Status stream reader handles split and bad input",
+          "[status_stream]") {
+  // sync event: tick 300 (2-byte varint), node 5
+  const uint8_t sync[] = {0x20U | 0x04U | 0x01U, 0xACU, 0x02U, 0x05U};
+  bt::StatusStreamReader reader;
+  bt::StatusEvent e;
+  REQUIRE(reader.Decode(sync, 2, e) == 0U);  // partial
+  REQUIRE_FALSE(reader.error());
+  REQUIRE(reader.Decode(sync, 4, e) == 4U);
+  RequireEvent(e, 300, 5, bt::Status::kFailure, bt::Status::kFailure);
+
+  // delta event: next tick, node 5 - 2
+  const uint8_t delta[] = {0x10U | 0x08U, 0x01U, 0x03U};
+  REQUIRE(reader.Decode(delta, 3, e) == 3U);
+  RequireEvent(e, 301, 3, bt::Status::kSuccess, bt::Status::kRunning);
+
+  const uint8_t bad[] = {0x40U};
+  REQUIRE(reader.Decode(bad, 1, e) == 0U);
+  REQUIRE(reader.error());
+
+  bt::StatusStreamReader fresh;  // deltas need a sync event first
+  REQUIRE(fresh.Decode(delta, 3, e) == 0U);
+  REQUIRE(fresh.error());
+}
@@ -0,0 +1,158 @@
+#include <catch2/catch.hpp>
+#include <bt/behavior_tree.hpp>
+
+#if !defined(BT_DEADLINE)
+#error "test_tick_deadline.cpp is built with BT_DEADLINE (bt_tests_trace)"
+#endif
+
+namespace {
+
+struct DeadlineCtx {
+  int a = 0;
+  int slow = 0;
+  int c = 0;
+};
+
+using NodeT = bt::Node<DeadlineCtx>;
+
+uint64_t g_clock = 0;
+
+uint64_t FakeClock() { return g_clock; }
+
+bt::Status A(DeadlineCtx& ctx) {
+  ++ctx.a;
+  g_clock += 10U;
+  return bt::Status::kSuccess;
+}
+
+bt::Status Slow(DeadlineCtx& ctx) {
+  ++ctx.slow;
+  g_clock += 500U;
+  return bt::Status::kSuccess;
+}
+
+bt::Status C(DeadlineCtx& ctx) {
+  ++ctx.c;
+  g_clock += 10U;
+  return bt::Status::kSuccess;
+}
+
+struct Seen {
+  int calls = 0;
+  uint16_t node_id = 0;
+};
+
+void OnOverrun(const bt::OverrunRecord& r, void* user) {
+  Seen* seen = static_cast<Seen*>(user);
+  ++seen->calls;
+  seen->node_id = r.node_id;
+}
+
+/* Root(Seq) -> [A, Mid(Seq) -> [Slow, C]] */
+struct Tree {
+  NodeT root{"Root"}, a{"A"}, mid{"Mid"}, slow{"Slow"}, c{"C"};
+  Tree() {
+    bt::factory::MakeAction(a, A);
+    bt::factory::MakeAction(slow, Slow);
+    bt::factory::MakeAction(c, C);
+    mid.set_type(bt::NodeType::kSequence).AddChild(slow).AddChild(c);
+    root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(mid);
+    bt::AssignNodeIds(root);  // Root 0, A 1, Mid 2, Slow 3, C 4
+  }
+};
+
+}  // namespace
+
+TEST_CASE("Watchdog attributes an overrun to the slow node", "[deadline]") {
+  Tree t;
+  DeadlineCtx ctx;
+  bt::BehaviorTree<DeadlineCtx> tree(t.root, ctx);
+  bt::OverrunRecord log[2];
+  bt::TickWatchdog watchdog(log, 2, FakeClock);
+  Seen seen;
+  watchdog.set_budget(100).set_on_overrun(OnOverrun, &seen);
+  tree.set_watchdog(&watchdog);
+  REQUIRE(tree.watchdog() == &watchdog);
+
+  g_clock = 0;
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);  // not aborting: completes
+  REQUIRE(ctx.c == 1);
+  REQUIRE(watchdog.overruns() == 1U);
+  REQUIRE(seen.calls == 1);  // once per tick, not once per boundary
+  REQUIRE(seen.node_id == 3U);
+
+  const bt::OverrunRecord& r = watchdog.record(0);
+  REQUIRE(r.tick == 0U);
+  REQUIRE(r.elapsed == 510U);
+  REQUIRE(r.node_id == 3U);
+  REQUIRE(r.depth == 3U);
+  REQUIRE(r.path[0] == 0U);
+  REQUIRE(r.path[1] == 2U);
+  REQUIRE(r.path[2] == 3U);
+  REQUIRE(r.aborted == false);
+
+  // Log keeps the latest records
+  for (int i = 0; i < 3; ++i) {
+    tree.Tick();
+  }
+  REQUIRE(watchdog.overruns() == 4U);
+  REQUIRE(watchdog.size() == 2U);
+  REQUIRE(watchdog.record(0).tick == 2U);
+  REQUIRE(watchdog.record(1).tick == 3U);
+  REQUIRE(watchdog.ticks() == 4U);
+  watchdog.ClearLog();
+  REQUIRE(watchdog.size() == 0U);
+
+  // Within budget: nothing recorded
+  watchdog.set_budget(1000);
+  tree.Tick();
+  REQUIRE(watchdog.overruns() == 0U);
+}
+
+TEST_CASE("Aborting watchdog yields and resumes next tick", "[deadline]") {
+  Tree t;
+  DeadlineCtx ctx;
+  bt::BehaviorTree<DeadlineCtx> tree(t.root, ctx);
+  bt::OverrunRecord log[4];
+  bt::TickWatchdog watchdog(log, 4, FakeClock);
+  watchdog.set_budget(100).set_abort(true);
+  tree.set_watchdog(&watchdog);
+
+  g_clock = 0;
+  REQUIRE(tree.Tick() == bt::Status::kRunning);
+  REQUIRE(ctx.slow == 1);
+  REQUIRE(ctx.c == 0);  // yielded
+  REQUIRE(watchdog.record(0).aborted);
+
+  // Resumes at C; A and Slow are not ticked again
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  REQUIRE(ctx.a == 1);
+  REQUIRE(ctx.slow == 1);
+  REQUIRE(ctx.c == 1);
+  REQUIRE(watchdog.overruns() == 1U);
+}
+
+TEST_CASE("Stride thins the checks", "[deadline]") {
+  Tree t;
+  DeadlineCtx ctx;
+  bt::BehaviorTree<DeadlineCtx> tree(t.root, ctx);
+  bt::TickWatchdog watchdog(nullptr, 0, FakeClock);
+  watchdog.set_budget(100).set_stride(4);
+  tree.set_watchdog(&watchdog);
+
+  // Boundaries: Root+ A+ A- Mid+ Slow+ Slow- C+ C- Mid- Root-; every 4th
+  // is Mid+ (10 elapsed) and C- (520): detected at C
+  g_clock = 0;
+  Seen seen;
+  watchdog.set_on_overrun(OnOverrun, &seen);
+  tree.Tick();
+  REQUIRE(watchdog.overruns() == 1U);
+  REQUIRE(watchdog.size() == 0U);  // no log storage
+  REQUIRE(seen.node_id == 4U);
+
+  // No watchdog: plain ticks
+  tree.set_watchdog(nullptr);
+  tree.Tick();
+  REQUIRE(watchdog.ticks() == 1U);
+  REQUIRE(bt::TickWatchdog::Active() == nullptr);
+}
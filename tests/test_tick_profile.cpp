@@ -0,0 +1,154 @@
+#include <catch2/catch.hpp>
+#include <bt/behavior_tree.hpp>
+
+#if !defined(BT_PROFILE)
+#error "test_tick_profile.cpp is built with BT_PROFILE (bt_tests_trace)"
+#endif
+
+namespace {
+
+struct ProfCtx {
+  bt::BehaviorTree<ProfCtx>* inner = nullptr;
+};
+
+using NodeT = bt::Node<ProfCtx>;
+
+uint64_t g_fake_clock = 0;
+
+/* Advances 1 unit per read; leaves below add their own cost. */
+uint64_t FakeClock() { return ++g_fake_clock; }
+
+bt::Status Cheap(ProfCtx& /*ctx*/) {
+  g_fake_clock += 10U;
+  return bt::Status::kSuccess;
+}
+
+bt::Status Costly(ProfCtx& /*ctx*/) {
+  g_fake_clock += 1000U;
+  return bt::Status::kSuccess;
+}
+
+bt::Status TickInner(ProfCtx& ctx) { return ctx.inner->Tick(); }
+
+}  // namespace
+
+TEST_CASE("Profiler splits inclusive and exclusive time", "[profile]") {
+  NodeT root("Root"), cheap("Cheap"), costly("Costly");
+  bt::factory::MakeAction(cheap, Cheap);
+  bt::factory::MakeAction(costly, Costly);
+  root.set_type(bt::NodeType::kSequence).AddChild(cheap).AddChild(costly);
+  REQUIRE(bt::AssignNodeIds(root) == 3U);
+
+  bt::NodeProfile slots[3];
+  g_fake_clock = 0;
+  bt::TickProfiler profiler(slots, 3, FakeClock);
+  ProfCtx ctx;
+  bt::BehaviorTree<ProfCtx> tree(root, ctx);
+  tree.set_profiler(&profiler);
+  REQUIRE(tree.profiler() == &profiler);
+
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  }
+
+  // Each leaf: its own cost + 1 clock read; root: both leaves + 1 read
+  const bt::NodeProfile& c = *profiler.node(1);
+  const bt::NodeProfile& k = *profiler.node(2);
+  const bt::NodeProfile& r = *profiler.node(0);
+  REQUIRE(c.calls == 4U);
+  REQUIRE(c.inclusive == 4U * 11U);
+  REQUIRE(c.exclusive == c.inclusive);
+  REQUIRE(k.max == 1001U);
+  REQUIRE(r.calls == 4U);
+  REQUIRE(r.inclusive == 4U * (1U + 11U + 1U + 1001U + 1U));
+  REQUIRE(r.exclusive == r.inclusive - c.inclusive - k.inclusive);
+
+  // 11 -> bucket 3 [8, 16), 1001 -> bucket 9 [512, 1024)
+  REQUIRE(c.histogram[3] == 4U);
+  REQUIRE(k.histogram[9] == 4U);
+  REQUIRE(c.Percentile(0.5) == 15U);
+  REQUIRE(k.Percentile(0.99) == 1023U);
+
+  uint16_t top[2];
+  REQUIRE(profiler.TopN(top, 2) == 2U);
+  REQUIRE(top[0] == 2U);
+  REQUIRE(top[1] == 1U);
+
+  profiler.Reset();
+  REQUIRE(profiler.node(0)->calls == 0U);
+  REQUIRE(profiler.TopN(top, 2) == 0U);
+
+  tree.set_profiler(nullptr);
+  tree.Tick();
+  REQUIRE(profiler.node(0)->calls == 0U);
+  REQUIRE(bt::TickProfiler::Active() == nullptr);
+}
+
+TEST_CASE("Profiler ignores ids past its slots", "[profile]") {
+  NodeT root("Root"), a("A"), b("B");
+  bt::factory::MakeAction(a, Cheap);
+  bt::factory::MakeAction(b, Costly);
+  root.set_type(bt::NodeType::kSelector).AddChild(a).AddChild(b);
+  bt::AssignNodeIds(root);
+
+  bt::NodeProfile slots[2];
+  bt::TickProfiler profiler(slots, 2, FakeClock);
+  REQUIRE(profiler.count() == 2U);
+  REQUIRE(profiler.node(2) == nullptr);
+
+  ProfCtx ctx;
+  {
+    const bt::TickProfiler::Scope scope(&profiler);
+    root.Tick(ctx);
+  }
+  REQUIRE(slots[0].calls == 1U);
+  REQUIRE(slots[1].calls == 1U);
+
+  uint16_t top[1];
+  REQUIRE(profiler.TopN(top, 1) == 1U);
+  REQUIRE(top[0] == 1U);  // leaf exclusive 11 > root exclusive 3
+
+  bt::TickProfiler empty(nullptr, 5);
+  REQUIRE(empty.count() == 0U);
+  {
+    const bt::TickProfiler::Scope scope(&empty);
+    root.Tick(ctx);
+  }
+  REQUIRE(empty.TopN(top, 1) == 0U);
+}
+
+TEST_CASE("Nested trees profile into their own slots", "[profile]") {
+  NodeT outer_root("Outer"), inner_root("Inner");
+  bt::factory::MakeAction(outer_root, TickInner);
+  bt::factory::MakeAction(inner_root, Costly);
+  outer_root.set_id(0);
+  inner_root.set_id(0);
+
+  ProfCtx ctx;
+  bt::BehaviorTree<ProfCtx> outer(outer_root, ctx);
+  bt::BehaviorTree<ProfCtx> inner(inner_root, ctx);
+  ctx.inner = &inner;
+
+  bt::NodeProfile outer_slots[1], inner_slots[1];
+  bt::TickProfiler outer_prof(outer_slots, 1, FakeClock);
+  bt::TickProfiler inner_prof(inner_slots, 1, FakeClock);
+  outer.set_profiler(&outer_prof);
+  inner.set_profiler(&inner_prof);
+
+  outer.Tick();
+  REQUIRE(inner_slots[0].calls == 1U);
+  REQUIRE(inner_slots[0].inclusive == 1001U);
+  // The inner tree is opaque to the outer profiler: all exclusive
+  REQUIRE(outer_slots[0].calls == 1U);
+  REQUIRE(outer_slots[0].exclusive == outer_slots[0].inclusive);
+  REQUIRE(outer_slots[0].inclusive > 1001U);
+}
+
+TEST_CASE("Default clock is monotonic", "[profile]") {
+  const uint64_t a = bt::TickProfiler::DefaultClock();
+  const uint64_t b = bt::TickProfiler::DefaultClock();
+  REQUIRE(b >= a);
+  const uint64_t c = bt::TickProfiler::MonotonicRawNs();
+  const uint64_t d = bt::TickProfiler::MonotonicRawNs();
+  REQUIRE(d >= c);
+}
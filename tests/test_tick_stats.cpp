@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+#include <bt/behavior_tree.hpp>
+
+#if !defined(BT_STATS)
+#error "test_tick_stats.cpp is built with BT_STATS (bt_tests_trace)"
+#endif
+
+namespace {
+
+struct StatsCtx {
+  int ticks = 0;
+  bt::BehaviorTree<StatsCtx>* inner = nullptr;
+};
+
+using NodeT = bt::Node<StatsCtx>;
+
+bt::Status Ok(StatsCtx& /*ctx*/) { return bt::Status::kSuccess; }
+bt::Status Fail(StatsCtx& /*ctx*/) { return bt::Status::kFailure; }
+
+/* RUNNING on the first tick, SUCCESS on the second. */
+bt::Status Twice(StatsCtx& ctx) {
+  return ((++ctx.ticks % 2) != 0) ? bt::Status::kRunning
+                                  : bt::Status::kSuccess;
+}
+
+bt::Status TickInner(StatsCtx& ctx) { return ctx.inner->Tick(); }
+
+}  // namespace
+
+TEST_CASE("Stats track depth and visits per tick", "[stats]") {
+  // Root(Seq) -> [A, Inv -> Sel -> [F, B]]
+  NodeT root("Root"), a("A"), inv("Inv"), sel("Sel"), f("F"), b("B");
+  bt::factory::MakeAction(a, Ok);
+  bt::factory::MakeAction(f, Fail);
+  bt::factory::MakeAction(b, Twice);
+  sel.set_type(bt::NodeType::kSelector).AddChild(f).AddChild(b);
+  bt::factory::MakeInverter(inv, sel);
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(inv);
+
+  StatsCtx ctx;
+  bt::BehaviorTree<StatsCtx> tree(root, ctx);
+  REQUIRE(tree.stats().ticks == 0U);
+  REQUIRE(tree.stats().AverageDepth() == 0.0);
+
+  REQUIRE(tree.Tick() == bt::Status::kRunning);
+  REQUIRE(tree.stats().last_depth == 4U);
+  REQUIRE(tree.stats().last_nodes == 6U);
+  REQUIRE(tree.stats().last_leaves == 3U);
+
+  // Resumed: Root -> Inv -> Sel -> B (F and A skipped)
+  REQUIRE(tree.Tick() == bt::Status::kFailure);
+  const bt::TickStats& st = tree.stats();
+  REQUIRE(st.ticks == 2U);
+  REQUIRE(st.last_nodes == 4U);
+  REQUIRE(st.last_leaves == 1U);
+  REQUIRE(st.max_depth == 4U);
+  REQUIRE(st.max_nodes_per_tick == 6U);
+  REQUIRE(st.max_leaves_per_tick == 3U);
+  REQUIRE(st.nodes_visited == 10U);
+  REQUIRE(st.AverageNodesPerTick() == Approx(5.0));
+  REQUIRE(st.AverageLeavesPerTick() == Approx(2.0));
+  REQUIRE(st.AverageDepth() == Approx(4.0));
+  REQUIRE(st.count(bt::Status::kRunning) == 1U);
+  REQUIRE(st.count(bt::Status::kFailure) == 1U);
+  REQUIRE(st.count(bt::Status::kSuccess) == 0U);
+
+  // Reset() keeps statistics; ResetStats() clears them
+  tree.Reset();
+  REQUIRE(tree.stats().ticks == 2U);
+  tree.ResetStats();
+  REQUIRE(tree.stats().ticks == 0U);
+  REQUIRE(tree.stats().max_depth == 0U);
+  REQUIRE(tree.tick_count() == 2U);
+}
+
+TEST_CASE("Nested trees keep separate stats", "[stats]") {
+  NodeT outer_root("Outer"), inner_root("Inner"), leaf("Leaf");
+  bt::factory::MakeAction(outer_root, TickInner);
+  bt::factory::MakeAction(leaf, Ok);
+  bt::factory::MakeInverter(inner_root, leaf);
+
+  StatsCtx ctx;
+  bt::BehaviorTree<StatsCtx> outer(outer_root, ctx);
+  bt::BehaviorTree<StatsCtx> inner(inner_root, ctx);
+  ctx.inner = &inner;
+
+  REQUIRE(outer.Tick() == bt::Status::kFailure);
+  REQUIRE(outer.stats().last_nodes == 1U);
+  REQUIRE(outer.stats().last_depth == 1U);
+  REQUIRE(inner.stats().last_nodes == 2U);
+  REQUIRE(inner.stats().last_depth == 2U);
+  REQUIRE(bt::TickCounter::Active() == nullptr);
+
+  // Nodes ticked outside a BehaviorTree are not counted
+  leaf.Tick(ctx);
+  REQUIRE(inner.stats().nodes_visited == 2U);
+}
@@ -0,0 +1,205 @@
+#include <catch2/catch.hpp>
+#include <bt/behavior_tree.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if !defined(BT_TRACE)
+#error "test_tick_trace.cpp is built with BT_TRACE (bt_tests_trace)"
+#endif
+
+namespace {
+
+struct TraceCtx {
+  int ticks = 0;
+  bt::BehaviorTree<TraceCtx>* inner = nullptr;
+};
+
+using NodeT = bt::Node<TraceCtx>;
+
+bt::Status Ok(TraceCtx& /*ctx*/) { return bt::Status::kSuccess; }
+
+/* RUNNING on the first tick, SUCCESS on the second. */
+bt::Status Twice(TraceCtx& ctx) {
+  return ((++ctx.ticks % 2) != 0) ? bt::Status::kRunning
+                                  : bt::Status::kSuccess;
+}
+
+/* Ticks another tree from inside a leaf. */
+bt::Status TickInner(TraceCtx& ctx) { return ctx.inner->Tick(); }
+
+uint64_t g_fake_ns = 0;
+
+/* Advances 10 ns per read. */
+uint64_t FakeClock() {
+  g_fake_ns += 10U;
+  return g_fake_ns;
+}
+
+}  // namespace
+
+TEST_CASE("Tracer records every node tick in post-order", "[trace]") {
+  NodeT root("Root"), a("A"), b("B");
+  bt::factory::MakeAction(a, Ok);
+  bt::factory::MakeAction(b, Twice);
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(b);
+  REQUIRE(bt::AssignNodeIds(root, 5) == 8U);
+  REQUIRE(root.id() == 5U);
+  REQUIRE(b.id() == 7U);
+
+  bt::TraceEvent storage[16];
+  g_fake_ns = 0;
+  bt::TickTracer tracer(storage, 16, FakeClock);
+  TraceCtx ctx;
+  bt::BehaviorTree<TraceCtx> tree(root, ctx);
+  tree.set_tracer(&tracer);
+  REQUIRE(tree.tracer() == &tracer);
+
+  REQUIRE(tree.Tick() == bt::Status::kRunning);
+  REQUIRE(tree.Tick() == bt::Status::kSuccess);
+  REQUIRE(tracer.size() == 5U);  // A B Root, then B Root (resumed)
+
+  bt::TraceEvent out[8];
+  REQUIRE(tracer.Drain(out, 8) == 5U);
+  REQUIRE(tracer.size() == 0U);
+  const uint16_t ids[] = {6, 7, 5, 7, 5};
+  for (int i = 0; i < 5; ++i) {
+    REQUIRE(out[i].node_id == ids[i]);
+  }
+  REQUIRE(out[1].from == bt::Status::kFailure);
+  REQUIRE(out[1].to == bt::Status::kRunning);
+  REQUIRE(out[3].from == bt::Status::kRunning);
+  REQUIRE(out[3].to == bt::Status::kSuccess);
+  REQUIRE(out[4].to == bt::Status::kSuccess);
+
+  // Children lie inside their parent's [start, start + duration]
+  for (int child = 0; child < 2; ++child) {
+    REQUIRE(out[child].start_ns > out[2].start_ns);
+    REQUIRE(out[child].start_ns + out[child].duration_ns <
+            out[2].start_ns + out[2].duration_ns);
+  }
+  REQUIRE(out[0].duration_ns == 10U);
+
+  // Detached: ticks are no longer recorded
+  tree.set_tracer(nullptr);
+  tree.Tick();
+  REQUIRE(tracer.size() == 0U);
+  REQUIRE(bt::TickTracer::Active() == nullptr);
+}
+
+TEST_CASE("A full ring drops new events and counts them", "[trace]") {
+  NodeT leaf("Leaf");
+  bt::factory::MakeAction(leaf, Ok).set_id(3);
+  TraceCtx ctx;
+
+  bt::TraceEvent storage[10];
+  bt::TickTracer tracer(storage, 10);
+  REQUIRE(tracer.capacity() == 8U);
+  {
+    const bt::TickTracer::Scope scope(&tracer);
+    for (int i = 0; i < 11; ++i) {
+      leaf.Tick(ctx);
+    }
+  }
+  leaf.Tick(ctx);  // outside the scope
+  REQUIRE(tracer.size() == 8U);
+  REQUIRE(tracer.dropped() == 3U);
+
+  bt::TraceEvent out[4];
+  REQUIRE(tracer.Drain(out, 4) == 4U);
+  REQUIRE(out[0].node_id == 3U);
+  {
+    const bt::TickTracer::Scope scope(&tracer);
+    leaf.Tick(ctx);
+  }
+  REQUIRE(tracer.size() == 5U);
+  REQUIRE(tracer.dropped() == 3U);
+
+  bt::TickTracer unusable(storage, 0);
+  REQUIRE(unusable.capacity() == 0U);
+  {
+    const bt::TickTracer::Scope scope(&unusable);
+    leaf.Tick(ctx);
+  }
+  REQUIRE(unusable.dropped() == 1U);
+}
+
+TEST_CASE("Each tree traces into its own ring", "[trace]") {
+  NodeT outer_root("Outer"), inner_root("Inner");
+  bt::factory::MakeAction(outer_root, TickInner);
+  bt::factory::MakeAction(inner_root, Ok);
+  outer_root.set_id(1);
+  inner_root.set_id(2);
+
+  TraceCtx ctx;
+  bt::BehaviorTree<TraceCtx> outer(outer_root, ctx);
+  bt::BehaviorTree<TraceCtx> inner(inner_root, ctx);
+  ctx.inner = &inner;
+
+  bt::TraceEvent outer_storage[4], inner_storage[4];
+  bt::TickTracer outer_tracer(outer_storage, 4);
+  bt::TickTracer inner_tracer(inner_storage, 4);
+  outer.set_tracer(&outer_tracer);
+
+  outer.Tick();  // inner tree has no tracer: not recorded anywhere
+  REQUIRE(outer_tracer.size() == 1U);
+
+  inner.set_tracer(&inner_tracer);
+  outer.Tick();
+  REQUIRE(outer_tracer.size() == 2U);
+  REQUIRE(inner_tracer.size() == 1U);
+  bt::TraceEvent e;
+  REQUIRE(inner_tracer.Drain(&e, 1) == 1U);
+  REQUIRE(e.node_id == 2U);
+}
+
+TEST_CASE("A consumer thread drains while the tree ticks", "[trace]") {
+  NodeT root("Root"), leaves[4];
+  for (NodeT& leaf : leaves) {
+    root.AddChild(bt::factory::MakeAction(leaf, Ok));
+  }
+  root.set_type(bt::NodeType::kSequence);
+  bt::AssignNodeIds(root);
+
+  std::vector<bt::TraceEvent> storage(1024);
+  bt::TickTracer tracer(storage.data(), 1024);
+  TraceCtx ctx;
+  bt::BehaviorTree<TraceCtx> tree(root, ctx);
+  tree.set_tracer(&tracer);
+
+  constexpr uint32_t kTicks = 20000;
+  std::atomic<bool> stop(false);
+  uint64_t drained = 0;
+  bool ordered = true;
+  std::thread consumer([&] {
+    bt::TraceEvent out[64];
+    uint16_t expect = 1;  // leaves 1..4, then root 0
+    for (;;) {
+      const bool last = stop.load(std::memory_order_acquire);
+      const uint32_t n = tracer.Drain(out, 64);
+      for (uint32_t i = 0; i < n; ++i) {
+        ordered = ordered && (out[i].node_id == expect);
+        expect = (expect == 4U) ? 0U : (expect == 0U) ? 1U : expect + 1U;
+      }
+      drained += n;
+      if (last && (n == 0U)) {
+        break;
+      }
+      if (n == 0U) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (uint32_t i = 0; i < kTicks; ++i) {
+    tree.Tick();
+  }
+  stop.store(true, std::memory_order_release);
+  consumer.join();
+
+  REQUIRE(drained + tracer.dropped() == uint64_t{kTicks} * 5U);
+  if (tracer.dropped() == 0U) {
+    REQUIRE(ordered);
+  }
+}
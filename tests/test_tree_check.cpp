@@ -0,0 +1,165 @@
+#include <catch2/catch.hpp>
+#include <bt/tree_check.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CheckCtx {};
+
+bt::Status Ok(CheckCtx& /*ctx*/) { return bt::Status::kSuccess; }
+void Noop(CheckCtx& /*ctx*/) {}
+
+using NodeT = bt::Node<CheckCtx>;
+
+std::string PathOf(const bt::CheckResult<CheckCtx>& r) {
+  char buf[128];
+  r.FormatPath(buf, sizeof(buf));
+  return buf;
+}
+
+/** @brief Scratch sized by CheckScratchBytes(). */
+struct Scratch {
+  std::vector<unsigned char> bytes;
+  Scratch(uint32_t nodes, uint32_t depth)
+      : bytes(bt::CheckScratchBytes(nodes, depth)) {}
+};
+
+}  // namespace
+
+TEST_CASE("CheckTree accepts a tree and reports its shape", "[check]") {
+  NodeT root("Root"), a("A"), b("B"), inv("Inv"), c("C"), d("D");
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(b).AddChild(inv);
+  bt::factory::MakeCondition(a, Ok);
+  b.set_type(bt::NodeType::kSelector).AddChild(c);
+  bt::factory::MakeAction(c, Ok);
+  inv.set_type(bt::NodeType::kInverter).AddChild(d);
+  bt::factory::MakeCondition(d, Ok);
+
+  Scratch s(16, 8);
+  const auto r = bt::CheckTree(root, s.bytes.data(), s.bytes.size(), 8);
+  REQUIRE(r.error == bt::CheckError::kNone);
+  REQUIRE(r.node() == nullptr);
+  REQUIRE(r.stats.node_count == 6U);
+  REQUIRE(r.stats.leaf_count == 3U);
+  REQUIRE(r.stats.max_depth == 3U);
+  REQUIRE(r.stats.max_fanout == 3U);
+  REQUIRE(r.stats.shared_count == 0U);
+}
+
+TEST_CASE("CheckTree detects a cycle and reports the path", "[check]") {
+  NodeT root("Root"), mid("Mid"), leaf("Leaf");
+  root.set_type(bt::NodeType::kSequence).AddChild(mid);
+  mid.set_type(bt::NodeType::kSelector).AddChild(leaf).AddChild(root);
+  bt::factory::MakeAction(leaf, Ok);
+
+  Scratch s(16, 8);
+  const auto r = bt::CheckTree(root, s.bytes.data(), s.bytes.size(), 8);
+  REQUIRE(r.error == bt::CheckError::kCycle);
+  REQUIRE(r.node() == &root);
+  REQUIRE(r.path_length == 3U);
+  REQUIRE(PathOf(r) == "Root/Mid/Root");
+  REQUIRE(std::string(bt::CheckErrorToString(r.error)) == "CYCLE");
+}
+
+TEST_CASE("CheckTree allows shared stateless leaves only", "[check]") {
+  NodeT root("Root"), left("Left"), right("Right"), guard("Guard");
+  root.set_type(bt::NodeType::kSequence).AddChild(left).AddChild(right);
+  left.set_type(bt::NodeType::kSequence).AddChild(guard);
+  right.set_type(bt::NodeType::kSequence).AddChild(guard);
+  bt::factory::MakeCondition(guard, Ok);
+  Scratch s(16, 8);
+
+  auto r = bt::CheckTree(root, s.bytes.data(), s.bytes.size(), 8);
+  REQUIRE(r.error == bt::CheckError::kNone);
+  REQUIRE(r.stats.shared_count == 1U);
+  REQUIRE(r.stats.node_count == 4U);
+
+  guard.set_on_exit(Noop);  // lifecycle ties it to one parent
+  r = bt::CheckTree(root, s.bytes.data(), s.bytes.size(), 8);
+  REQUIRE(r.error == bt::CheckError::kSharedStatefulNode);
+  REQUIRE(PathOf(r) == "Root/Right/Guard");
+
+  // Composites carry a resume index, so sharing one is always an error
+  NodeT top("Top"), sub("Sub"), leaf("Leaf");
+  top.set_type(bt::NodeType::kParallel).AddChild(sub).AddChild(sub);
+  sub.set_type(bt::NodeType::kSequence).AddChild(leaf);
+  bt::factory::MakeCondition(leaf, Ok);
+  r = bt::CheckTree(top, s.bytes.data(), s.bytes.size(), 8);
+  REQUIRE(r.error == bt::CheckError::kSharedStatefulNode);
+  REQUIRE(r.node() == &sub);
+}
+
+TEST_CASE("CheckTree reports invalid nodes, depth and scratch limits",
+          "[check]") {
+  NodeT root("Root"), mid("Mid"), leaf("Leaf");
+  root.set_type(bt::NodeType::kSequence).AddChild(mid);
+  mid.set_type(bt::NodeType::kSequence).AddChild(leaf);
+  leaf.set_type(bt::NodeType::kAction);  // no tick
+  Scratch s(16, 8);
+
+  auto r = bt::CheckTree(root, s.bytes.data(), s.bytes.size(), 8);
+  REQUIRE(r.error == bt::CheckError::kInvalidNode);
+  REQUIRE(r.validate_error == bt::ValidateError::kLeafMissingTick);
+  REQUIRE(PathOf(r) == "Root/Mid/Leaf");
+
+  bt::factory::MakeAction(leaf, Ok);
+  r = bt::CheckTree(root, s.bytes.data(), s.bytes.size(), 2);
+  REQUIRE(r.error == bt::CheckError::kTooDeep);
+  REQUIRE(r.node() == &leaf);
+
+  unsigned char tiny[16];
+  r = bt::CheckTree(root, tiny, sizeof(tiny), 8);
+  REQUIRE(r.error == bt::CheckError::kScratchFull);
+
+  char small[5];
+  r = bt::CheckTree(root, s.bytes.data(), s.bytes.size(), 2);
+  REQUIRE(r.FormatPath(small, sizeof(small)) == 4U);
+  REQUIRE(std::string(small) == "Root");
+}
+
+TEST_CASE("CheckTree handles large generated trees in linear time",
+          "[check]") {
+  // Complete 8-ary tree, 6 levels: 37449 nodes
+  constexpr uint32_t kFanout = 8;
+  constexpr uint32_t kLevels = 6;
+  uint32_t total = 0;
+  for (uint32_t level = 0, width = 1; level < kLevels; ++level) {
+    total += width;
+    width *= kFanout;
+  }
+  std::unique_ptr<NodeT[]> nodes(new NodeT[total]);
+  const uint32_t internal = (total - 1U) / kFanout;
+  for (uint32_t i = 0; i < total; ++i) {
+    if (i < internal) {
+      nodes[i].set_type((i % 2U == 0U) ? bt::NodeType::kSequence
+                                       : bt::NodeType::kSelector);
+      for (uint32_t k = 1; k <= kFanout; ++k) {
+        nodes[i].AddChild(nodes[i * kFanout + k]);
+      }
+    } else {
+      bt::factory::MakeCondition(nodes[i], Ok);
+    }
+  }
+
+  Scratch s(total, 64);
+  const auto r = bt::CheckTree(nodes[0], s.bytes.data(), s.bytes.size(), 64);
+  REQUIRE(r.error == bt::CheckError::kNone);
+  REQUIRE(r.stats.node_count == total);
+  REQUIRE(r.stats.max_depth == kLevels);
+  REQUIRE(r.stats.max_fanout == kFanout);
+  REQUIRE(r.stats.leaf_count == total - internal);
+
+  // A back edge from the last leaf's parent to the root is found as well
+  NodeT* children[kFanout];
+  for (uint32_t k = 0; k < kFanout; ++k) {
+    children[k] = &nodes[total - kFanout + k];
+  }
+  children[kFanout - 1U] = &nodes[0];
+  nodes[internal - 1U].SetChildren(children);
+  const auto cyc = bt::CheckTree(nodes[0], s.bytes.data(), s.bytes.size(), 64);
+  REQUIRE(cyc.error == bt::CheckError::kCycle);
+  REQUIRE(cyc.node() == &nodes[0]);
+}
@@ -0,0 +1,246 @@
+#include <catch2/catch.hpp>
+#include <bt/tree_patch.hpp>
+
+#include <string>
+#include <thread>
+
+namespace {
+
+struct PatchCtx {
+  std::string trace;
+  int long_ticks = 0;
+  int slow_ticks = 0;
+};
+
+using NodeT = bt::Node<PatchCtx>;
+
+template <char kLeaf>
+bt::Status Done(PatchCtx& ctx) {
+  ctx.trace += kLeaf;
+  return bt::Status::kSuccess;
+}
+
+bt::Status Fails(PatchCtx& ctx) {
+  ctx.trace += 'f';
+  return bt::Status::kFailure;
+}
+
+/* Runs for five ticks. */
+bt::Status Long(PatchCtx& ctx) {
+  ctx.trace += 'L';
+  return (++ctx.long_ticks < 5) ? bt::Status::kRunning : bt::Status::kSuccess;
+}
+
+/* Never finishes on its own. */
+bt::Status Slow(PatchCtx& ctx) {
+  ctx.trace += 'S';
+  ++ctx.slow_ticks;
+  return bt::Status::kRunning;
+}
+
+void ExitSlow(PatchCtx& ctx) { ctx.trace += '!'; }
+
+}  // namespace
+
+TEST_CASE("Inserting before a running child keeps its progress", "[patch]") {
+  NodeT root("Root"), a("A"), work("Long"), c("C"), x("X");
+  bt::factory::MakeAction(a, Done<'a'>);
+  bt::factory::MakeAction(work, Long);
+  bt::factory::MakeAction(c, Done<'c'>);
+  bt::factory::MakeAction(x, Done<'x'>);
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(work).AddChild(c);
+  PatchCtx ctx;
+
+  REQUIRE(root.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(root.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(root.current_child_index() == 1U);
+
+  bt::TreePatch<PatchCtx> patch;
+  patch.Insert(root, 0, x).Insert(root, 4, x);  // before and after
+  REQUIRE(patch.size() == 2U);
+  REQUIRE(patch.Apply(ctx) == bt::PatchError::kNone);
+  REQUIRE(root.children_count() == 5U);
+  REQUIRE(root.current_child_index() == 2U);
+  REQUIRE(root.status() == bt::Status::kRunning);
+  REQUIRE(work.status() == bt::Status::kRunning);
+
+  ctx.trace.clear();
+  while (root.Tick(ctx) == bt::Status::kRunning) {
+  }
+  // No restart: Long finishes its remaining ticks, then C and the new X
+  REQUIRE(ctx.trace == "LLLcx");
+  REQUIRE(ctx.long_ticks == 5);
+
+  ctx.trace.clear();
+  ctx.long_ticks = 0;
+  root.Tick(ctx);
+  REQUIRE(ctx.trace == "xaL");  // next entry runs the inserted child first
+}
+
+TEST_CASE("Removing or replacing a running child halts it", "[patch]") {
+  NodeT sel("Sel"), fail("Fail"), slow("Slow"), b("B"), c("C");
+  bt::factory::MakeAction(fail, Fails);
+  bt::factory::MakeAction(slow, Slow).set_on_exit(ExitSlow);
+  bt::factory::MakeAction(b, Done<'b'>);
+  bt::factory::MakeAction(c, Done<'c'>);
+  sel.set_type(bt::NodeType::kSelector).AddChild(fail).AddChild(slow).AddChild(
+      b);
+  PatchCtx ctx;
+
+  REQUIRE(sel.Tick(ctx) == bt::Status::kRunning);
+  bt::TreePatch<PatchCtx> patch;
+  REQUIRE(patch.Remove(sel, 1).Apply(ctx) == bt::PatchError::kNone);
+  REQUIRE(ctx.trace == "fS!");  // on_exit ran
+  REQUIRE(slow.status() == bt::Status::kFailure);
+  REQUIRE(sel.current_child_index() == 1U);
+
+  // The selector resumes with the child after the removed one
+  REQUIRE(sel.Tick(ctx) == bt::Status::kSuccess);
+  REQUIRE(ctx.trace == "fS!b");
+
+  // Replace: the running child is halted, the new one starts fresh
+  patch.Clear();
+  REQUIRE(patch.Insert(sel, 1, slow).Apply(ctx) == bt::PatchError::kNone);
+  ctx.trace.clear();
+  REQUIRE(sel.Tick(ctx) == bt::Status::kRunning);
+  patch.Clear();
+  REQUIRE(patch.Replace(sel, 1, c).Apply(ctx) == bt::PatchError::kNone);
+  REQUIRE(sel.Tick(ctx) == bt::Status::kSuccess);
+  REQUIRE(ctx.trace == "fS!c");
+}
+
+TEST_CASE("Parallel bitmaps follow patched children", "[patch]") {
+  NodeT par("Par"), a("A"), slow("Slow"), work("Long"), x("X");
+  bt::factory::MakeAction(a, Done<'a'>);
+  bt::factory::MakeAction(slow, Slow);
+  bt::factory::MakeAction(work, Long);
+  bt::factory::MakeAction(x, Done<'x'>);
+  par.set_type(bt::NodeType::kParallel).AddChild(a).AddChild(slow).AddChild(
+      work);
+  PatchCtx ctx;
+
+  REQUIRE(par.Tick(ctx) == bt::Status::kRunning);  // A done, Slow + Long run
+  REQUIRE(ctx.trace == "aSL");
+
+  bt::TreePatch<PatchCtx> patch;
+  patch.Insert(par, 0, x).Remove(par, 2);  // X | A(done) | Long
+  REQUIRE(patch.Apply(ctx) == bt::PatchError::kNone);
+  REQUIRE(par.child(1) == &a);
+  REQUIRE(par.child(2) == &work);
+
+  ctx.trace.clear();
+  REQUIRE(par.Tick(ctx) == bt::Status::kRunning);
+  REQUIRE(ctx.trace == "xL");  // A stays done, X starts, Long continues
+  while (par.Tick(ctx) == bt::Status::kRunning) {
+  }
+  REQUIRE(par.status() == bt::Status::kSuccess);
+  REQUIRE(ctx.long_ticks == 5);
+  REQUIRE(ctx.slow_ticks == 1);
+}
+
+TEST_CASE("A failing edit leaves the tree untouched", "[patch]") {
+  NodeT root("Root"), a("A"), b("B"), inv("Inv"), leaf("Leaf"), bad("Bad");
+  bt::factory::MakeAction(a, Done<'a'>);
+  bt::factory::MakeAction(b, Done<'b'>);
+  bt::factory::MakeCondition(leaf, Done<'l'>);
+  inv.set_type(bt::NodeType::kInverter).AddChild(leaf);
+  root.set_type(bt::NodeType::kSequence).AddChild(a).AddChild(inv);
+  bad.set_type(bt::NodeType::kAction);  // no tick
+  PatchCtx ctx;
+  uint16_t failed = 99;
+
+  bt::TreePatch<PatchCtx, 4> patch;
+  patch.Insert(root, 2, b).Remove(root, 0).Remove(root, 2);
+  REQUIRE(patch.Check(&failed) == bt::PatchError::kIndexOutOfRange);
+  REQUIRE(failed == 2U);
+  REQUIRE(patch.Apply(ctx) == bt::PatchError::kIndexOutOfRange);
+  REQUIRE(root.children_count() == 2U);
+  REQUIRE(root.child(0) == &a);
+
+  const struct {
+    bt::PatchError expected;
+    void (*record)(bt::TreePatch<PatchCtx, 4>&, NodeT&, NodeT&, NodeT&,
+                   NodeT&);
+  } cases[] = {
+      {bt::PatchError::kNotEditable,
+       [](bt::TreePatch<PatchCtx, 4>& p, NodeT&, NodeT& i, NodeT& l, NodeT&) {
+         p.Insert(l, 0, i);
+       }},
+      {bt::PatchError::kNotEditable,
+       [](bt::TreePatch<PatchCtx, 4>& p, NodeT&, NodeT& i, NodeT&, NodeT&) {
+         p.Remove(i, 0);
+       }},
+      {bt::PatchError::kInvalidBranch,
+       [](bt::TreePatch<PatchCtx, 4>& p, NodeT& r, NodeT&, NodeT&, NodeT& x) {
+         p.Replace(r, 0, x);
+       }},
+      {bt::PatchError::kTooManyOps,
+       [](bt::TreePatch<PatchCtx, 4>& p, NodeT& r, NodeT&, NodeT&, NodeT&) {
+         for (int n = 0; n < 5; ++n) {
+           p.Remove(r, 0);
+         }
+       }},
+  };
+  for (const auto& c : cases) {
+    patch.Clear();
+    c.record(patch, root, inv, leaf, bad);
+    REQUIRE(patch.Apply(ctx) == c.expected);
+    REQUIRE(root.children_count() == 2U);
+  }
+
+  // Inverter children may be replaced one for one
+  patch.Clear();
+  REQUIRE(patch.Replace(inv, 0, b).Apply(ctx) == bt::PatchError::kNone);
+  REQUIRE(inv.child(0) == &b);
+
+  // Capacity: a full parent accepts replace but not insert
+  NodeT full("Full");
+  full.set_type(bt::NodeType::kSequence);
+  for (uint16_t i = 0; i < NodeT::kMaxChildren; ++i) {
+    full.AddChild(a);
+  }
+  patch.Clear();
+  REQUIRE(patch.Insert(full, 0, b).Apply(ctx) ==
+          bt::PatchError::kChildrenExceedMax);
+  patch.Clear();
+  REQUIRE(patch.Remove(full, 0).Insert(full, 0, b).Apply(ctx) ==
+          bt::PatchError::kNone);
+  REQUIRE(std::string(bt::PatchErrorToString(
+              bt::PatchError::kParallelExceedsBitmap)) ==
+          "PARALLEL_EXCEEDS_BITMAP");
+}
+
+TEST_CASE("Committed patches are applied by the tick thread", "[patch]") {
+  NodeT root("Root"), slow("Slow"), a("A");
+  bt::factory::MakeAction(slow, Slow);
+  bt::factory::MakeAction(a, Done<'a'>);
+  root.set_type(bt::NodeType::kSelector).AddChild(slow);
+  PatchCtx ctx;
+  bt::TreePatch<PatchCtx> patch;
+  REQUIRE_FALSE(patch.ApplyCommitted(ctx));
+
+  std::thread planner([&] {
+    patch.Replace(root, 0, a);
+    patch.Commit();
+    while (!patch.done()) {
+      std::this_thread::yield();
+    }
+  });
+  bt::Status status = bt::Status::kRunning;
+  int ticks = 0;
+  while (status == bt::Status::kRunning) {
+    patch.ApplyCommitted(ctx);
+    status = root.Tick(ctx);
+    ++ticks;
+    REQUIRE(ticks < 1000000);
+  }
+  planner.join();
+
+  REQUIRE(status == bt::Status::kSuccess);
+  REQUIRE(patch.done());
+  REQUIRE(patch.result() == bt::PatchError::kNone);
+  REQUIRE(root.child(0) == &a);
+  REQUIRE(ctx.slow_ticks == ticks - 1);
+  patch.Clear();
+  REQUIRE_FALSE(patch.done());
+}
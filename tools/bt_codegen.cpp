@@ -0,0 +1,499 @@
+/**
+ * @file bt_codegen.cpp
+ * @brief Ahead-of-time compiler from XML tree descriptions to C++ headers.
+ *
+ * Usage:
+ *   bt_codegen --context TYPE [--class NAME] [--namespace NS]
+ *              [--include HEADER]... INPUT.xml OUTPUT.hpp
+ *
+ * The input is parsed with bt::LoadXml, so it accepts (and rejects) exactly
+ * what the runtime loader does. Callback names are taken as C++ function
+ * names: tick="Work" becomes a direct call to Work(ctx), stateful or not
+ * (resolved by overload in bt::codegen::InvokeTick). The headers given with
+ * --include must declare them and the context type.
+ *
+ * The emitted class ticks the tree as straight-line code, one member
+ * function per node, with composite nodes resuming RUNNING children through
+ * a switch over explicit labels. See bt/codegen.hpp.
+ */
+
+#include <bt/xml_loader.hpp>
+
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/** @brief The generator never ticks; callbacks only carry their name. */
+struct ToolCtx {};
+
+using ToolRegistry = bt::Registry<ToolCtx, 1024U>;
+using ToolNode = bt::Node<ToolCtx>;
+
+struct NamedTick {
+  uint16_t id;
+  bt::Status operator()(ToolCtx& /*ctx*/) const { return bt::Status::kError; }
+};
+
+struct NamedCallback {
+  uint16_t id;
+  void operator()(ToolCtx& /*ctx*/) const {}
+};
+
+struct Options {
+  std::string context;
+  std::string class_name = "GeneratedTree";
+  std::string name_space;
+  std::vector<std::string> includes;
+  std::string input;
+  std::string output;
+};
+
+int Usage() {
+  std::fprintf(stderr,
+               "usage: bt_codegen --context TYPE [--class NAME] "
+               "[--namespace NS]\n"
+               "                  [--include HEADER]... INPUT.xml "
+               "OUTPUT.hpp\n");
+  return 1;
+}
+
+bool ParseArgs(int argc, char** argv, Options& opt) {
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = (i + 1) < argc;
+    if ((arg == "--context") && has_value) {
+      opt.context = argv[++i];
+    } else if ((arg == "--class") && has_value) {
+      opt.class_name = argv[++i];
+    } else if ((arg == "--namespace") && has_value) {
+      opt.name_space = argv[++i];
+    } else if ((arg == "--include") && has_value) {
+      opt.includes.push_back(argv[++i]);
+    } else if ((arg.size() > 1U) && (arg[0] == '-')) {
+      return false;
+    } else {
+      positional.push_back(arg);
+    }
+  }
+  if ((positional.size() != 2U) || opt.context.empty()) {
+    return false;
+  }
+  opt.input = positional[0];
+  opt.output = positional[1];
+  return true;
+}
+
+/** @brief C++ identifier, optionally namespace-qualified. */
+bool IsCppName(const std::string& name) {
+  static const std::regex kName(
+      "(::)?[A-Za-z_][A-Za-z0-9_]*(::[A-Za-z_][A-Za-z0-9_]*)*");
+  return std::regex_match(name, kName);
+}
+
+/** @brief String literal body: quotes, backslashes and controls escaped. */
+std::string Escape(const char* text) {
+  std::string out;
+  for (const char* p = text; *p != '\0'; ++p) {
+    const unsigned char c = static_cast<unsigned char>(*p);
+    if ((c == '"') || (c == '\\')) {
+      out += '\\';
+      out += static_cast<char>(c);
+    } else if ((c < 0x20U) || (c == 0x7FU) || (c == '?')) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\%03o", c);  // no trigraphs either
+      out += buf;
+    } else {
+      out += static_cast<char>(c);
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Registers every callback name the document references.
+ *
+ * tick values become ticks, on_enter / on_exit values callbacks; a name
+ * used both ways fails to register twice and the loader then reports
+ * WRONG_FUNCTION_KIND for it.
+ */
+class NameTable {
+ public:
+  NameTable() : registry_(new ToolRegistry()) {}
+
+  bool Collect(const std::string& xml) {
+    static const std::regex kAttr(
+        "\\b(tick|on_enter|on_exit)\\s*=\\s*(\"([^\"]*)\"|'([^']*)')");
+    for (std::sregex_iterator it(xml.begin(), xml.end(), kAttr), end;
+         it != end; ++it) {
+      const std::smatch& m = *it;
+      const std::string value = m[3].matched ? m[3].str() : m[4].str();
+      if (registry_->Find(value.data(), value.size()) != nullptr) {
+        continue;
+      }
+      if (!IsCppName(value)) {
+        std::fprintf(stderr, "bt_codegen: '%s' is not a C++ function name\n",
+                     value.c_str());
+        return false;
+      }
+      const uint16_t id = static_cast<uint16_t>(names_.size());
+      names_.push_back(value);
+      const bool ok = (m[1].str() == "tick")
+                          ? registry_->RegisterTick(names_.back().c_str(),
+                                                    NamedTick{id})
+                          : registry_->RegisterCallback(names_.back().c_str(),
+                                                        NamedCallback{id});
+      if (!ok) {
+        std::fprintf(stderr, "bt_codegen: too many function names\n");
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const ToolRegistry& registry() const { return *registry_; }
+
+  const std::string& TickName(const ToolNode& node) const {
+    return names_[node.tick().target<NamedTick>()->id];
+  }
+
+  const std::string& CallbackName(
+      const typename ToolNode::CallbackFn& fn) const {
+    return names_[fn.target<NamedCallback>()->id];
+  }
+
+ private:
+  std::unique_ptr<ToolRegistry> registry_;
+  std::deque<std::string> names_;  // stable c_str() for the registry
+};
+
+// ============================================================================
+// Emitter
+// ============================================================================
+
+class Emitter {
+ public:
+  Emitter(const Options& opt, const NameTable& names,
+          bt::NodeArena<ToolCtx>& arena)
+      : opt_(opt), names_(names), arena_(arena) {
+    for (uint32_t i = 0; i < arena_.node_count(); ++i) {
+      index_[&arena_.node(i)] = i;
+    }
+  }
+
+  std::string Emit() {
+    const std::string guard = Guard();
+    out_ << "// Generated by bt_codegen from " << BaseName(opt_.input)
+         << ". Do not edit.\n\n"
+         << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+         << "#include <bt/codegen.hpp>\n\n";
+    for (const std::string& inc : opt_.includes) {
+      out_ << "#include \"" << inc << "\"\n";
+    }
+    if (!opt_.includes.empty()) {
+      out_ << "\n";
+    }
+    if (!opt_.name_space.empty()) {
+      out_ << "namespace " << opt_.name_space << " {\n\n";
+    }
+    EmitClass();
+    if (!opt_.name_space.empty()) {
+      out_ << "}  // namespace " << opt_.name_space << "\n\n";
+    }
+    out_ << "#endif  // " << guard << "\n";
+    return out_.str();
+  }
+
+ private:
+  static std::string BaseName(const std::string& path) {
+    const size_t slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? path : path.substr(slash + 1U);
+  }
+
+  std::string Guard() const {
+    std::string guard = "BT_GENERATED_";
+    if (!opt_.name_space.empty()) {
+      guard += opt_.name_space + "_";
+    }
+    guard += opt_.class_name + "_HPP_";
+    for (char& c : guard) {
+      c = ((c >= 'a') && (c <= 'z')) ? static_cast<char>(c - 'a' + 'A')
+          : (((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')))
+              ? c
+              : '_';
+    }
+    return guard;
+  }
+
+  static const char* TypeName(bt::NodeType type) {
+    return bt::NodeTypeToString(type);
+  }
+
+  uint32_t IndexOf(const ToolNode* node) const { return index_.at(node); }
+
+  void EmitClass() {
+    const uint32_t count = arena_.node_count();
+    const std::string& ctx = opt_.context;
+    out_ << "/** @brief Compiled behavior tree (" << count << " nodes). */\n"
+         << "class " << opt_.class_name << " final {\n"
+         << " public:\n"
+         << "  using Context = " << ctx << ";\n\n"
+         << "  /** @brief Number of nodes (pre-order indices 0.."
+         << (count - 1U) << "). */\n"
+         << "  static constexpr uint32_t kNodeCount = " << count << "U;\n\n"
+         << "  explicit " << opt_.class_name
+         << "(Context& context) noexcept\n"
+         << "      : context_(context), last_status_(bt::Status::kFailure),"
+            " tick_count_(0) {}\n\n"
+         << "  " << opt_.class_name << "(const " << opt_.class_name
+         << "&) = delete;\n"
+         << "  " << opt_.class_name << "& operator=(const "
+         << opt_.class_name << "&) = delete;\n\n"
+         << "  /** @brief Execute one tick from the root. */\n"
+         << "  bt::Status Tick() noexcept {\n"
+         << "    ++tick_count_;\n"
+         << "    last_status_ = Tick0();\n"
+         << "    return last_status_;\n"
+         << "  }\n\n"
+         << "  /** @brief Reset all nodes to their initial state. */\n"
+         << "  void Reset() noexcept {\n"
+         << "    for (bt::FlatSlot& s : slots_) {\n"
+         << "      s.Reset();\n"
+         << "    }\n"
+         << "    last_status_ = bt::Status::kFailure;\n"
+         << "  }\n\n"
+         << "  /** @brief Status of node index (pre-order). */\n"
+         << "  bt::Status status(uint32_t index) const noexcept {\n"
+         << "    return slots_[index].status;\n"
+         << "  }\n\n"
+         << "  /** @brief Execution state of node index. */\n"
+         << "  bt::FlatSlot& slot(uint32_t index) noexcept "
+            "{ return slots_[index]; }\n\n"
+         << "  /** @brief Name of node index. */\n"
+         << "  static const char* node_name(uint32_t index) noexcept {\n"
+         << "    static const char* const kNames[kNodeCount] = {\n";
+    for (uint32_t i = 0; i < count; ++i) {
+      out_ << "        \"" << Escape(arena_.node(i).name()) << "\""
+           << ((i + 1U < count) ? "," : "") << "\n";
+    }
+    out_ << "    };\n"
+         << "    return kNames[index];\n"
+         << "  }\n\n"
+         << "  /** @brief Number of nodes. */\n"
+         << "  static constexpr uint32_t node_count() noexcept "
+            "{ return kNodeCount; }\n\n"
+         << "  /** @brief Get mutable context reference. */\n"
+         << "  Context& context() noexcept { return context_; }\n\n"
+         << "  /** @brief Get the status from the last Tick() call. */\n"
+         << "  bt::Status last_status() const noexcept "
+            "{ return last_status_; }\n\n"
+         << "  /** @brief Get total number of Tick() calls. */\n"
+         << "  uint32_t tick_count() const noexcept { return tick_count_; }\n\n"
+         << " private:\n";
+    for (uint32_t i = 0; i < count; ++i) {
+      EmitNode(i);
+    }
+    out_ << "  Context& context_;\n"
+         << "  bt::Status last_status_;\n"
+         << "  uint32_t tick_count_;\n"
+         << "  bt::FlatSlot slots_[kNodeCount];\n"
+         << "};\n\n";
+  }
+
+  void EmitEnter(const ToolNode& node, const char* indent) {
+    if (node.has_on_enter()) {
+      out_ << indent << "if (s.status != bt::Status::kRunning) {\n"
+           << indent << "  " << names_.CallbackName(node.on_enter())
+           << "(context_);\n"
+           << indent << "}\n";
+    }
+  }
+
+  void EmitExitAndReturn(const ToolNode& node) {
+    out_ << "    s.status = r;\n";
+    if (node.has_on_exit()) {
+      out_ << "    if (r != bt::Status::kRunning) {\n"
+           << "      " << names_.CallbackName(node.on_exit())
+           << "(context_);\n"
+           << "    }\n";
+    }
+    out_ << "    return r;\n";
+  }
+
+  void EmitNode(uint32_t i) {
+    const ToolNode& node = arena_.node(i);
+    std::string comment = node.name();
+    for (char& c : comment) {
+      c = ((static_cast<unsigned char>(c) < 0x20U) || (c == '\\')) ? ' ' : c;
+    }
+    out_ << "  // [" << i << "] " << TypeName(node.type());
+    if (!comment.empty()) {
+      out_ << " \"" << comment << "\"";
+    }
+    out_ << "\n  bt::Status Tick" << i << "() noexcept {\n"
+         << "    bt::FlatSlot& s = slots_[" << i << "];\n";
+    switch (node.type()) {
+      case bt::NodeType::kAction:
+      case bt::NodeType::kCondition:
+        EmitEnter(node, "    ");
+        out_ << "    const bt::Status r = bt::codegen::InvokeTick(&"
+             << names_.TickName(node) << ", context_, s);\n";
+        break;
+      case bt::NodeType::kSequence:
+      case bt::NodeType::kSelector:
+        EmitOrdered(node);
+        break;
+      case bt::NodeType::kParallel:
+        EmitParallel(node);
+        break;
+      case bt::NodeType::kInverter:
+        EmitEnter(node, "    ");
+        out_ << "    const bt::Status r = bt::codegen::Invert(Tick"
+             << IndexOf(node.child(0)) << "());\n";
+        break;
+      case bt::NodeType::kSubtree:  // never produced by LoadXml()
+        out_ << "    const bt::Status r = bt::Status::kError;\n";
+        break;
+    }
+    EmitExitAndReturn(node);
+    out_ << "  }\n\n";
+  }
+
+  /**
+   * Sequence / Selector: child k runs at label resume_k; a RUNNING child
+   * re-enters at its own label on the next tick.
+   */
+  void EmitOrdered(const ToolNode& node) {
+    const bool sequence = node.type() == bt::NodeType::kSequence;
+    const uint16_t n = node.children_count();
+    out_ << "    if (s.status != bt::Status::kRunning) {\n"
+         << "      s.current_child = 0U;\n";
+    if (node.has_on_enter()) {
+      out_ << "      " << names_.CallbackName(node.on_enter())
+           << "(context_);\n";
+    }
+    // An empty composite returns at once: SUCCESS (sequence), FAILURE
+    // (selector), like Node::Tick()
+    out_ << "    }\n"
+         << "    bt::Status r = bt::Status::"
+         << (sequence ? "kSuccess" : "kFailure") << ";\n";
+    if (n > 1U) {
+      out_ << "    switch (s.current_child) {\n";
+      for (uint16_t k = 1; k < n; ++k) {
+        out_ << "      case " << k << "U: goto resume_" << k << ";\n";
+      }
+      out_ << "      default: break;\n"
+           << "    }\n";
+    }
+    const char* stop = sequence ? "r != bt::Status::kSuccess"
+                                : "r != bt::Status::kFailure";
+    for (uint16_t k = 0; k < n; ++k) {
+      if (k > 0U) {
+        out_ << "  resume_" << k << ":\n";
+      }
+      out_ << "    r = Tick" << IndexOf(node.child(k)) << "();\n"
+           << "    if (" << stop << ") {\n"
+           << "      s.current_child = " << k << "U;\n"
+           << "      goto done;\n"
+           << "    }\n";
+    }
+    if (n > 0U) {
+      out_ << "  done:\n";
+    }
+  }
+
+  void EmitParallel(const ToolNode& node) {
+    out_ << "    if (s.status != bt::Status::kRunning) {\n"
+         << "      s.child_done_bits = 0U;\n"
+         << "      s.child_success_bits = 0U;\n";
+    if (node.has_on_enter()) {
+      out_ << "      " << names_.CallbackName(node.on_enter())
+           << "(context_);\n";
+    }
+    out_ << "    }\n"
+         << "    bt::codegen::ParallelCounts c;\n";
+    for (uint16_t k = 0; k < node.children_count(); ++k) {
+      const std::string mask = "0x" + Hex(static_cast<uint32_t>(1) << k) + "U";
+      out_ << "    if (!c.Finished(s, " << mask << ")) {\n"
+           << "      c.Record(s, " << mask << ", Tick"
+           << IndexOf(node.child(k)) << "());\n"
+           << "    }\n";
+    }
+    out_ << "    const bt::Status r = c.Resolve(bt::ParallelPolicy::"
+         << ((node.parallel_policy() == bt::ParallelPolicy::kRequireOne)
+                 ? "kRequireOne"
+                 : "kRequireAll")
+         << ");\n";
+  }
+
+  static std::string Hex(uint32_t v) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%X", v);
+    return buf;
+  }
+
+  const Options& opt_;
+  const NameTable& names_;
+  bt::NodeArena<ToolCtx>& arena_;
+  std::map<const ToolNode*, uint32_t> index_;
+  std::ostringstream out_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!ParseArgs(argc, argv, opt)) {
+    return Usage();
+  }
+
+  std::ifstream in(opt.input, std::ios::binary);
+  if (!in) {
+    std::fprintf(stderr, "bt_codegen: cannot read %s\n", opt.input.c_str());
+    return 2;
+  }
+  std::stringstream text;
+  text << in.rdbuf();
+  const std::string xml = text.str();
+
+  NameTable names;
+  if (!names.Collect(xml)) {
+    return 2;
+  }
+
+  // Every node is at least "<X/>" long; names are stored once each
+  const size_t nodes = xml.size() / 4U + 1U;
+  std::vector<unsigned char> buffer(nodes * (sizeof(ToolNode) + 8U) +
+                                    xml.size() + 64U);
+  bt::NodeArena<ToolCtx> arena(buffer.data(), buffer.size());
+  const bt::LoadResult<ToolCtx> r =
+      bt::LoadXml(xml.data(), xml.size(), names.registry(), arena);
+  if (r.error != bt::LoadError::kNone) {
+    std::fprintf(stderr, "%s:%u: error: %s", opt.input.c_str(), r.line,
+                 bt::LoadErrorToString(r.error));
+    if (r.error == bt::LoadError::kInvalidNode) {
+      std::fprintf(stderr, " (%s)",
+                   bt::ValidateErrorToString(r.validate_error));
+    }
+    std::fprintf(stderr, "\n");
+    return 2;
+  }
+
+  Emitter emitter(opt, names, arena);
+  const std::string header = emitter.Emit();
+  std::ofstream out(opt.output, std::ios::binary | std::ios::trunc);
+  out << header;
+  if (!out) {
+    std::fprintf(stderr, "bt_codegen: cannot write %s\n", opt.output.c_str());
+    return 2;
+  }
+  return 0;
+}